@@ -0,0 +1,175 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+// Times the batched routines of maths.hpp against scalar loops and, when ASMITH_GL_USE_GLM is defined, against
+// GLM. The results of each routine are checked against the scalar loop. No OpenGL context is needed :
+// g++ -std=c++14 -O2 -Iinclude bench/maths.cpp -o maths
+// g++ -std=c++14 -O2 -DASMITH_GL_USE_GLM -Iinclude -I<glm> bench/maths.cpp -o maths
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "asmith/open_gl/maths.hpp"
+#ifdef ASMITH_GL_USE_GLM
+	#include "glm/glm.hpp"
+#endif
+
+using namespace asmith::gl;
+
+enum : size_t {
+	COUNT = 1 << 16,
+	REPEATS = 50
+};
+
+static std::vector<matrix4> gMatricesA;
+static std::vector<matrix4> gMatricesB;
+static std::vector<matrix4> gMatricesOut;
+static std::vector<vector3> gPoints;
+static std::vector<vector3> gPointsOut;
+static std::vector<vector4> gVectors;
+static std::vector<vector4> gVectorsOut;
+static matrix4 gTransform;
+
+static double measure(void(*aFunction)()) {
+	// Calling through a volatile pointer stops the compiler from merging the repeats
+	void(* volatile function)() = aFunction;
+	function();
+	const auto begin = std::chrono::steady_clock::now();
+	for(size_t i = 0; i < REPEATS; ++i) function();
+	const auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::nano>(end - begin).count() / static_cast<double>(COUNT * REPEATS);
+}
+
+static void multiply_scalar() {
+	for(size_t i = 0; i < COUNT; ++i) {
+		const matrix4& a = gMatricesA[i];
+		const matrix4& b = gMatricesB[i];
+		matrix4& out = gMatricesOut[i];
+		for(int c = 0; c < 4; ++c) {
+			for(int r = 0; r < 4; ++r) {
+				GLfloat sum = 0.f;
+				for(int k = 0; k < 4; ++k) sum += a.columns[k][r] * b.columns[c][k];
+				out.columns[c][r] = sum;
+			}
+		}
+	}
+}
+
+static void multiply_simd() {
+	multiply(gMatricesA.data(), gMatricesB.data(), gMatricesOut.data(), COUNT);
+}
+
+static void transform_points_scalar() {
+	for(size_t i = 0; i < COUNT; ++i) gPointsOut[i] = gTransform.transform_point(gPoints[i]);
+}
+
+static void transform_points_simd() {
+	transform_points(gTransform, gPoints.data(), gPointsOut.data(), COUNT);
+}
+
+static void transform_vectors_scalar() {
+	for(size_t i = 0; i < COUNT; ++i) {
+		const vector4& v = gVectors[i];
+		const GLfloat (&m)[4][4] = gTransform.columns;
+		gVectorsOut[i] = vector4{
+			m[0][0] * v.x + m[1][0] * v.y + m[2][0] * v.z + m[3][0] * v.w,
+			m[0][1] * v.x + m[1][1] * v.y + m[2][1] * v.z + m[3][1] * v.w,
+			m[0][2] * v.x + m[1][2] * v.y + m[2][2] * v.z + m[3][2] * v.w,
+			m[0][3] * v.x + m[1][3] * v.y + m[2][3] * v.z + m[3][3] * v.w
+		};
+	}
+}
+
+static void transform_vectors_simd() {
+	transform_vectors(gTransform, gVectors.data(), gVectorsOut.data(), COUNT);
+}
+
+#ifdef ASMITH_GL_USE_GLM
+static void multiply_glm() {
+	const glm::mat4* const a = reinterpret_cast<const glm::mat4*>(gMatricesA.data());
+	const glm::mat4* const b = reinterpret_cast<const glm::mat4*>(gMatricesB.data());
+	glm::mat4* const out = reinterpret_cast<glm::mat4*>(gMatricesOut.data());
+	for(size_t i = 0; i < COUNT; ++i) out[i] = a[i] * b[i];
+}
+
+static void transform_points_glm() {
+	const glm::mat4& m = reinterpret_cast<const glm::mat4&>(gTransform);
+	const glm::vec3* const in = reinterpret_cast<const glm::vec3*>(gPoints.data());
+	glm::vec3* const out = reinterpret_cast<glm::vec3*>(gPointsOut.data());
+	for(size_t i = 0; i < COUNT; ++i) out[i] = glm::vec3(m * glm::vec4(in[i], 1.f));
+}
+
+static void transform_vectors_glm() {
+	const glm::mat4& m = reinterpret_cast<const glm::mat4&>(gTransform);
+	const glm::vec4* const in = reinterpret_cast<const glm::vec4*>(gVectors.data());
+	glm::vec4* const out = reinterpret_cast<glm::vec4*>(gVectorsOut.data());
+	for(size_t i = 0; i < COUNT; ++i) out[i] = m * in[i];
+}
+#endif
+
+// Runs the scalar loop to get the expected values, then returns the largest difference from them
+template<class T>
+static double compare(void(*aScalar)(), void(*aFunction)(), std::vector<T>& aOut) {
+	aScalar();
+	const std::vector<T> expected = aOut;
+	aFunction();
+	const GLfloat* const a = reinterpret_cast<const GLfloat*>(expected.data());
+	const GLfloat* const b = reinterpret_cast<const GLfloat*>(aOut.data());
+	double error = 0.0;
+	for(size_t i = 0; i < sizeof(T) / sizeof(GLfloat) * COUNT; ++i) error = std::max(error, static_cast<double>(std::fabs(a[i] - b[i])));
+	return error;
+}
+
+template<class T>
+static void run(const char* aName, void(*aScalar)(), void(*aSimd)(), void(*aGlm)(), std::vector<T>& aOut) {
+	const double scalar = measure(aScalar);
+	const double simd = measure(aSimd);
+	const double error = compare(aScalar, aSimd, aOut);
+	std::printf("%-18s scalar %6.2f ns, simd %6.2f ns (%4.1fx, error %g)", aName, scalar, simd, scalar / simd, error);
+	if(aGlm) {
+		const double glm = measure(aGlm);
+		std::printf(", glm %6.2f ns (%4.1fx, error %g)", glm, glm / simd, compare(aScalar, aGlm, aOut));
+	}
+	std::printf("\n");
+}
+
+int main() {
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<GLfloat> distribution(-1.f, 1.f);
+	gMatricesA.resize(COUNT);
+	gMatricesB.resize(COUNT);
+	gMatricesOut.resize(COUNT);
+	for(matrix4& m : gMatricesA) for(auto& c : m.columns) for(GLfloat& f : c) f = distribution(rng);
+	for(matrix4& m : gMatricesB) for(auto& c : m.columns) for(GLfloat& f : c) f = distribution(rng);
+	gPoints.resize(COUNT);
+	gPointsOut.resize(COUNT);
+	for(vector3& p : gPoints) p = vector3{ distribution(rng), distribution(rng), distribution(rng) };
+	gVectors.resize(COUNT);
+	gVectorsOut.resize(COUNT);
+	for(vector4& v : gVectors) v = vector4{ distribution(rng), distribution(rng), distribution(rng), distribution(rng) };
+	gTransform = matrix4::transform(vector3{ 1.f, 2.f, 3.f }, quaternion::from_axis_angle(vector3{ 1.f, 1.f, 0.f }, 0.7f), vector3{ 2.f, 3.f, 4.f });
+
+#ifdef ASMITH_GL_USE_GLM
+	run("multiply", multiply_scalar, multiply_simd, multiply_glm, gMatricesOut);
+	run("transform_points", transform_points_scalar, transform_points_simd, transform_points_glm, gPointsOut);
+	run("transform_vectors", transform_vectors_scalar, transform_vectors_simd, transform_vectors_glm, gVectorsOut);
+#else
+	run("multiply", multiply_scalar, multiply_simd, nullptr, gMatricesOut);
+	run("transform_points", transform_points_scalar, transform_points_simd, nullptr, gPointsOut);
+	run("transform_vectors", transform_vectors_scalar, transform_vectors_simd, nullptr, gVectorsOut);
+#endif
+	return 0;
+}
\ No newline at end of file
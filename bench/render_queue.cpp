@@ -0,0 +1,122 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+// Submits and executes 100k packets in random order, and reports the time per frame and the state changes that
+// sorting avoided. Packets draw single points so that the driver and the queue dominate the time.
+// Replaying needs a context, which is created with a hidden GLUT window :
+// g++ -std=c++14 -O2 -Iinclude bench/render_queue.cpp <library sources> -lglut -lGLEW -lGL -o render_queue
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+#include <GL/glew.h>
+#include <GL/freeglut.h>
+#include "asmith/open_gl/render_queue.hpp"
+#include "asmith/open_gl/shader.hpp"
+#include "asmith/open_gl/texture_2d.hpp"
+
+using namespace asmith::gl;
+
+enum : size_t {
+	PACKETS = 100000,
+	FRAMES = 20,
+	PROGRAMS = 32,
+	TEXTURES = 256,
+	VAOS = 128
+};
+
+static const char* const VERTEX_SOURCE =
+	"#version 130\n"
+	"void main() { gl_Position = vec4(0.0, 0.0, 0.0, 1.0); }\n";
+
+static const char* const FRAGMENT_SOURCE =
+	"#version 130\n"
+	"uniform sampler2D image;\n"
+	"out vec4 colour;\n"
+	"void main() { colour = texture(image, vec2(0.5)); }\n";
+
+int main(int argc, char** argv) {
+	glutInit(&argc, argv);
+	glutInitDisplayMode(GLUT_RGBA | GLUT_DEPTH);
+	glutCreateWindow("render_queue");
+	glutHideWindow();
+	if(glewInit() != GLEW_OK) {
+		std::printf("GLEW could not be initialised\n");
+		return 1;
+	}
+
+	context ctx;
+	std::vector<std::shared_ptr<program>> programs;
+	std::vector<GLint> samplers;
+	for(size_t i = 0; i < PROGRAMS; ++i) {
+		programs.push_back(link_program({ compile_vertex_shader(ctx, VERTEX_SOURCE), compile_fragment_shader(ctx, FRAGMENT_SOURCE) }));
+		samplers.push_back(programs.back()->get_uniform_location("image"));
+	}
+
+	std::vector<std::shared_ptr<texture_2d>> textures;
+	const colour_rgba_8u texel(255, 255, 255, 255);
+	for(size_t i = 0; i < TEXTURES; ++i) {
+		textures.emplace_back(new texture_2d(ctx));
+		textures.back()->bind();
+		textures.back()->load(&texel, 1, 1);
+		textures.back()->unbind();
+	}
+
+	std::vector<std::shared_ptr<vertex_array>> vaos;
+	for(size_t i = 0; i < VAOS; ++i) vaos.emplace_back(new vertex_array(ctx));
+
+	// Random submission order is the worst case for the state changes that the sort removes
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<GLfloat> depth(0.f, 1.f);
+	std::vector<render_queue::packet> packets(PACKETS);
+	for(render_queue::packet& p : packets) {
+		const size_t prog = rng() % PROGRAMS;
+		p = render_queue::packet();
+		p.prog = programs[prog].get();
+		p.vao = vaos[rng() % VAOS].get();
+		p.textures[0] = textures[rng() % TEXTURES].get();
+		p.sampler_locations[0] = samplers[prog];
+		p.texture_count = 1;
+		p.mode = GL_POINTS;
+		p.first = 0;
+		p.count = 1;
+		p.depth = depth(rng);
+		p.pass = 0;
+		p.translucent = rng() % 8 == 0;
+	}
+
+	render_queue queue(ctx);
+	queue.reserve(PACKETS);
+	double submitTime = 0.0;
+	double executeTime = 0.0;
+	for(size_t f = 0; f <= FRAMES; ++f) {
+		const auto begin = std::chrono::steady_clock::now();
+		for(const render_queue::packet& p : packets) queue.submit(p);
+		const auto submitted = std::chrono::steady_clock::now();
+		queue.execute();
+		glFinish();
+		const auto end = std::chrono::steady_clock::now();
+		// The first frame is a warm up
+		if(f == 0) continue;
+		submitTime += std::chrono::duration<double, std::milli>(submitted - begin).count();
+		executeTime += std::chrono::duration<double, std::milli>(end - submitted).count();
+	}
+
+	const render_queue::statistics s = queue.get_frame_statistics();
+	std::printf("%zu packets : submit %.3f ms, sort and replay %.3f ms per frame\n", static_cast<size_t>(PACKETS), submitTime / FRAMES, executeTime / FRAMES);
+	std::printf("per frame : %zu program, %zu texture and %zu vertex array changes, %zu changes avoided\n",
+		s.program_changes, s.texture_changes, s.vao_changes, s.changes_avoided);
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+// Builds a random forest of 1M nodes and times the first update, a full update and an update after 1% of the
+// nodes have changed. Every world matrix is then checked against its parent. No OpenGL context is needed :
+// g++ -std=c++14 -O2 -Iinclude bench/scene_graph.cpp src/asmith/open_gl/scene_graph.cpp src/asmith/open_gl/thread_pool.cpp -lpthread -o scene_graph
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "asmith/open_gl/scene_graph.hpp"
+
+using namespace asmith::gl;
+
+template<class F>
+static double measure(F aFunction) {
+	const auto begin = std::chrono::steady_clock::now();
+	aFunction();
+	const auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+static void multiply_reference(const mat4& a, const mat4& b, mat4& aOut) {
+	for(int c = 0; c < 4; ++c) {
+		for(int r = 0; r < 4; ++r) {
+			GLfloat sum = 0.f;
+			for(int k = 0; k < 4; ++k) sum += a[k][r] * b[c][k];
+			aOut[c][r] = sum;
+		}
+	}
+}
+
+int main(int argc, char** argv) {
+	const size_t count = argc > 1 ? static_cast<size_t>(std::strtoul(argv[1], nullptr, 10)) : 1000000;
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<GLfloat> distribution(-1.f, 1.f);
+
+	// One node in ten is a root, the others have a random earlier node as their parent
+	scene_graph graph;
+	std::vector<scene_graph::node> nodes;
+	nodes.reserve(count);
+	const double build = measure([&]() {
+		for(size_t i = 0; i < count; ++i) {
+			const scene_graph::node parent = i < 10 || rng() % 10 == 0 ? static_cast<scene_graph::node>(scene_graph::INVALID_NODE) : nodes[rng() % nodes.size()];
+			nodes.push_back(graph.create_node(parent));
+			mat4 local;
+			for(int c = 0; c < 4; ++c) for(int r = 0; r < 4; ++r) local[c][r] = (c == r ? 1.f : 0.f) + 0.1f * distribution(rng);
+			graph.set_local(nodes.back(), local);
+		}
+	});
+	const double first = measure([&]() { graph.update(); });
+
+	for(scene_graph::node n : nodes) graph.set_local(n, graph.get_local(n));
+	const double full = measure([&]() { graph.update(); });
+
+	for(size_t i = 0; i < count / 100; ++i) {
+		const scene_graph::node n = nodes[rng() % count];
+		graph.set_local(n, graph.get_local(n));
+	}
+	const double partial = measure([&]() { graph.update(); });
+
+	double error = 0.0;
+	for(scene_graph::node n : nodes) {
+		const scene_graph::node parent = graph.get_parent(n);
+		mat4 expected;
+		if(parent == scene_graph::INVALID_NODE) {
+			std::copy(&graph.get_local(n)[0][0], &graph.get_local(n)[0][0] + 16, &expected[0][0]);
+		}else {
+			multiply_reference(graph.get_world(parent), graph.get_local(n), expected);
+		}
+		const mat4& world = graph.get_world(n);
+		for(int c = 0; c < 4; ++c) {
+			for(int r = 0; r < 4; ++r) error = std::max(error, static_cast<double>(std::fabs(world[c][r] - expected[c][r]) / (1.f + std::fabs(expected[c][r]))));
+		}
+	}
+
+	std::printf("%zu nodes : build %.2f ms, first update %.2f ms (includes the reorder)\n", count, build, first);
+	std::printf("full update %.2f ms (%.2f ns per node), 1%% update %.2f ms\n", full, full * 1e6 / static_cast<double>(count), partial);
+	std::printf("largest relative error %g\n", error);
+	return error < 1e-4 ? 0 : 1;
+}
\ No newline at end of file
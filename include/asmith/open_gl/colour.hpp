@@ -14,19 +14,13 @@
 #ifndef ASMITH_OPENGL_COLOUR_HPP
 #define ASMITH_OPENGL_COLOUR_HPP
 
+#include <cmath>
+#include <cstring>
+#include <type_traits>
 #include "core.hpp"
 
 namespace asmith { namespace gl {
 
-	template<class A, class B>
-	static inline A colour_cast(const B& aColour) throw() {
-		vec4f tmp;
-		aColour.get_rgba(tmp);
-		A result;
-		result.set_rgba(tmp);
-		return result;
-	}
-
 	static constexpr int64_t colour_min(const GLenum aType) throw() {
 		return
 			aType == GL_UNSIGNED_BYTE ? 0 :
@@ -52,6 +46,145 @@ namespace asmith { namespace gl {
 			aType == GL_DOUBLE ? 1 :
 			0;
 	}
+
+	namespace implementation {
+		static inline uint32_t float_bits(const GLfloat aValue) throw() {
+			uint32_t bits;
+			memcpy(&bits, &aValue, sizeof(GLfloat));
+			return bits;
+		}
+
+		static inline GLfloat bits_float(const uint32_t aBits) throw() {
+			GLfloat value;
+			memcpy(&value, &aBits, sizeof(GLfloat));
+			return value;
+		}
+
+		static inline uint32_t round_shift(const uint32_t aValue, const int aShift) throw() {
+			// Shift right, rounding to nearest with ties to even
+			const uint32_t q = aValue >> aShift;
+			const uint32_t remainder = aValue & ((1u << aShift) - 1u);
+			const uint32_t half = 1u << (aShift - 1);
+			return remainder > half || (remainder == half && (q & 1u)) ? q + 1u : q;
+		}
+
+		/*!
+			\brief Convert a float to a smaller float with a 5 bit exponent, such as a half or an 11 or 10 bit float
+			\details Rounds to nearest even. When aSigned is false negative values become 0 and values too large for
+			the format become the largest finite value, following the rules for GL_R11F_G11F_B10F. Signed
+			values that are too large become infinity, the same as F16C and NEON conversions.
+		*/
+		static inline uint32_t float_to_small_float(const GLfloat aValue, const int aMantissaBits, const bool aSigned) throw() {
+			const uint32_t bits = float_bits(aValue);
+			const uint32_t absolute = bits & 0x7FFFFFFFu;
+			const uint32_t sign = aSigned ? (bits >> 31) << (aMantissaBits + 5) : 0u;
+			const uint32_t infinity = 0x1Fu << aMantissaBits;
+			const int shift = 23 - aMantissaBits;
+
+			if(absolute > 0x7F800000u) return sign | infinity | (1u << (aMantissaBits - 1)) | ((absolute & 0x7FFFFFu) >> shift);
+			if(! aSigned && (bits >> 31)) return 0u;
+			if(absolute == 0x7F800000u) return sign | infinity;
+
+			const int exponent = static_cast<int>(absolute >> 23) - 127 + 15;
+			uint32_t result;
+			if(exponent <= 0) {
+				if(absolute < 0x00800000u) return sign;
+				const int denormalShift = shift + 1 - exponent;
+				result = denormalShift > 24 ? 0u : round_shift((absolute & 0x7FFFFFu) | 0x800000u, denormalShift);
+			}else {
+				// Rebias the exponent, a carry out of the mantissa while rounding correctly increments it
+				result = round_shift(absolute - (static_cast<uint32_t>(127 - 15) << 23), shift);
+			}
+			if(result >= infinity) result = aSigned ? infinity : infinity - 1u;
+			return sign | result;
+		}
+
+		static inline GLfloat small_float_to_float(const uint32_t aValue, const int aMantissaBits, const bool aSigned) throw() {
+			const uint32_t sign = aSigned ? ((aValue >> (aMantissaBits + 5)) & 1u) << 31 : 0u;
+			const uint32_t exponent = (aValue >> aMantissaBits) & 0x1Fu;
+			const uint32_t mantissa = aValue & ((1u << aMantissaBits) - 1u);
+			const int shift = 23 - aMantissaBits;
+
+			// NaNs are returned quiet, as F16C does
+			if(exponent == 0x1Fu) return bits_float(sign | 0x7F800000u | (mantissa << shift) | (mantissa ? 0x400000u : 0u));
+			if(exponent != 0) return bits_float(sign | ((exponent + 127u - 15u) << 23) | (mantissa << shift));
+			// Denormal, which is exactly representable as a float
+			const GLfloat value = static_cast<GLfloat>(mantissa) * bits_float(static_cast<uint32_t>(127 - 14 - aMantissaBits) << 23);
+			return sign ? -value : value;
+		}
+
+		static inline GLhalf float_to_half(const GLfloat aValue) throw() {
+			return static_cast<GLhalf>(float_to_small_float(aValue, 10, true));
+		}
+
+		static inline GLfloat half_to_float(const GLhalf aValue) throw() {
+			return small_float_to_float(aValue, 10, true);
+		}
+
+		/*!
+			\brief Describes where each channel is stored in a packed normalised type
+			\details For the non _REV types the first component is in the most significant bits.
+		*/
+		template<const GLenum F, const GLenum T>
+		struct packed_layout {
+			enum { VALID = 0 };
+		};
+
+		template<>
+		struct packed_layout<GL_RGB, GL_UNSIGNED_SHORT_5_6_5> {
+			typedef GLushort type;
+			enum : GLenum { INTERNAL_FORMAT = GL_RGB565 };
+			enum {
+				VALID = 1,
+				RED_BITS = 5, GREEN_BITS = 6, BLUE_BITS = 5, ALPHA_BITS = 0,
+				RED_SHIFT = 11, GREEN_SHIFT = 5, BLUE_SHIFT = 0, ALPHA_SHIFT = 0
+			};
+		};
+
+		template<>
+		struct packed_layout<GL_RGBA, GL_UNSIGNED_SHORT_4_4_4_4> {
+			typedef GLushort type;
+			enum : GLenum { INTERNAL_FORMAT = GL_RGBA4 };
+			enum {
+				VALID = 1,
+				RED_BITS = 4, GREEN_BITS = 4, BLUE_BITS = 4, ALPHA_BITS = 4,
+				RED_SHIFT = 12, GREEN_SHIFT = 8, BLUE_SHIFT = 4, ALPHA_SHIFT = 0
+			};
+		};
+
+		template<>
+		struct packed_layout<GL_RGBA, GL_UNSIGNED_SHORT_5_5_5_1> {
+			typedef GLushort type;
+			enum : GLenum { INTERNAL_FORMAT = GL_RGB5_A1 };
+			enum {
+				VALID = 1,
+				RED_BITS = 5, GREEN_BITS = 5, BLUE_BITS = 5, ALPHA_BITS = 1,
+				RED_SHIFT = 11, GREEN_SHIFT = 6, BLUE_SHIFT = 1, ALPHA_SHIFT = 0
+			};
+		};
+
+		template<>
+		struct packed_layout<GL_RGBA, GL_UNSIGNED_INT_10_10_10_2> {
+			typedef GLuint type;
+			enum : GLenum { INTERNAL_FORMAT = GL_RGB10_A2 };
+			enum {
+				VALID = 1,
+				RED_BITS = 10, GREEN_BITS = 10, BLUE_BITS = 10, ALPHA_BITS = 2,
+				RED_SHIFT = 22, GREEN_SHIFT = 12, BLUE_SHIFT = 2, ALPHA_SHIFT = 0
+			};
+		};
+
+		template<>
+		struct packed_layout<GL_RGBA, GL_UNSIGNED_INT_2_10_10_10_REV> {
+			typedef GLuint type;
+			enum : GLenum { INTERNAL_FORMAT = GL_RGB10_A2 };
+			enum {
+				VALID = 1,
+				RED_BITS = 10, GREEN_BITS = 10, BLUE_BITS = 10, ALPHA_BITS = 2,
+				RED_SHIFT = 0, GREEN_SHIFT = 10, BLUE_SHIFT = 20, ALPHA_SHIFT = 30
+			};
+		};
+	}
 	
 	template<const GLenum F, const GLenum T, class ENABLE = void>
 	struct colour {
@@ -441,6 +574,374 @@ namespace asmith { namespace gl {
 		}
 	};
 
+	template<const GLenum F, const GLenum T>
+	struct colour<F, T, typename std::enable_if<implementation::packed_layout<F, T>::VALID>::type> {
+		typedef implementation::packed_layout<F, T> layout;
+		typedef typename layout::type type;
+		enum : GLenum {
+			FORMAT = F,
+			TYPE = T,
+			INTERNAL_FORMAT = layout::INTERNAL_FORMAT
+		};
+
+		enum : int64_t {
+			MIN_RED		= 0,
+			MIN_GREEN	= 0,
+			MIN_BLUE	= 0,
+			MIN_ALPHA	= 0,
+
+			MAX_RED		= (1 << layout::RED_BITS) - 1,
+			MAX_GREEN	= (1 << layout::GREEN_BITS) - 1,
+			MAX_BLUE	= (1 << layout::BLUE_BITS) - 1,
+			MAX_ALPHA	= (1 << layout::ALPHA_BITS) - 1
+		};
+
+		enum {
+			// The channels share one value so they cannot be addressed individually
+			RED_CHANNEL = -1,
+			GREEN_CHANNEL = -1,
+			BLUE_CHANNEL = -1,
+			ALPHA_CHANNEL = -1,
+
+			RED_BITS = layout::RED_BITS,
+			GREEN_BITS = layout::GREEN_BITS,
+			BLUEED_BITS = layout::BLUE_BITS,
+			ALPHA_BITS = layout::ALPHA_BITS,
+
+			RED_SHIFT = layout::RED_SHIFT,
+			GREEN_SHIFT = layout::GREEN_SHIFT,
+			BLUE_SHIFT = layout::BLUE_SHIFT,
+			ALPHA_SHIFT = layout::ALPHA_SHIFT
+		};
+
+		type value;
+
+		static inline GLfloat unpack(const type aValue, const int aShift, const int64_t aMax, const GLfloat aDefault) throw() {
+			return aMax == 0 ? aDefault : static_cast<GLfloat>((aValue >> aShift) & aMax) / static_cast<GLfloat>(aMax);
+		}
+
+		static inline type pack(GLfloat aValue, const int aShift, const int64_t aMax) throw() {
+			// Clamp so that an out of range value cannot overflow into the neighbouring channel
+			aValue = aValue > 0.f ? aValue : 0.f;
+			aValue = aValue < 1.f ? aValue : 1.f;
+			return static_cast<type>(static_cast<type>(aValue * static_cast<GLfloat>(aMax)) << aShift);
+		}
+
+		void get_rgba(vec4f& aValue) const throw() {
+			aValue[0] = unpack(value, RED_SHIFT, MAX_RED, 0.f);
+			aValue[1] = unpack(value, GREEN_SHIFT, MAX_GREEN, 0.f);
+			aValue[2] = unpack(value, BLUE_SHIFT, MAX_BLUE, 0.f);
+			aValue[3] = unpack(value, ALPHA_SHIFT, MAX_ALPHA, 1.f);
+		}
+
+		void set_rgba(const vec4f& aValue) throw() {
+			value = static_cast<type>(
+				pack(aValue[0], RED_SHIFT, MAX_RED) |
+				pack(aValue[1], GREEN_SHIFT, MAX_GREEN) |
+				pack(aValue[2], BLUE_SHIFT, MAX_BLUE) |
+				(MAX_ALPHA == 0 ? 0 : pack(aValue[3], ALPHA_SHIFT, MAX_ALPHA))
+			);
+		}
+
+		constexpr colour() :
+			value(0)
+		{}
+
+		constexpr explicit colour(type aValue) :
+			value(aValue)
+		{}
+	};
+
+	template<>
+	struct colour<GL_RGB, GL_UNSIGNED_INT_10F_11F_11F_REV, void> {
+		typedef GLuint type;
+		enum : GLenum {
+			FORMAT = GL_RGB,
+			TYPE = GL_UNSIGNED_INT_10F_11F_11F_REV,
+			INTERNAL_FORMAT = GL_R11F_G11F_B10F
+		};
+
+		enum : int64_t {
+			MIN_RED		= 0,
+			MIN_GREEN	= 0,
+			MIN_BLUE	= 0,
+			MIN_ALPHA	= 0,
+
+			MAX_RED		= 1,
+			MAX_GREEN	= 1,
+			MAX_BLUE	= 1,
+			MAX_ALPHA	= 0
+		};
+
+		enum {
+			RED_CHANNEL = -1,
+			GREEN_CHANNEL = -1,
+			BLUE_CHANNEL = -1,
+			ALPHA_CHANNEL = -1,
+
+			RED_BITS = 11,
+			GREEN_BITS = 11,
+			BLUEED_BITS = 10,
+			ALPHA_BITS = 0
+		};
+
+		type value;
+
+		void get_rgba(vec4f& aValue) const throw() {
+			aValue[0] = implementation::small_float_to_float(value & 0x7FFu, 6, false);
+			aValue[1] = implementation::small_float_to_float((value >> 11) & 0x7FFu, 6, false);
+			aValue[2] = implementation::small_float_to_float(value >> 22, 5, false);
+			aValue[3] = 1.f;
+		}
+
+		void set_rgba(const vec4f& aValue) throw() {
+			value =
+				implementation::float_to_small_float(aValue[0], 6, false) |
+				(implementation::float_to_small_float(aValue[1], 6, false) << 11) |
+				(implementation::float_to_small_float(aValue[2], 5, false) << 22);
+		}
+
+		constexpr colour() :
+			value(0)
+		{}
+
+		constexpr explicit colour(type aValue) :
+			value(aValue)
+		{}
+	};
+
+	template<>
+	struct colour<GL_RED, GL_HALF_FLOAT, void> {
+		typedef GLhalf type;
+		enum : GLenum {
+			FORMAT = GL_RED,
+			TYPE = GL_HALF_FLOAT,
+			INTERNAL_FORMAT = GL_R16F
+		};
+
+		enum : int64_t {
+			MIN_RED		= 0,
+			MIN_GREEN	= 0,
+			MIN_BLUE	= 0,
+			MIN_ALPHA	= 0,
+
+			MAX_RED		= 1,
+			MAX_GREEN	= 0,
+			MAX_BLUE	= 0,
+			MAX_ALPHA	= 0
+		};
+
+		enum {
+			RED_CHANNEL = 0,
+			GREEN_CHANNEL = -1,
+			BLUE_CHANNEL = -1,
+			ALPHA_CHANNEL = -1,
+
+			RED_BITS = 16,
+			GREEN_BITS = 0,
+			BLUEED_BITS = 0,
+			ALPHA_BITS = 0
+		};
+
+		type r;
+
+		void get_rgba(vec4f& aValue) const throw() {
+			aValue[0] = implementation::half_to_float(r);
+			aValue[1] = 0.f;
+			aValue[2] = 0.f;
+			aValue[3] = 1.f;
+		}
+
+		void set_rgba(const vec4f& aValue) throw() {
+			r = implementation::float_to_half(aValue[0]);
+		}
+
+		constexpr colour() :
+			r(0)
+		{}
+
+		constexpr colour(type aR) :
+			r(aR)
+		{}
+	};
+
+	template<>
+	struct colour<GL_RG, GL_HALF_FLOAT, void> {
+		typedef GLhalf type;
+		enum : GLenum {
+			FORMAT = GL_RG,
+			TYPE = GL_HALF_FLOAT,
+			INTERNAL_FORMAT = GL_RG16F
+		};
+
+		enum : int64_t {
+			MIN_RED		= 0,
+			MIN_GREEN	= 0,
+			MIN_BLUE	= 0,
+			MIN_ALPHA	= 0,
+
+			MAX_RED		= 1,
+			MAX_GREEN	= 1,
+			MAX_BLUE	= 0,
+			MAX_ALPHA	= 0
+		};
+
+		enum {
+			RED_CHANNEL = 0,
+			GREEN_CHANNEL = 1,
+			BLUE_CHANNEL = -1,
+			ALPHA_CHANNEL = -1,
+
+			RED_BITS = 16,
+			GREEN_BITS = 16,
+			BLUEED_BITS = 0,
+			ALPHA_BITS = 0
+		};
+
+		type r;
+		type g;
+
+		void get_rgba(vec4f& aValue) const throw() {
+			aValue[0] = implementation::half_to_float(r);
+			aValue[1] = implementation::half_to_float(g);
+			aValue[2] = 0.f;
+			aValue[3] = 1.f;
+		}
+
+		void set_rgba(const vec4f& aValue) throw() {
+			r = implementation::float_to_half(aValue[0]);
+			g = implementation::float_to_half(aValue[1]);
+		}
+
+		constexpr colour() :
+			r(0), g(0)
+		{}
+
+		constexpr colour(type aR, type aG) :
+			r(aR), g(aG)
+		{}
+	};
+
+	template<>
+	struct colour<GL_RGB, GL_HALF_FLOAT, void> {
+		typedef GLhalf type;
+		enum : GLenum {
+			FORMAT = GL_RGB,
+			TYPE = GL_HALF_FLOAT,
+			INTERNAL_FORMAT = GL_RGB16F
+		};
+
+		enum : int64_t {
+			MIN_RED		= 0,
+			MIN_GREEN	= 0,
+			MIN_BLUE	= 0,
+			MIN_ALPHA	= 0,
+
+			MAX_RED		= 1,
+			MAX_GREEN	= 1,
+			MAX_BLUE	= 1,
+			MAX_ALPHA	= 0
+		};
+
+		enum {
+			RED_CHANNEL = 0,
+			GREEN_CHANNEL = 1,
+			BLUE_CHANNEL = 2,
+			ALPHA_CHANNEL = -1,
+
+			RED_BITS = 16,
+			GREEN_BITS = 16,
+			BLUEED_BITS = 16,
+			ALPHA_BITS = 0
+		};
+
+		type r;
+		type g;
+		type b;
+
+		void get_rgba(vec4f& aValue) const throw() {
+			aValue[0] = implementation::half_to_float(r);
+			aValue[1] = implementation::half_to_float(g);
+			aValue[2] = implementation::half_to_float(b);
+			aValue[3] = 1.f;
+		}
+
+		void set_rgba(const vec4f& aValue) throw() {
+			r = implementation::float_to_half(aValue[0]);
+			g = implementation::float_to_half(aValue[1]);
+			b = implementation::float_to_half(aValue[2]);
+		}
+
+		constexpr colour() :
+			r(0), g(0), b(0)
+		{}
+
+		constexpr colour(type aR, type aG, type aB) :
+			r(aR), g(aG), b(aB)
+		{}
+	};
+
+	template<>
+	struct colour<GL_RGBA, GL_HALF_FLOAT, void> {
+		typedef GLhalf type;
+		enum : GLenum {
+			FORMAT = GL_RGBA,
+			TYPE = GL_HALF_FLOAT,
+			INTERNAL_FORMAT = GL_RGBA16F
+		};
+
+		enum : int64_t {
+			MIN_RED		= 0,
+			MIN_GREEN	= 0,
+			MIN_BLUE	= 0,
+			MIN_ALPHA	= 0,
+
+			MAX_RED		= 1,
+			MAX_GREEN	= 1,
+			MAX_BLUE	= 1,
+			MAX_ALPHA	= 1
+		};
+
+		enum {
+			RED_CHANNEL = 0,
+			GREEN_CHANNEL = 1,
+			BLUE_CHANNEL = 2,
+			ALPHA_CHANNEL = 3,
+
+			RED_BITS = 16,
+			GREEN_BITS = 16,
+			BLUEED_BITS = 16,
+			ALPHA_BITS = 16
+		};
+
+		type r;
+		type g;
+		type b;
+		type a;
+
+		void get_rgba(vec4f& aValue) const throw() {
+			aValue[0] = implementation::half_to_float(r);
+			aValue[1] = implementation::half_to_float(g);
+			aValue[2] = implementation::half_to_float(b);
+			aValue[3] = implementation::half_to_float(a);
+		}
+
+		void set_rgba(const vec4f& aValue) throw() {
+			r = implementation::float_to_half(aValue[0]);
+			g = implementation::float_to_half(aValue[1]);
+			b = implementation::float_to_half(aValue[2]);
+			a = implementation::float_to_half(aValue[3]);
+		}
+
+		constexpr colour() :
+			r(0), g(0), b(0), a(0)
+		{}
+
+		constexpr colour(type aR, type aG, type aB, type aA) :
+			r(aR), g(aG), b(aB), a(aA)
+		{}
+	};
+
 	template<const GLenum T> using colour_r = colour<GL_RED, T>;
 	template<const GLenum T> using colour_rg = colour<GL_RG, T>;
 	template<const GLenum T> using colour_rgb = colour<GL_RGB, T>;
@@ -448,6 +949,220 @@ namespace asmith { namespace gl {
 	template<const GLenum T> using colour_bgr = colour<GL_BGR, T>;
 	template<const GLenum T> using colour_bgra = colour<GL_BGRA, T>;
 
+	namespace implementation {
+		template<class C>
+		static inline typename C::type get_colour_channel(const C& aColour, const int aChannel, const typename C::type aDefault) throw() {
+			// Every channel of a colour has the same type, so the struct can be addressed as an array
+			return aChannel == -1 ? aDefault : reinterpret_cast<const typename C::type*>(&aColour)[aChannel];
+		}
+
+		template<class C>
+		static inline void set_colour_channel(C& aColour, const int aChannel, const typename C::type aValue) throw() {
+			if(aChannel != -1) reinterpret_cast<typename C::type*>(&aColour)[aChannel] = aValue;
+		}
+
+		static inline const GLfloat* srgb_decode_table() throw() {
+			struct table {
+				GLfloat values[256];
+
+				table() {
+					for(int i = 0; i < 256; ++i) {
+						const GLfloat c = static_cast<GLfloat>(i) / 255.f;
+						values[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+					}
+				}
+			};
+			static const table TABLE;
+			return TABLE.values;
+		}
+
+		static inline GLfloat srgb_decode(const GLubyte aValue) throw() {
+			return srgb_decode_table()[aValue];
+		}
+
+		static inline GLubyte srgb_encode(GLfloat aValue) throw() {
+			// pow(x, 1 / 2.4) is approximated from three square roots, the result is within one step of the exact
+			// encoding and every decoded value encodes back to itself. The SIMD kernels in colour_conversion.hpp
+			// evaluate the same expression in the same order. When FMA is available the multiplies and adds are
+			// fused explicitly, so that the compiler cannot fuse this copy differently from the kernels.
+			aValue = aValue > 0.f ? aValue : 0.f;
+			aValue = aValue < 1.f ? aValue : 1.f;
+			GLfloat s;
+			if(aValue <= 0.0031308f) {
+				s = aValue * 12.92f;
+			}else {
+				const GLfloat s1 = std::sqrt(aValue);
+				const GLfloat s2 = std::sqrt(s1);
+				const GLfloat s3 = std::sqrt(s2);
+#if defined(ASMITH_GL_FMA)
+				s = std::fma(-0.0225411470f, aValue, std::fma(-0.323583601f, s3, std::fma(0.684122060f, s2, 0.662002687f * s1)));
+#else
+				s = 0.662002687f * s1 + 0.684122060f * s2 - 0.323583601f * s3 - 0.0225411470f * aValue;
+#endif
+			}
+#if defined(ASMITH_GL_FMA)
+			return static_cast<GLubyte>(std::fma(s, 255.f, 0.5f));
+#else
+			return static_cast<GLubyte>(s * 255.f + 0.5f);
+#endif
+		}
+	}
+
+	/*!
+		\brief An 8 bit colour with sRGB encoded colour channels and a linear alpha channel
+		\details get_rgba and set_rgba work in linear space, so colour_cast between sRGB and linear types
+		decodes or encodes the colour channels.
+		\author Adam Smith
+		\date Created : 18th October 2026 Modified 18th October 2026
+		\version 1.0
+	*/
+	template<const GLenum F>
+	struct colour_srgb : public colour<F, GL_UNSIGNED_BYTE> {
+		typedef colour<F, GL_UNSIGNED_BYTE> linear;
+		typedef typename linear::type type;
+
+		enum : GLenum {
+			FORMAT = F,
+			TYPE = GL_UNSIGNED_BYTE,
+			INTERNAL_FORMAT = linear::ALPHA_CHANNEL == -1 ? GL_SRGB8 : GL_SRGB8_ALPHA8
+		};
+
+		using linear::linear;
+
+		constexpr colour_srgb() :
+			linear()
+		{}
+
+		void get_rgba(vec4f& aValue) const throw() {
+			aValue[0] = implementation::srgb_decode(this->r);
+			aValue[1] = implementation::srgb_decode(this->g);
+			aValue[2] = implementation::srgb_decode(this->b);
+			aValue[3] = static_cast<GLfloat>(implementation::get_colour_channel<linear>(*this, linear::ALPHA_CHANNEL, UINT8_MAX)) / 255.f;
+		}
+
+		void set_rgba(const vec4f& aValue) throw() {
+			this->r = implementation::srgb_encode(aValue[0]);
+			this->g = implementation::srgb_encode(aValue[1]);
+			this->b = implementation::srgb_encode(aValue[2]);
+			implementation::set_colour_channel<linear>(*this, linear::ALPHA_CHANNEL, static_cast<type>(aValue[3] * 255.f));
+		}
+	};
+
+	template<class C>
+	struct is_srgb_colour : public std::false_type {};
+
+	template<const GLenum F>
+	struct is_srgb_colour<colour_srgb<F>> : public std::true_type {};
+
+	namespace implementation {
+		enum : int {
+			COLOUR_CAST_COPY,
+			COLOUR_CAST_FLOAT,
+			COLOUR_CAST_SWIZZLE,
+			COLOUR_CAST_INTEGER
+		};
+
+		static constexpr bool is_integer_colour_type(const GLenum aType) throw() {
+			return
+				aType == GL_UNSIGNED_BYTE ||
+				aType == GL_BYTE ||
+				aType == GL_UNSIGNED_SHORT ||
+				aType == GL_SHORT ||
+				aType == GL_UNSIGNED_INT ||
+				aType == GL_INT;
+		}
+
+		/*!
+			\brief Choose how colour_cast converts between two colour types
+			\details A type converted to itself is copied. Types with the same channel type and colour space only
+			reorder their channels. Integer types of the same signedness are scaled with integer arithmetic.
+			Everything else, including conversions between sRGB and linear types and packed or half float types,
+			goes through normalised floats.
+		*/
+		template<class A, class B>
+		static constexpr int select_colour_cast() throw() {
+			return
+				std::is_same<A, B>::value ? COLOUR_CAST_COPY :
+				! (is_primative_type(A::TYPE) && is_primative_type(B::TYPE)) ? COLOUR_CAST_FLOAT :
+				is_srgb_colour<A>::value != is_srgb_colour<B>::value ? COLOUR_CAST_FLOAT :
+				static_cast<GLenum>(A::TYPE) == static_cast<GLenum>(B::TYPE) ? COLOUR_CAST_SWIZZLE :
+				is_integer_colour_type(A::TYPE) && is_integer_colour_type(B::TYPE) && (colour_min(A::TYPE) < 0) == (colour_min(B::TYPE) < 0) ? COLOUR_CAST_INTEGER :
+				COLOUR_CAST_FLOAT;
+		}
+
+		template<class A, class B, const int PATH = select_colour_cast<A, B>()>
+		struct colour_caster {
+			static inline A cast(const B& aColour) throw() {
+				vec4f tmp;
+				aColour.get_rgba(tmp);
+				A result;
+				result.set_rgba(tmp);
+				return result;
+			}
+		};
+
+		template<class A, class B>
+		struct colour_caster<A, B, COLOUR_CAST_COPY> {
+			static inline A cast(const B& aColour) throw() {
+				return aColour;
+			}
+		};
+
+		template<class A, class B>
+		struct colour_caster<A, B, COLOUR_CAST_SWIZZLE> {
+			typedef typename A::type type;
+
+			static inline A cast(const B& aColour) throw() {
+				A result;
+				set_colour_channel<A>(result, A::RED_CHANNEL, get_colour_channel<B>(aColour, B::RED_CHANNEL, 0));
+				set_colour_channel<A>(result, A::GREEN_CHANNEL, get_colour_channel<B>(aColour, B::GREEN_CHANNEL, 0));
+				set_colour_channel<A>(result, A::BLUE_CHANNEL, get_colour_channel<B>(aColour, B::BLUE_CHANNEL, 0));
+				set_colour_channel<A>(result, A::ALPHA_CHANNEL, get_colour_channel<B>(aColour, B::ALPHA_CHANNEL, static_cast<type>(A::MAX_ALPHA)));
+				return result;
+			}
+		};
+
+		template<class A, class B>
+		struct colour_caster<A, B, COLOUR_CAST_INTEGER> {
+			typedef typename A::type type;
+
+			enum : int64_t {
+				SRC_MAX = colour_max(B::TYPE),
+				DST_MAX = colour_max(A::TYPE),
+				DST_MIN = colour_min(A::TYPE)
+			};
+
+			static inline type scale(const int64_t aValue) throw() {
+				// Widening to a type whose maximum is a multiple of the source maximum is a single multiply,
+				// otherwise truncate towards zero like the float conversion does
+				const int64_t value = DST_MAX % SRC_MAX == 0 ? aValue * (DST_MAX / SRC_MAX) : (aValue * DST_MAX) / SRC_MAX;
+				// The most negative value of a signed type is below -SRC_MAX, so widening it can pass the minimum
+				return static_cast<type>(value < DST_MIN ? DST_MIN : value);
+			}
+
+			static inline A cast(const B& aColour) throw() {
+				A result;
+				set_colour_channel<A>(result, A::RED_CHANNEL, scale(get_colour_channel<B>(aColour, B::RED_CHANNEL, 0)));
+				set_colour_channel<A>(result, A::GREEN_CHANNEL, scale(get_colour_channel<B>(aColour, B::GREEN_CHANNEL, 0)));
+				set_colour_channel<A>(result, A::BLUE_CHANNEL, scale(get_colour_channel<B>(aColour, B::BLUE_CHANNEL, 0)));
+				set_colour_channel<A>(result, A::ALPHA_CHANNEL, B::ALPHA_CHANNEL == -1 ?
+					static_cast<type>(A::MAX_ALPHA) :
+					scale(get_colour_channel<B>(aColour, B::ALPHA_CHANNEL, 0))
+				);
+				return result;
+			}
+		};
+	}
+
+	/*!
+		\brief Convert a colour from one format or channel type to another
+		\details The conversion path is chosen at compile time, see implementation::select_colour_cast.
+	*/
+	template<class A, class B>
+	static inline A colour_cast(const B& aColour) throw() {
+		return implementation::colour_caster<A, B>::cast(aColour);
+	}
+
 	typedef colour_r<GL_UNSIGNED_BYTE> colour_r_8u;
 	typedef colour_rg<GL_UNSIGNED_BYTE> colour_rg_8u;
 	typedef colour_rgb<GL_UNSIGNED_BYTE> colour_rgb_8u;
@@ -469,6 +1184,23 @@ namespace asmith { namespace gl {
 	typedef colour_bgr<GL_FLOAT> colour_bgr_f;
 	typedef colour_bgra<GL_FLOAT> colour_bgra_f;
 
+	typedef colour_srgb<GL_RGB> colour_rgb_8u_srgb;
+	typedef colour_srgb<GL_RGBA> colour_rgba_8u_srgb;
+	typedef colour_srgb<GL_BGR> colour_bgr_8u_srgb;
+	typedef colour_srgb<GL_BGRA> colour_bgra_8u_srgb;
+
+	typedef colour_r<GL_HALF_FLOAT> colour_r_h;
+	typedef colour_rg<GL_HALF_FLOAT> colour_rg_h;
+	typedef colour_rgb<GL_HALF_FLOAT> colour_rgb_h;
+	typedef colour_rgba<GL_HALF_FLOAT> colour_rgba_h;
+
+	typedef colour<GL_RGB, GL_UNSIGNED_SHORT_5_6_5> colour_rgb_565;
+	typedef colour<GL_RGBA, GL_UNSIGNED_SHORT_4_4_4_4> colour_rgba_4444;
+	typedef colour<GL_RGBA, GL_UNSIGNED_SHORT_5_5_5_1> colour_rgba_5551;
+	typedef colour<GL_RGBA, GL_UNSIGNED_INT_10_10_10_2> colour_rgba_1010102;
+	typedef colour<GL_RGBA, GL_UNSIGNED_INT_2_10_10_10_REV> colour_rgba_2101010_rev;
+	typedef colour<GL_RGB, GL_UNSIGNED_INT_10F_11F_11F_REV> colour_rgb_11f_11f_10f;
+
 	// Colour values taken from http://cloford.com/resources/colours/500col.htm
 
 	static constexpr const colour_rgb_8u INDIAN_RED(176, 23, 31);
@@ -0,0 +1,921 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+#ifndef ASMITH_OPENGL_COLOUR_CONVERSION_HPP
+#define ASMITH_OPENGL_COLOUR_CONVERSION_HPP
+
+#include <cstring>
+#include <type_traits>
+#include "colour.hpp"
+
+#if defined(ASMITH_GL_AVX2) || defined(ASMITH_GL_F16C) || (defined(ASMITH_GL_FMA) && defined(ASMITH_GL_SSE2))
+	#include <immintrin.h>
+#elif defined(ASMITH_GL_SSE2)
+	#include <emmintrin.h>
+#endif
+#if defined(ASMITH_GL_NEON)
+	#include <arm_neon.h>
+#endif
+
+namespace asmith { namespace gl {
+
+	namespace implementation {
+
+		enum : int {
+			PIXEL_KERNEL_SCALAR,
+			PIXEL_KERNEL_COPY,
+			PIXEL_KERNEL_SWIZZLE,
+			PIXEL_KERNEL_FLOAT,
+			PIXEL_KERNEL_SRGB_ENCODE,
+			PIXEL_KERNEL_HALF,
+			PIXEL_KERNEL_PACK,
+			PIXEL_KERNEL_UNPACK
+		};
+
+		template<class C>
+		static constexpr size_t colour_channels() throw() {
+			return sizeof(C) / sizeof(typename C::type);
+		}
+
+		template<class C>
+		static constexpr bool is_simd_colour() throw() {
+			return
+				(C::FORMAT == GL_RGB || C::FORMAT == GL_RGBA || C::FORMAT == GL_BGR || C::FORMAT == GL_BGRA) &&
+				(C::TYPE == GL_UNSIGNED_BYTE || C::TYPE == GL_BYTE || C::TYPE == GL_FLOAT);
+		}
+
+		// Returns which channel of B is written to channel aLane of A, a missing alpha channel is read from lane 3
+		template<class A, class B>
+		static constexpr int source_lane(const int aLane) throw() {
+			return
+				aLane == A::RED_CHANNEL ? B::RED_CHANNEL :
+				aLane == A::GREEN_CHANNEL ? B::GREEN_CHANNEL :
+				aLane == A::BLUE_CHANNEL ? B::BLUE_CHANNEL :
+				B::ALPHA_CHANNEL == -1 ? 3 : B::ALPHA_CHANNEL;
+		}
+
+		template<class C>
+		static constexpr bool is_float_pixel_colour() throw() {
+			return
+				(C::FORMAT == GL_RGB || C::FORMAT == GL_RGBA || C::FORMAT == GL_BGR || C::FORMAT == GL_BGRA) &&
+				C::TYPE == GL_FLOAT;
+		}
+
+		template<class C>
+		static constexpr bool is_packed_colour() throw() {
+			return packed_layout<C::FORMAT, C::TYPE>::VALID;
+		}
+
+		template<class A, class B>
+		static constexpr bool is_half_pair() throw() {
+			return
+				static_cast<GLenum>(A::FORMAT) == static_cast<GLenum>(B::FORMAT) &&
+				((A::TYPE == GL_HALF_FLOAT && B::TYPE == GL_FLOAT) || (A::TYPE == GL_FLOAT && B::TYPE == GL_HALF_FLOAT));
+		}
+
+		template<class A, class B>
+		static constexpr int select_pixel_kernel() throw() {
+			return
+				std::is_same<A, B>::value ? PIXEL_KERNEL_COPY :
+				// Both types store the same channels in the same order, so every value is converted on its own
+				is_half_pair<A, B>() ? PIXEL_KERNEL_HALF :
+				is_packed_colour<A>() && is_float_pixel_colour<B>() ? PIXEL_KERNEL_PACK :
+				is_float_pixel_colour<A>() && is_packed_colour<B>() ? PIXEL_KERNEL_UNPACK :
+				! (is_simd_colour<A>() && is_simd_colour<B>()) ? PIXEL_KERNEL_SCALAR :
+				is_srgb_colour<A>::value && ! is_srgb_colour<B>::value && B::TYPE == GL_FLOAT ? PIXEL_KERNEL_SRGB_ENCODE :
+				// Decoding sRGB is a table lookup per channel, which colour_cast already does
+				is_srgb_colour<A>::value != is_srgb_colour<B>::value ? PIXEL_KERNEL_SCALAR :
+				// Negative values have no unsigned representation, so keep whatever colour_cast does with them
+				B::TYPE == GL_BYTE && A::TYPE == GL_UNSIGNED_BYTE ? PIXEL_KERNEL_SCALAR :
+				static_cast<GLenum>(A::FORMAT) == static_cast<GLenum>(B::FORMAT) && static_cast<GLenum>(A::TYPE) == static_cast<GLenum>(B::TYPE) ? PIXEL_KERNEL_COPY :
+				static_cast<GLenum>(A::TYPE) == static_cast<GLenum>(B::TYPE) && A::TYPE != GL_FLOAT ? PIXEL_KERNEL_SWIZZLE :
+				PIXEL_KERNEL_FLOAT;
+		}
+
+		template<class A, class B>
+		static inline void convert_pixels_scalar(const B* aSrc, A* aDst, size_t aCount) throw() {
+			for(size_t i = 0; i < aCount; ++i) aDst[i] = colour_cast<A, B>(aSrc[i]);
+		}
+
+#if defined(ASMITH_GL_SSE2)
+		// Loads and stores one pixel as four floats in memory order, a missing alpha channel loads as 1
+		template<const size_t CHANNELS>
+		struct sse2_pixel {
+			static inline __m128 load(const void* aSrc) throw() {
+				const GLfloat* const src = static_cast<const GLfloat*>(aSrc);
+				return CHANNELS == 4 ? _mm_loadu_ps(src) : _mm_setr_ps(src[0], src[1], src[2], 1.f);
+			}
+
+			static inline void store(void* aDst, const __m128 aValue) throw() {
+				GLfloat* const dst = static_cast<GLfloat*>(aDst);
+				if(CHANNELS == 4) {
+					_mm_storeu_ps(dst, aValue);
+				}else {
+					// Writing through a temporary array stalls the next load on store forwarding
+					_mm_storel_pi(reinterpret_cast<__m64*>(dst), aValue);
+					_mm_store_ss(dst + 2, _mm_movehl_ps(aValue, aValue));
+				}
+			}
+		};
+
+		// Loads and stores four four channel pixels in memory order, one pixel in each register
+		template<const GLenum T>
+		struct sse2_pixel_block;
+
+		template<>
+		struct sse2_pixel_block<GL_FLOAT> {
+			static inline void load(const void* aSrc, __m128 (&aValue)[4]) throw() {
+				const GLfloat* const src = static_cast<const GLfloat*>(aSrc);
+				aValue[0] = _mm_loadu_ps(src);
+				aValue[1] = _mm_loadu_ps(src + 4);
+				aValue[2] = _mm_loadu_ps(src + 8);
+				aValue[3] = _mm_loadu_ps(src + 12);
+			}
+
+			static inline void store(void* aDst, const __m128 (&aValue)[4]) throw() {
+				GLfloat* const dst = static_cast<GLfloat*>(aDst);
+				_mm_storeu_ps(dst, aValue[0]);
+				_mm_storeu_ps(dst + 4, aValue[1]);
+				_mm_storeu_ps(dst + 8, aValue[2]);
+				_mm_storeu_ps(dst + 12, aValue[3]);
+			}
+		};
+
+		template<>
+		struct sse2_pixel_block<GL_UNSIGNED_BYTE> {
+			static inline void load(const void* aSrc, __m128 (&aValue)[4]) throw() {
+				const __m128i zero = _mm_setzero_si128();
+				const __m128i v = _mm_loadu_si128(static_cast<const __m128i*>(aSrc));
+				const __m128i lo = _mm_unpacklo_epi8(v, zero);
+				const __m128i hi = _mm_unpackhi_epi8(v, zero);
+				aValue[0] = _mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero));
+				aValue[1] = _mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero));
+				aValue[2] = _mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero));
+				aValue[3] = _mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero));
+			}
+
+			static inline void store(void* aDst, const __m128 (&aValue)[4]) throw() {
+				const __m128i lo = _mm_packs_epi32(_mm_cvttps_epi32(aValue[0]), _mm_cvttps_epi32(aValue[1]));
+				const __m128i hi = _mm_packs_epi32(_mm_cvttps_epi32(aValue[2]), _mm_cvttps_epi32(aValue[3]));
+				_mm_storeu_si128(static_cast<__m128i*>(aDst), _mm_packus_epi16(lo, hi));
+			}
+		};
+
+		template<>
+		struct sse2_pixel_block<GL_BYTE> {
+			static inline void load(const void* aSrc, __m128 (&aValue)[4]) throw() {
+				const __m128i v = _mm_loadu_si128(static_cast<const __m128i*>(aSrc));
+				const __m128i lo = _mm_srai_epi16(_mm_unpacklo_epi8(v, v), 8);
+				const __m128i hi = _mm_srai_epi16(_mm_unpackhi_epi8(v, v), 8);
+				aValue[0] = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(lo, lo), 16));
+				aValue[1] = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(lo, lo), 16));
+				aValue[2] = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(hi, hi), 16));
+				aValue[3] = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(hi, hi), 16));
+			}
+
+			static inline void store(void* aDst, const __m128 (&aValue)[4]) throw() {
+				const __m128i lo = _mm_packs_epi32(_mm_cvttps_epi32(aValue[0]), _mm_cvttps_epi32(aValue[1]));
+				const __m128i hi = _mm_packs_epi32(_mm_cvttps_epi32(aValue[2]), _mm_cvttps_epi32(aValue[3]));
+				_mm_storeu_si128(static_cast<__m128i*>(aDst), _mm_packs_epi16(lo, hi));
+			}
+		};
+
+		// Loads eight float pixels with each channel in its own pair of registers, like neon_pixels. A missing
+		// alpha channel loads as 1
+		template<const size_t CHANNELS>
+		static inline void sse2_load_channels(const GLfloat* aSrc, __m128 (&aValue)[4][2]) throw() {
+			for(int h = 0; h < 2; ++h) {
+				const GLfloat* const src = aSrc + h * 4 * CHANNELS;
+				__m128 p0 = _mm_loadu_ps(src);
+				__m128 p1 = _mm_loadu_ps(src + CHANNELS);
+				__m128 p2 = _mm_loadu_ps(src + CHANNELS * 2);
+				// The last three channel pixel is loaded one float early so that the load stays inside the array
+				__m128 p3 = _mm_loadu_ps(src + (CHANNELS == 4 ? 12 : 8));
+				if(CHANNELS == 3) p3 = _mm_shuffle_ps(p3, p3, _MM_SHUFFLE(3, 3, 2, 1));
+				_MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+				aValue[0][h] = p0;
+				aValue[1][h] = p1;
+				aValue[2][h] = p2;
+				aValue[3][h] = CHANNELS == 4 ? p3 : _mm_set1_ps(1.f);
+			}
+		}
+
+		// Stores eight 8 bit pixels from one pair of registers per channel
+		template<const size_t CHANNELS>
+		static inline void sse2_store_channels(uint8_t* aDst, const __m128 (&aValue)[4][2]) throw() {
+			for(int h = 0; h < 2; ++h) {
+				const __m128i rg = _mm_packs_epi32(_mm_cvttps_epi32(aValue[0][h]), _mm_cvttps_epi32(aValue[1][h]));
+				const __m128i ba = _mm_packs_epi32(_mm_cvttps_epi32(aValue[2][h]), _mm_cvttps_epi32(aValue[3][h]));
+				// Bytes r0 r1 r2 r3 g0 g1 g2 g3 b0 b1 b2 b3 a0 a1 a2 a3 become r0 g0 b0 a0 r1 g1 b1 a1 ...
+				__m128i v = _mm_packus_epi16(rg, ba);
+				v = _mm_unpacklo_epi8(v, _mm_srli_si128(v, 8));
+				v = _mm_unpacklo_epi8(v, _mm_srli_si128(v, 8));
+				uint8_t* const dst = aDst + h * 4 * CHANNELS;
+				if(CHANNELS == 4) {
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), v);
+				}else {
+					// Each four byte store overwrites the unused fourth byte of the one before it, the last pixel is
+					// stored one byte at a time so that nothing after the array is written
+					for(int p = 0; p < 3; ++p) {
+						const uint32_t bits = static_cast<uint32_t>(_mm_cvtsi128_si32(v));
+						memcpy(dst + p * 3, &bits, sizeof(uint32_t));
+						v = _mm_srli_si128(v, 4);
+					}
+					const uint32_t bits = static_cast<uint32_t>(_mm_cvtsi128_si32(v));
+					dst[9] = static_cast<uint8_t>(bits);
+					dst[10] = static_cast<uint8_t>(bits >> 8);
+					dst[11] = static_cast<uint8_t>(bits >> 16);
+				}
+			}
+		}
+
+		// Multiplies a channel of B by the maximum of A over the maximum of B, see pixel_converter<PIXEL_KERNEL_FLOAT>
+		template<class A, class B>
+		static inline __m128 sse2_rescale(const __m128 aValue) throw() {
+			if(B::TYPE == GL_FLOAT || A::TYPE != GL_FLOAT) {
+				return _mm_mul_ps(aValue, _mm_set1_ps(static_cast<GLfloat>(A::MAX_RED) / static_cast<GLfloat>(B::MAX_RED)));
+			}
+	#if defined(ASMITH_GL_FMA)
+			const __m128 max = _mm_set1_ps(static_cast<GLfloat>(B::MAX_RED));
+			const __m128 reciprocal = _mm_set1_ps(1.f / static_cast<GLfloat>(B::MAX_RED));
+			const __m128 quotient = _mm_mul_ps(aValue, reciprocal);
+			return _mm_fmadd_ps(_mm_fnmadd_ps(quotient, max, aValue), reciprocal, quotient);
+	#else
+			const __m128d reciprocal = _mm_set1_pd(1.0 / static_cast<double>(B::MAX_RED));
+			const __m128 lo = _mm_cvtpd_ps(_mm_mul_pd(_mm_cvtps_pd(aValue), reciprocal));
+			const __m128 hi = _mm_cvtpd_ps(_mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(aValue, aValue)), reciprocal));
+			return _mm_movelh_ps(lo, hi);
+	#endif
+		}
+
+		// Vector form of srgb_encode, returns the encoded value scaled to [0.5, 255.5] ready to be truncated
+		static inline __m128 sse2_srgb_encode(__m128 aValue) throw() {
+			aValue = _mm_min_ps(_mm_max_ps(aValue, _mm_setzero_ps()), _mm_set1_ps(1.f));
+			const __m128 s1 = _mm_sqrt_ps(aValue);
+			const __m128 s2 = _mm_sqrt_ps(s1);
+			const __m128 s3 = _mm_sqrt_ps(s2);
+			const __m128 linear = _mm_mul_ps(aValue, _mm_set1_ps(12.92f));
+			const __m128 mask = _mm_cmple_ps(aValue, _mm_set1_ps(0.0031308f));
+	#if defined(ASMITH_GL_FMA)
+			__m128 curve = _mm_mul_ps(_mm_set1_ps(0.662002687f), s1);
+			curve = _mm_fmadd_ps(_mm_set1_ps(0.684122060f), s2, curve);
+			curve = _mm_fmadd_ps(_mm_set1_ps(-0.323583601f), s3, curve);
+			curve = _mm_fmadd_ps(_mm_set1_ps(-0.0225411470f), aValue, curve);
+			const __m128 s = _mm_or_ps(_mm_and_ps(mask, linear), _mm_andnot_ps(mask, curve));
+			return _mm_fmadd_ps(s, _mm_set1_ps(255.f), _mm_set1_ps(0.5f));
+	#else
+			__m128 curve = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(0.662002687f), s1), _mm_mul_ps(_mm_set1_ps(0.684122060f), s2));
+			curve = _mm_sub_ps(curve, _mm_mul_ps(_mm_set1_ps(0.323583601f), s3));
+			curve = _mm_sub_ps(curve, _mm_mul_ps(_mm_set1_ps(0.0225411470f), aValue));
+			const __m128 s = _mm_or_ps(_mm_and_ps(mask, linear), _mm_andnot_ps(mask, curve));
+			return _mm_add_ps(_mm_mul_ps(s, _mm_set1_ps(255.f)), _mm_set1_ps(0.5f));
+	#endif
+		}
+#endif
+
+#if defined(ASMITH_GL_AVX2)
+		enum : int {
+			AVX2_NO_SHUFFLE = _MM_SHUFFLE(3, 2, 1, 0)
+		};
+
+		// A byte shuffle that reorders the channels of four 8 bit pixels like _mm_shuffle_ps(v, v, SHUFFLE)
+		template<const int SHUFFLE>
+		static inline __m128i avx2_byte_shuffle() throw() {
+			enum : char {
+				L0 = SHUFFLE & 3,
+				L1 = (SHUFFLE >> 2) & 3,
+				L2 = (SHUFFLE >> 4) & 3,
+				L3 = (SHUFFLE >> 6) & 3
+			};
+			return _mm_setr_epi8(L0, L1, L2, L3, 4 + L0, 4 + L1, 4 + L2, 4 + L3, 8 + L0, 8 + L1, 8 + L2, 8 + L3, 12 + L0, 12 + L1, 12 + L2, 12 + L3);
+		}
+
+		// Loads and stores eight four channel pixels in memory order, two pixels in each register. SHUFFLE
+		// reorders the channels of each pixel, which is one byte shuffle for 8 bit pixels instead of one float
+		// shuffle per register
+		template<const GLenum T>
+		struct avx2_pixel_block;
+
+		template<>
+		struct avx2_pixel_block<GL_FLOAT> {
+			template<const int SHUFFLE>
+			static inline void load(const void* aSrc, __m256 (&aValue)[4]) throw() {
+				const GLfloat* const src = static_cast<const GLfloat*>(aSrc);
+				aValue[0] = _mm256_loadu_ps(src);
+				aValue[1] = _mm256_loadu_ps(src + 8);
+				aValue[2] = _mm256_loadu_ps(src + 16);
+				aValue[3] = _mm256_loadu_ps(src + 24);
+				if(SHUFFLE != AVX2_NO_SHUFFLE) {
+					aValue[0] = _mm256_shuffle_ps(aValue[0], aValue[0], SHUFFLE);
+					aValue[1] = _mm256_shuffle_ps(aValue[1], aValue[1], SHUFFLE);
+					aValue[2] = _mm256_shuffle_ps(aValue[2], aValue[2], SHUFFLE);
+					aValue[3] = _mm256_shuffle_ps(aValue[3], aValue[3], SHUFFLE);
+				}
+			}
+
+			template<const int SHUFFLE>
+			static inline void store(void* aDst, const __m256 (&aValue)[4]) throw() {
+				GLfloat* const dst = static_cast<GLfloat*>(aDst);
+				_mm256_storeu_ps(dst, SHUFFLE == AVX2_NO_SHUFFLE ? aValue[0] : _mm256_shuffle_ps(aValue[0], aValue[0], SHUFFLE));
+				_mm256_storeu_ps(dst + 8, SHUFFLE == AVX2_NO_SHUFFLE ? aValue[1] : _mm256_shuffle_ps(aValue[1], aValue[1], SHUFFLE));
+				_mm256_storeu_ps(dst + 16, SHUFFLE == AVX2_NO_SHUFFLE ? aValue[2] : _mm256_shuffle_ps(aValue[2], aValue[2], SHUFFLE));
+				_mm256_storeu_ps(dst + 24, SHUFFLE == AVX2_NO_SHUFFLE ? aValue[3] : _mm256_shuffle_ps(aValue[3], aValue[3], SHUFFLE));
+			}
+		};
+
+		template<const GLenum T>
+		struct avx2_byte_pixel_block {
+			static inline __m256i widen(const __m128i aValue) throw() {
+				return T == GL_BYTE ? _mm256_cvtepi8_epi32(aValue) : _mm256_cvtepu8_epi32(aValue);
+			}
+
+			template<const int SHUFFLE>
+			static inline void load(const void* aSrc, __m256 (&aValue)[4]) throw() {
+				const __m128i* const src = static_cast<const __m128i*>(aSrc);
+				__m128i lo = _mm_loadu_si128(src);
+				__m128i hi = _mm_loadu_si128(src + 1);
+				if(SHUFFLE != AVX2_NO_SHUFFLE) {
+					const __m128i shuffle = avx2_byte_shuffle<SHUFFLE>();
+					lo = _mm_shuffle_epi8(lo, shuffle);
+					hi = _mm_shuffle_epi8(hi, shuffle);
+				}
+				aValue[0] = _mm256_cvtepi32_ps(widen(lo));
+				aValue[1] = _mm256_cvtepi32_ps(widen(_mm_unpackhi_epi64(lo, lo)));
+				aValue[2] = _mm256_cvtepi32_ps(widen(hi));
+				aValue[3] = _mm256_cvtepi32_ps(widen(_mm_unpackhi_epi64(hi, hi)));
+			}
+
+			template<const int SHUFFLE>
+			static inline void store(void* aDst, const __m256 (&aValue)[4]) throw() {
+				// The packs work within each 128 bit half, which leaves the pixels in the order 0 2 4 6 1 3 5 7
+				const __m256i lo = _mm256_packs_epi32(_mm256_cvttps_epi32(aValue[0]), _mm256_cvttps_epi32(aValue[1]));
+				const __m256i hi = _mm256_packs_epi32(_mm256_cvttps_epi32(aValue[2]), _mm256_cvttps_epi32(aValue[3]));
+				__m256i v = T == GL_BYTE ? _mm256_packs_epi16(lo, hi) : _mm256_packus_epi16(lo, hi);
+				if(SHUFFLE != AVX2_NO_SHUFFLE) v = _mm256_shuffle_epi8(v, _mm256_broadcastsi128_si256(avx2_byte_shuffle<SHUFFLE>()));
+				v = _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+				_mm256_storeu_si256(static_cast<__m256i*>(aDst), v);
+			}
+		};
+
+		template<>
+		struct avx2_pixel_block<GL_UNSIGNED_BYTE> : public avx2_byte_pixel_block<GL_UNSIGNED_BYTE> {};
+
+		template<>
+		struct avx2_pixel_block<GL_BYTE> : public avx2_byte_pixel_block<GL_BYTE> {};
+
+		// Eight lane form of sse2_rescale
+		template<class A, class B>
+		static inline __m256 avx2_rescale(const __m256 aValue) throw() {
+			if(B::TYPE == GL_FLOAT || A::TYPE != GL_FLOAT) {
+				return _mm256_mul_ps(aValue, _mm256_set1_ps(static_cast<GLfloat>(A::MAX_RED) / static_cast<GLfloat>(B::MAX_RED)));
+			}
+	#if defined(ASMITH_GL_FMA)
+			const __m256 max = _mm256_set1_ps(static_cast<GLfloat>(B::MAX_RED));
+			const __m256 reciprocal = _mm256_set1_ps(1.f / static_cast<GLfloat>(B::MAX_RED));
+			const __m256 quotient = _mm256_mul_ps(aValue, reciprocal);
+			return _mm256_fmadd_ps(_mm256_fnmadd_ps(quotient, max, aValue), reciprocal, quotient);
+	#else
+			const __m256d reciprocal = _mm256_set1_pd(1.0 / static_cast<double>(B::MAX_RED));
+			const __m128 lo = _mm256_cvtpd_ps(_mm256_mul_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(aValue)), reciprocal));
+			const __m128 hi = _mm256_cvtpd_ps(_mm256_mul_pd(_mm256_cvtps_pd(_mm256_extractf128_ps(aValue, 1)), reciprocal));
+			return _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1);
+	#endif
+		}
+#endif
+
+#if defined(ASMITH_GL_NEON)
+		// Loads and stores eight pixels with each channel in its own pair of registers
+		template<const GLenum T, const size_t CHANNELS>
+		struct neon_pixels;
+
+		template<const size_t CHANNELS>
+		struct neon_pixels<GL_FLOAT, CHANNELS> {
+			static inline void load(const void* aSrc, float32x4_t (&aValue)[4][2]) throw() {
+				const GLfloat* const src = static_cast<const GLfloat*>(aSrc);
+				if(CHANNELS == 4) {
+					const float32x4x4_t lo = vld4q_f32(src);
+					const float32x4x4_t hi = vld4q_f32(src + 16);
+					for(int c = 0; c < 4; ++c) {
+						aValue[c][0] = lo.val[c];
+						aValue[c][1] = hi.val[c];
+					}
+				}else {
+					const float32x4x3_t lo = vld3q_f32(src);
+					const float32x4x3_t hi = vld3q_f32(src + 12);
+					for(int c = 0; c < 3; ++c) {
+						aValue[c][0] = lo.val[c];
+						aValue[c][1] = hi.val[c];
+					}
+					aValue[3][0] = aValue[3][1] = vdupq_n_f32(1.f);
+				}
+			}
+
+			static inline void store(void* aDst, const float32x4_t (&aValue)[4][2]) throw() {
+				GLfloat* const dst = static_cast<GLfloat*>(aDst);
+				if(CHANNELS == 4) {
+					float32x4x4_t lo, hi;
+					for(int c = 0; c < 4; ++c) {
+						lo.val[c] = aValue[c][0];
+						hi.val[c] = aValue[c][1];
+					}
+					vst4q_f32(dst, lo);
+					vst4q_f32(dst + 16, hi);
+				}else {
+					float32x4x3_t lo, hi;
+					for(int c = 0; c < 3; ++c) {
+						lo.val[c] = aValue[c][0];
+						hi.val[c] = aValue[c][1];
+					}
+					vst3q_f32(dst, lo);
+					vst3q_f32(dst + 12, hi);
+				}
+			}
+		};
+
+		template<const size_t CHANNELS>
+		struct neon_pixels<GL_UNSIGNED_BYTE, CHANNELS> {
+			static inline void widen(const uint8x8_t aValue, float32x4_t (&aOut)[2]) throw() {
+				const uint16x8_t w = vmovl_u8(aValue);
+				aOut[0] = vcvtq_f32_u32(vmovl_u16(vget_low_u16(w)));
+				aOut[1] = vcvtq_f32_u32(vmovl_u16(vget_high_u16(w)));
+			}
+
+			static inline uint8x8_t narrow(const float32x4_t (&aValue)[2]) throw() {
+				return vqmovn_u16(vcombine_u16(vqmovn_u32(vcvtq_u32_f32(aValue[0])), vqmovn_u32(vcvtq_u32_f32(aValue[1]))));
+			}
+
+			static inline void load(const void* aSrc, float32x4_t (&aValue)[4][2]) throw() {
+				const uint8_t* const src = static_cast<const uint8_t*>(aSrc);
+				if(CHANNELS == 4) {
+					const uint8x8x4_t v = vld4_u8(src);
+					for(int c = 0; c < 4; ++c) widen(v.val[c], aValue[c]);
+				}else {
+					const uint8x8x3_t v = vld3_u8(src);
+					for(int c = 0; c < 3; ++c) widen(v.val[c], aValue[c]);
+					aValue[3][0] = aValue[3][1] = vdupq_n_f32(static_cast<GLfloat>(UINT8_MAX));
+				}
+			}
+
+			static inline void store(void* aDst, const float32x4_t (&aValue)[4][2]) throw() {
+				uint8_t* const dst = static_cast<uint8_t*>(aDst);
+				if(CHANNELS == 4) {
+					uint8x8x4_t v;
+					for(int c = 0; c < 4; ++c) v.val[c] = narrow(aValue[c]);
+					vst4_u8(dst, v);
+				}else {
+					uint8x8x3_t v;
+					for(int c = 0; c < 3; ++c) v.val[c] = narrow(aValue[c]);
+					vst3_u8(dst, v);
+				}
+			}
+		};
+
+		template<const size_t CHANNELS>
+		struct neon_pixels<GL_BYTE, CHANNELS> {
+			static inline void widen(const int8x8_t aValue, float32x4_t (&aOut)[2]) throw() {
+				const int16x8_t w = vmovl_s8(aValue);
+				aOut[0] = vcvtq_f32_s32(vmovl_s16(vget_low_s16(w)));
+				aOut[1] = vcvtq_f32_s32(vmovl_s16(vget_high_s16(w)));
+			}
+
+			static inline int8x8_t narrow(const float32x4_t (&aValue)[2]) throw() {
+				return vqmovn_s16(vcombine_s16(vqmovn_s32(vcvtq_s32_f32(aValue[0])), vqmovn_s32(vcvtq_s32_f32(aValue[1]))));
+			}
+
+			static inline void load(const void* aSrc, float32x4_t (&aValue)[4][2]) throw() {
+				const int8_t* const src = static_cast<const int8_t*>(aSrc);
+				if(CHANNELS == 4) {
+					const int8x8x4_t v = vld4_s8(src);
+					for(int c = 0; c < 4; ++c) widen(v.val[c], aValue[c]);
+				}else {
+					const int8x8x3_t v = vld3_s8(src);
+					for(int c = 0; c < 3; ++c) widen(v.val[c], aValue[c]);
+					aValue[3][0] = aValue[3][1] = vdupq_n_f32(static_cast<GLfloat>(INT8_MAX));
+				}
+			}
+
+			static inline void store(void* aDst, const float32x4_t (&aValue)[4][2]) throw() {
+				int8_t* const dst = static_cast<int8_t*>(aDst);
+				if(CHANNELS == 4) {
+					int8x8x4_t v;
+					for(int c = 0; c < 4; ++c) v.val[c] = narrow(aValue[c]);
+					vst4_s8(dst, v);
+				}else {
+					int8x8x3_t v;
+					for(int c = 0; c < 3; ++c) v.val[c] = narrow(aValue[c]);
+					vst3_s8(dst, v);
+				}
+			}
+		};
+
+		// Vector form of srgb_encode, returns the encoded value scaled to [0.5, 255.5] ready to be truncated
+		static inline float32x4_t neon_srgb_encode(float32x4_t aValue) throw() {
+			aValue = vminnmq_f32(vmaxnmq_f32(aValue, vdupq_n_f32(0.f)), vdupq_n_f32(1.f));
+			const float32x4_t s1 = vsqrtq_f32(aValue);
+			const float32x4_t s2 = vsqrtq_f32(s1);
+			const float32x4_t s3 = vsqrtq_f32(s2);
+			// AArch64 always has FMA, so srgb_encode fuses the same operations
+			float32x4_t curve = vmulq_f32(vdupq_n_f32(0.662002687f), s1);
+			curve = vfmaq_f32(curve, vdupq_n_f32(0.684122060f), s2);
+			curve = vfmaq_f32(curve, vdupq_n_f32(-0.323583601f), s3);
+			curve = vfmaq_f32(curve, vdupq_n_f32(-0.0225411470f), aValue);
+			const float32x4_t linear = vmulq_f32(aValue, vdupq_n_f32(12.92f));
+			const float32x4_t s = vbslq_f32(vcleq_f32(aValue, vdupq_n_f32(0.0031308f)), linear, curve);
+			return vfmaq_f32(vdupq_n_f32(0.5f), s, vdupq_n_f32(255.f));
+		}
+
+		// Multiplies a channel of B by the maximum of A over the maximum of B, see pixel_converter<PIXEL_KERNEL_FLOAT>
+		template<class A, class B>
+		static inline float32x4_t neon_rescale(const float32x4_t aValue) throw() {
+			if(B::TYPE == GL_FLOAT || A::TYPE != GL_FLOAT) {
+				return vmulq_n_f32(aValue, static_cast<GLfloat>(A::MAX_RED) / static_cast<GLfloat>(B::MAX_RED));
+			}
+			const float64x2_t scale = vdupq_n_f64(1.0 / static_cast<double>(B::MAX_RED));
+			const float32x2_t lo = vcvt_f32_f64(vmulq_f64(vcvt_f64_f32(vget_low_f32(aValue)), scale));
+			return vcvt_high_f32_f64(lo, vmulq_f64(vcvt_high_f64_f32(aValue), scale));
+		}
+#endif
+
+		template<class A, class B, const int KERNEL = select_pixel_kernel<A, B>()>
+		struct pixel_converter {
+			static inline void convert(const B* aSrc, A* aDst, size_t aCount) throw() {
+				convert_pixels_scalar<A, B>(aSrc, aDst, aCount);
+			}
+		};
+
+		template<class A, class B>
+		struct pixel_converter<A, B, PIXEL_KERNEL_COPY> {
+			static inline void convert(const B* aSrc, A* aDst, size_t aCount) throw() {
+				// Converting 8 bit and float channels to themselves through colour_cast is exact
+				memcpy(aDst, aSrc, sizeof(A) * aCount);
+			}
+		};
+
+		template<class A, class B>
+		struct pixel_converter<A, B, PIXEL_KERNEL_FLOAT> {
+			enum : size_t {
+				SRC_CHANNELS = colour_channels<B>(),
+				DST_CHANNELS = colour_channels<A>()
+			};
+
+			static inline void convert(const B* aSrc, A* aDst, size_t aCount) throw() {
+				// colour_cast divides by the source maximum then multiplies by the destination maximum. The kernels
+				// multiply by a precomputed scale instead and still write the same values. A float source has a
+				// maximum of 1, so its division is exact. v * (127 / 255) truncates the same as (v / 255) * 127 for
+				// every 8 bit value. An 8 bit value over its maximum is the product with the reciprocal plus one FMA
+				// correction, or the product in double precision without FMA, both of which round to the same float
+				// as the division. tests/colour_conversion.cpp checks every 8 bit value
+				size_t i = 0;
+#if defined(ASMITH_GL_NEON)
+				float32x4_t src[4][2];
+				float32x4_t dst[4][2];
+				for(; i + 8 <= aCount; i += 8) {
+					neon_pixels<B::TYPE, SRC_CHANNELS>::load(aSrc + i, src);
+					for(int c = 0; c < 4; ++c) {
+						const int lane = source_lane<A, B>(c);
+						dst[c][0] = neon_rescale<A, B>(src[lane][0]);
+						dst[c][1] = neon_rescale<A, B>(src[lane][1]);
+					}
+					neon_pixels<A::TYPE, DST_CHANNELS>::store(aDst + i, dst);
+				}
+#elif defined(ASMITH_GL_SSE2)
+				if(SRC_CHANNELS != 4 || DST_CHANNELS != 4) {
+					// Three channel pixels do not line up with the lanes of a register, and compilers vectorise the
+					// scalar loop over them better than a transpose
+					convert_pixels_scalar<A, B>(aSrc, aDst, aCount);
+					return;
+				}
+
+				// Every channel has the same scale, so the channels are converted in memory order and each pixel is
+				// reordered with one shuffle
+				enum : int {
+					SHUFFLE = _MM_SHUFFLE((source_lane<A, B>(3)), (source_lane<A, B>(2)), (source_lane<A, B>(1)), (source_lane<A, B>(0)))
+				};
+	#if defined(ASMITH_GL_AVX2)
+				// Channels are reordered on the 8 bit side of the conversion when there is one
+				enum : int {
+					LOAD_SHUFFLE = B::TYPE == GL_FLOAT && A::TYPE != GL_FLOAT ? static_cast<int>(AVX2_NO_SHUFFLE) : static_cast<int>(SHUFFLE),
+					STORE_SHUFFLE = B::TYPE == GL_FLOAT && A::TYPE != GL_FLOAT ? static_cast<int>(SHUFFLE) : static_cast<int>(AVX2_NO_SHUFFLE)
+				};
+				for(; i + 8 <= aCount; i += 8) {
+					__m256 v[4];
+					avx2_pixel_block<B::TYPE>::template load<LOAD_SHUFFLE>(aSrc + i, v);
+					// Written out because GCC does not unroll a loop here at -O2 and the registers are spilled
+					v[0] = avx2_rescale<A, B>(v[0]);
+					v[1] = avx2_rescale<A, B>(v[1]);
+					v[2] = avx2_rescale<A, B>(v[2]);
+					v[3] = avx2_rescale<A, B>(v[3]);
+					avx2_pixel_block<A::TYPE>::template store<STORE_SHUFFLE>(aDst + i, v);
+				}
+	#endif
+				for(; i + 4 <= aCount; i += 4) {
+					__m128 v[4];
+					sse2_pixel_block<B::TYPE>::load(aSrc + i, v);
+					v[0] = sse2_rescale<A, B>(_mm_shuffle_ps(v[0], v[0], SHUFFLE));
+					v[1] = sse2_rescale<A, B>(_mm_shuffle_ps(v[1], v[1], SHUFFLE));
+					v[2] = sse2_rescale<A, B>(_mm_shuffle_ps(v[2], v[2], SHUFFLE));
+					v[3] = sse2_rescale<A, B>(_mm_shuffle_ps(v[3], v[3], SHUFFLE));
+					sse2_pixel_block<A::TYPE>::store(aDst + i, v);
+				}
+#endif
+				convert_pixels_scalar<A, B>(aSrc + i, aDst + i, aCount - i);
+			}
+		};
+
+		template<class A, class B>
+		struct pixel_converter<A, B, PIXEL_KERNEL_SWIZZLE> {
+			enum : size_t {
+				SRC_CHANNELS = colour_channels<B>(),
+				DST_CHANNELS = colour_channels<A>()
+			};
+
+			static inline void convert(const B* aSrc, A* aDst, size_t aCount) throw() {
+				// Both types have the same 8 bit channels, which round trip through colour_cast exactly
+				size_t i = 0;
+#if defined(ASMITH_GL_NEON)
+				const uint8x16_t alpha = vdupq_n_u8(B::TYPE == GL_BYTE ? INT8_MAX : UINT8_MAX);
+				uint8x16_t src[4];
+				for(; i + 16 <= aCount; i += 16) {
+					const uint8_t* const s = reinterpret_cast<const uint8_t*>(aSrc + i);
+					uint8_t* const d = reinterpret_cast<uint8_t*>(aDst + i);
+					if(SRC_CHANNELS == 4) {
+						const uint8x16x4_t v = vld4q_u8(s);
+						for(int c = 0; c < 4; ++c) src[c] = v.val[c];
+					}else {
+						const uint8x16x3_t v = vld3q_u8(s);
+						for(int c = 0; c < 3; ++c) src[c] = v.val[c];
+						src[3] = alpha;
+					}
+					if(DST_CHANNELS == 4) {
+						uint8x16x4_t v;
+						for(int c = 0; c < 4; ++c) v.val[c] = src[source_lane<A, B>(c)];
+						vst4q_u8(d, v);
+					}else {
+						uint8x16x3_t v;
+						for(int c = 0; c < 3; ++c) v.val[c] = src[source_lane<A, B>(c)];
+						vst3q_u8(d, v);
+					}
+				}
+#elif defined(ASMITH_GL_SSE2)
+				if(SRC_CHANNELS != 4 || DST_CHANNELS != 4) {
+					// Adding or removing a channel is a byte copy in colour_cast, which is faster than converting one
+					// pixel at a time through floats
+					convert_pixels_scalar<A, B>(aSrc, aDst, aCount);
+					return;
+				}
+
+				// The only four channel pair with different formats is RGBA and BGRA, which swaps bytes 0 and 2
+				const uint8_t* const s = reinterpret_cast<const uint8_t*>(aSrc);
+				uint8_t* const d = reinterpret_cast<uint8_t*>(aDst);
+	#if defined(ASMITH_GL_AVX2)
+				const __m256i mask256 = _mm256_set1_epi32(static_cast<int>(0xFF00FF00u));
+				for(; i + 8 <= aCount; i += 8) {
+					const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i * 4));
+					const __m256i rb = _mm256_andnot_si256(mask256, v);
+					const __m256i swapped = _mm256_or_si256(_mm256_slli_epi32(rb, 16), _mm256_srli_epi32(rb, 16));
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(d + i * 4), _mm256_or_si256(_mm256_and_si256(v, mask256), swapped));
+				}
+	#endif
+				const __m128i mask = _mm_set1_epi32(static_cast<int>(0xFF00FF00u));
+				for(; i + 4 <= aCount; i += 4) {
+					const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i * 4));
+					const __m128i rb = _mm_andnot_si128(mask, v);
+					const __m128i swapped = _mm_or_si128(_mm_slli_epi32(rb, 16), _mm_srli_epi32(rb, 16));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(d + i * 4), _mm_or_si128(_mm_and_si128(v, mask), swapped));
+				}
+#endif
+				convert_pixels_scalar<A, B>(aSrc + i, aDst + i, aCount - i);
+			}
+		};
+
+		template<class A, class B>
+		struct pixel_converter<A, B, PIXEL_KERNEL_SRGB_ENCODE> {
+			enum : size_t {
+				SRC_CHANNELS = colour_channels<B>(),
+				DST_CHANNELS = colour_channels<A>()
+			};
+
+			static inline void convert(const B* aSrc, A* aDst, size_t aCount) throw() {
+				// Colour channels are encoded with the same approximation as srgb_encode, alpha stays linear
+				size_t i = 0;
+#if defined(ASMITH_GL_NEON)
+				const float32x4_t alphaScale = vdupq_n_f32(255.f);
+				float32x4_t src[4][2];
+				float32x4_t dst[4][2];
+				for(; i + 8 <= aCount; i += 8) {
+					neon_pixels<GL_FLOAT, SRC_CHANNELS>::load(aSrc + i, src);
+					for(int c = 0; c < 4; ++c) {
+						const int lane = source_lane<A, B>(c);
+						for(int h = 0; h < 2; ++h) {
+							dst[c][h] = c == A::ALPHA_CHANNEL ? vmulq_f32(src[lane][h], alphaScale) : neon_srgb_encode(src[lane][h]);
+						}
+					}
+					neon_pixels<GL_UNSIGNED_BYTE, DST_CHANNELS>::store(aDst + i, dst);
+				}
+#elif defined(ASMITH_GL_SSE2)
+				const __m128 alphaScale = _mm_set1_ps(255.f);
+				__m128 src[4][2];
+				__m128 dst[4][2];
+				for(; i + 8 <= aCount; i += 8) {
+					sse2_load_channels<SRC_CHANNELS>(reinterpret_cast<const GLfloat*>(aSrc + i), src);
+					for(int c = 0; c < 4; ++c) {
+						const int lane = source_lane<A, B>(c);
+						for(int h = 0; h < 2; ++h) {
+							dst[c][h] = c == A::ALPHA_CHANNEL ? _mm_mul_ps(src[lane][h], alphaScale) : sse2_srgb_encode(src[lane][h]);
+						}
+					}
+					sse2_store_channels<DST_CHANNELS>(reinterpret_cast<uint8_t*>(aDst + i), dst);
+				}
+#endif
+				convert_pixels_scalar<A, B>(aSrc + i, aDst + i, aCount - i);
+			}
+		};
+
+		template<class A, class B>
+		struct pixel_converter<A, B, PIXEL_KERNEL_HALF> {
+			static inline void convert(const B* aSrc, A* aDst, size_t aCount) throw() {
+				// colour_cast rounds to nearest even like the hardware conversions, so the pixels can be treated as
+				// one array of values
+				const size_t count = aCount * colour_channels<A>();
+				if(A::TYPE == GL_HALF_FLOAT) {
+					convert_halves(reinterpret_cast<const GLfloat*>(aSrc), reinterpret_cast<GLhalf*>(aDst), count);
+				}else {
+					convert_halves(reinterpret_cast<const GLhalf*>(aSrc), reinterpret_cast<GLfloat*>(aDst), count);
+				}
+			}
+
+			static inline void convert_halves(const GLfloat* aSrc, GLhalf* aDst, size_t aCount) throw() {
+				size_t i = 0;
+#if defined(ASMITH_GL_NEON)
+				for(; i + 4 <= aCount; i += 4) {
+					vst1_u16(reinterpret_cast<uint16_t*>(aDst + i), vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(aSrc + i))));
+				}
+#elif defined(ASMITH_GL_F16C)
+				for(; i + 8 <= aCount; i += 8) {
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(aDst + i), _mm256_cvtps_ph(_mm256_loadu_ps(aSrc + i), _MM_FROUND_TO_NEAREST_INT));
+				}
+				for(; i + 4 <= aCount; i += 4) {
+					_mm_storel_epi64(reinterpret_cast<__m128i*>(aDst + i), _mm_cvtps_ph(_mm_loadu_ps(aSrc + i), _MM_FROUND_TO_NEAREST_INT));
+				}
+#endif
+				for(; i < aCount; ++i) aDst[i] = float_to_half(aSrc[i]);
+			}
+
+			static inline void convert_halves(const GLhalf* aSrc, GLfloat* aDst, size_t aCount) throw() {
+				size_t i = 0;
+#if defined(ASMITH_GL_NEON)
+				for(; i + 4 <= aCount; i += 4) {
+					vst1q_f32(aDst + i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(reinterpret_cast<const uint16_t*>(aSrc + i)))));
+				}
+#elif defined(ASMITH_GL_F16C)
+				for(; i + 8 <= aCount; i += 8) {
+					_mm256_storeu_ps(aDst + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(aSrc + i))));
+				}
+				for(; i + 4 <= aCount; i += 4) {
+					_mm_storeu_ps(aDst + i, _mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(aSrc + i))));
+				}
+#endif
+				for(; i < aCount; ++i) aDst[i] = half_to_float(aSrc[i]);
+			}
+		};
+
+		template<class A, class B>
+		struct pixel_converter<A, B, PIXEL_KERNEL_PACK> {
+			typedef packed_layout<A::FORMAT, A::TYPE> layout;
+
+			enum : size_t {
+				SRC_CHANNELS = colour_channels<B>()
+			};
+
+			enum : int {
+				// The memory order lane of B that each packed field is read from, a missing alpha loads as 1
+				RED_LANE = B::RED_CHANNEL,
+				GREEN_LANE = B::GREEN_CHANNEL,
+				BLUE_LANE = B::BLUE_CHANNEL,
+				ALPHA_LANE = B::ALPHA_CHANNEL == -1 ? 3 : B::ALPHA_CHANNEL
+			};
+
+			static inline void convert(const B* aSrc, A* aDst, size_t aCount) throw() {
+				// Four pixels are transposed into one register per channel so that each field is shifted by an
+				// immediate. Clamping, scaling and truncation are the same operations as colour_cast
+				size_t i = 0;
+#if defined(ASMITH_GL_SSE2)
+				const __m128 zero = _mm_setzero_ps();
+				const __m128 one = _mm_set1_ps(1.f);
+				for(; i + 4 <= aCount; i += 4) {
+					__m128 p0 = sse2_pixel<SRC_CHANNELS>::load(aSrc + i);
+					__m128 p1 = sse2_pixel<SRC_CHANNELS>::load(aSrc + i + 1);
+					__m128 p2 = sse2_pixel<SRC_CHANNELS>::load(aSrc + i + 2);
+					__m128 p3 = sse2_pixel<SRC_CHANNELS>::load(aSrc + i + 3);
+					_MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+					const __m128 lanes[4] = { p0, p1, p2, p3 };
+
+					__m128i packed = _mm_or_si128(
+						_mm_or_si128(field<layout::RED_SHIFT>(lanes[RED_LANE], A::MAX_RED, zero, one), field<layout::GREEN_SHIFT>(lanes[GREEN_LANE], A::MAX_GREEN, zero, one)),
+						field<layout::BLUE_SHIFT>(lanes[BLUE_LANE], A::MAX_BLUE, zero, one)
+					);
+					if(A::MAX_ALPHA != 0) packed = _mm_or_si128(packed, field<layout::ALPHA_SHIFT>(lanes[ALPHA_LANE], A::MAX_ALPHA, zero, one));
+
+					if(sizeof(typename A::type) == 4) {
+						_mm_storeu_si128(reinterpret_cast<__m128i*>(aDst + i), packed);
+					}else {
+						// Sign extend the low 16 bits so that the saturating pack keeps them unchanged
+						packed = _mm_srai_epi32(_mm_slli_epi32(packed, 16), 16);
+						_mm_storel_epi64(reinterpret_cast<__m128i*>(aDst + i), _mm_packs_epi32(packed, packed));
+					}
+				}
+#endif
+				convert_pixels_scalar<A, B>(aSrc + i, aDst + i, aCount - i);
+			}
+
+#if defined(ASMITH_GL_SSE2)
+			template<const int SHIFT>
+			static inline __m128i field(const __m128 aValue, const int64_t aMax, const __m128 aZero, const __m128 aOne) throw() {
+				// max returns its second operand for NaN, which clamps NaN to 0 as colour_cast does
+				const __m128 clamped = _mm_min_ps(_mm_max_ps(aValue, aZero), aOne);
+				return _mm_slli_epi32(_mm_cvttps_epi32(_mm_mul_ps(clamped, _mm_set1_ps(static_cast<GLfloat>(aMax)))), SHIFT);
+			}
+#endif
+		};
+
+		template<class A, class B>
+		struct pixel_converter<A, B, PIXEL_KERNEL_UNPACK> {
+			typedef packed_layout<B::FORMAT, B::TYPE> layout;
+
+			enum : size_t {
+				DST_CHANNELS = colour_channels<A>()
+			};
+
+			static inline void convert(const B* aSrc, A* aDst, size_t aCount) throw() {
+				// Each field is divided by its maximum in single precision, the same as colour_cast
+				size_t i = 0;
+#if defined(ASMITH_GL_SSE2)
+				const __m128 one = _mm_set1_ps(1.f);
+				for(; i + 4 <= aCount; i += 4) {
+					__m128i packed;
+					if(sizeof(typename B::type) == 4) {
+						packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(aSrc + i));
+					}else {
+						packed = _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(aSrc + i)), _mm_setzero_si128());
+					}
+
+					__m128 lanes[4];
+					lanes[A::RED_CHANNEL] = field<layout::RED_SHIFT>(packed, B::MAX_RED);
+					lanes[A::GREEN_CHANNEL] = field<layout::GREEN_SHIFT>(packed, B::MAX_GREEN);
+					lanes[A::BLUE_CHANNEL] = field<layout::BLUE_SHIFT>(packed, B::MAX_BLUE);
+					lanes[A::ALPHA_CHANNEL == -1 ? 3 : A::ALPHA_CHANNEL] = B::MAX_ALPHA == 0 ? one : field<layout::ALPHA_SHIFT>(packed, B::MAX_ALPHA);
+					_MM_TRANSPOSE4_PS(lanes[0], lanes[1], lanes[2], lanes[3]);
+
+					sse2_pixel<DST_CHANNELS>::store(aDst + i, lanes[0]);
+					sse2_pixel<DST_CHANNELS>::store(aDst + i + 1, lanes[1]);
+					sse2_pixel<DST_CHANNELS>::store(aDst + i + 2, lanes[2]);
+					sse2_pixel<DST_CHANNELS>::store(aDst + i + 3, lanes[3]);
+				}
+#endif
+				convert_pixels_scalar<A, B>(aSrc + i, aDst + i, aCount - i);
+			}
+
+#if defined(ASMITH_GL_SSE2)
+			template<const int SHIFT>
+			static inline __m128 field(const __m128i aPacked, const int64_t aMax) throw() {
+				const __m128i value = _mm_and_si128(_mm_srli_epi32(aPacked, SHIFT), _mm_set1_epi32(static_cast<int>(aMax)));
+				return _mm_div_ps(_mm_cvtepi32_ps(value), _mm_set1_ps(static_cast<GLfloat>(aMax)));
+			}
+#endif
+		};
+	}
+
+	/*!
+		\brief Convert an array of pixels from one colour type to another
+		\details Produces the same results as calling colour_cast on each pixel. Pairs of RGB, RGBA, BGR and BGRA
+		colours with 8 bit or float channels, float to sRGB encoding, float to and from half float and float to and
+		from the packed normalised types use SSE2, AVX2, F16C or NEON kernels when they are available, other types
+		are converted one pixel at a time. On x86 only pairs where both types have four channels use the 8 bit and
+		float kernel. Float channels are expected to be in the range [0, 1] when converting to integer channels.
+		tests/colour_conversion.cpp checks the results against colour_cast and bench/colour_conversion.cpp
+		measures the throughput of each kernel.
+		\param aSrc The pixels to convert
+		\param aDst The array to write the converted pixels to, must not overlap aSrc
+		\param aCount The number of pixels to convert
+		\author Adam Smith
+		\date Created : 18th October 2026 Modified 18th October 2026
+		\version 1.3
+	*/
+	template<class A, class B>
+	static inline void convert_pixels(const B* aSrc, A* aDst, size_t aCount) throw() {
+		implementation::pixel_converter<A, B>::convert(aSrc, aDst, aCount);
+	}
+
+}}
+
+#endif
\ No newline at end of file
@@ -14,25 +14,43 @@
 #ifndef ASMITH_OPENGL_CONTEXT_STATE_HPP
 #define ASMITH_OPENGL_CONTEXT_STATE_HPP
 
+#include <unordered_map>
 #include "program.hpp"
+#include "program_pipeline.hpp"
 #include "vertex_buffer.hpp"
 #include "light.hpp"
+#include "sampler.hpp"
+#include "texture_units.hpp"
 
 namespace asmith { namespace gl { namespace implementation {
 	
 	/*!
 		\brief
 		\author Adam Smith
-		\date Created : 30th June 2017 Modified 30th June 2017
-		\version 1.0
+		\date Created : 30th June 2017 Modified 18th October 2026
+		\version 1.3
 	*/
 	struct context_state {
 		std::vector<object*> object_list;
 		std::shared_ptr<program> currently_bound_program;
+#ifdef GL_ARB_separate_shader_objects
+		std::shared_ptr<program_pipeline> currently_bound_pipeline;
+		std::unordered_map<program_pipeline::stage_key, std::shared_ptr<program_pipeline>, program_pipeline::stage_key_hash> pipeline_cache;
+#endif
 		std::weak_ptr<vertex_buffer> currently_bound_vbos[14];
+		GLuint currently_bound_vertex_array;
 		std::shared_ptr<light> lights[GL_MAX_LIGHTS];
 		vec4f ambient_scene_colour;
 		bool lighting_enabled;
+#if ASMITH_GL_VERSION_GE(3,3)
+		std::unordered_map<sampler::state, std::shared_ptr<sampler>, sampler::state_hash> sampler_cache;
+		std::vector<std::weak_ptr<sampler>> bound_samplers;
+#endif
+		std::vector<texture_unit> texture_units;
+		gl::texture_units::statistics texture_unit_statistics;
+		uint64_t texture_unit_clock;
+		GLuint active_texture_unit;
+		bool texture_multi_bind;
 
 		context_state();
 	};
@@ -14,6 +14,8 @@
 #ifndef ASMITH_OPENGL_CORE_HPP
 #define ASMITH_OPENGL_CORE_HPP
 
+#include <cstddef>
+#include <cstdint>
 #include "GL/glew.h"
 
 #ifndef ASMITH_GL_VERSION_MAJOR
@@ -28,6 +30,24 @@
 #define ASMITH_GL_VERSION_EQ(major, minor) (ASMITH_GL_VERSION_MAJOR == major && ASMITH_GL_VERSION_MINOR == minor)
 #define ASMITH_GL_VERSION_NEQ(major, minor) (ASMITH_GL_VERSION_MAJOR != major || ASMITH_GL_VERSION_MINOR != minor)
 
+#ifndef ASMITH_GL_NO_SIMD
+	#if defined(__AVX2__)
+		#define ASMITH_GL_AVX2
+	#endif
+	#if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+		#define ASMITH_GL_F16C
+	#endif
+	#if defined(__FMA__) || defined(__ARM_FEATURE_FMA)
+		#define ASMITH_GL_FMA
+	#endif
+	#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		#define ASMITH_GL_SSE2
+	#endif
+	#if (defined(__ARM_NEON) || defined(__ARM_NEON__)) && (defined(__aarch64__) || defined(_M_ARM64))
+		#define ASMITH_GL_NEON
+	#endif
+#endif
+
 #ifdef ASMITH_GL_USE_GLM
 #include "glm/glm.hpp"
 
@@ -77,6 +97,23 @@ namespace asmith { namespace gl {
 		template<> struct enum_to_type_<GL_INT> { typedef GLint type; };
 		template<> struct enum_to_type_<GL_FLOAT> { typedef GLfloat type; };
 		template<> struct enum_to_type_<GL_DOUBLE> { typedef GLdouble type; };
+		template<> struct enum_to_type_<GL_HALF_FLOAT> { typedef GLhalf type; };
+		template<> struct enum_to_type_<GL_UNSIGNED_SHORT_5_6_5> { typedef GLushort type; };
+		template<> struct enum_to_type_<GL_UNSIGNED_SHORT_4_4_4_4> { typedef GLushort type; };
+		template<> struct enum_to_type_<GL_UNSIGNED_SHORT_5_5_5_1> { typedef GLushort type; };
+		template<> struct enum_to_type_<GL_UNSIGNED_INT_10_10_10_2> { typedef GLuint type; };
+		template<> struct enum_to_type_<GL_UNSIGNED_INT_2_10_10_10_REV> { typedef GLuint type; };
+		template<> struct enum_to_type_<GL_UNSIGNED_INT_10F_11F_11F_REV> { typedef GLuint type; };
+
+		static inline uint64_t hash_fnv1a(const void* aData, size_t aBytes, uint64_t aSeed = 14695981039346656037ull) throw() {
+			const uint8_t* bytes = static_cast<const uint8_t*>(aData);
+			uint64_t hash = aSeed;
+			for(size_t i = 0; i < aBytes; ++i) {
+				hash ^= bytes[i];
+				hash *= 1099511628211ull;
+			}
+			return hash;
+		}
 	}
 
 	template<const GLenum T>
@@ -0,0 +1,538 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+#ifndef ASMITH_OPENGL_IMAGE_HPP
+#define ASMITH_OPENGL_IMAGE_HPP
+
+#include <algorithm>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "colour_conversion.hpp"
+#include "thread_pool.hpp"
+
+namespace asmith { namespace gl {
+
+	namespace implementation {
+		void* aligned_allocate(size_t, size_t);
+		void aligned_free(void*) throw();
+	}
+
+	/*!
+		\brief A non-owning rectangle of pixels, where consecutive rows are a fixed number of pixels apart
+		\details C may be const qualified for a read only view. A view of part of an image shares the stride of
+		the image, so it can be uploaded with GL_UNPACK_ROW_LENGTH instead of being copied.
+		\author Adam Smith
+		\date Created : 18th October 2026 Modified 18th October 2026
+		\version 1.0
+	*/
+	template<class C>
+	class image_view {
+	public:
+		typedef typename std::remove_const<C>::type colour_type;
+	private:
+		C* mData;
+		GLsizei mWidth;
+		GLsizei mHeight;
+		size_t mStride;
+	public:
+		image_view() :
+			mData(nullptr),
+			mWidth(0),
+			mHeight(0),
+			mStride(0)
+		{}
+
+		image_view(C* aData, GLsizei aWidth, GLsizei aHeight) :
+			image_view(aData, aWidth, aHeight, static_cast<size_t>(aWidth))
+		{}
+
+		image_view(C* aData, GLsizei aWidth, GLsizei aHeight, size_t aStride) :
+			mData(aData),
+			mWidth(aWidth),
+			mHeight(aHeight),
+			mStride(aStride)
+		{
+			if(aWidth < 0 || aHeight < 0 || aStride < static_cast<size_t>(aWidth)) throw std::runtime_error("asmith::gl::image_view::image_view : Invalid dimensions");
+		}
+
+		template<class C2, typename ENABLE = typename std::enable_if<std::is_same<const C2, C>::value && ! std::is_same<C2, C>::value>::type>
+		image_view(const image_view<C2>& aOther) :
+			mData(aOther.data()),
+			mWidth(aOther.get_width()),
+			mHeight(aOther.get_height()),
+			mStride(aOther.get_stride())
+		{}
+
+		inline C* data() const throw() {
+			return mData;
+		}
+
+		inline GLsizei get_width() const throw() {
+			return mWidth;
+		}
+
+		inline GLsizei get_height() const throw() {
+			return mHeight;
+		}
+
+		inline size_t get_stride() const throw() {
+			return mStride;
+		}
+
+		inline size_t get_row_pitch() const throw() {
+			return mStride * sizeof(C);
+		}
+
+		inline bool is_contiguous() const throw() {
+			return mStride == static_cast<size_t>(mWidth) || mHeight <= 1;
+		}
+
+		inline bool empty() const throw() {
+			return mWidth == 0 || mHeight == 0;
+		}
+
+		inline C* row(GLsizei aY) const throw() {
+			return mData + mStride * static_cast<size_t>(aY);
+		}
+
+		inline C& operator()(GLsizei aX, GLsizei aY) const throw() {
+			return row(aY)[aX];
+		}
+
+		image_view<C> sub_view(GLsizei aX, GLsizei aY, GLsizei aWidth, GLsizei aHeight) const {
+			if(aX < 0 || aY < 0 || aWidth < 0 || aHeight < 0 || aX + aWidth > mWidth || aY + aHeight > mHeight) {
+				throw std::runtime_error("asmith::gl::image_view::sub_view : Rectangle is outside of the view");
+			}
+			return image_view<C>(row(aY) + aX, aWidth, aHeight, mStride);
+		}
+	};
+
+	/*!
+		\brief An owning array of pixels whose rows start on 64 byte boundaries when the pixel size allows it
+		\author Adam Smith
+		\date Created : 18th October 2026 Modified 18th October 2026
+		\version 1.0
+	*/
+	template<class C>
+	class image {
+	public:
+		typedef C colour_type;
+
+		enum : size_t {
+			ALIGNMENT = 64
+		};
+	private:
+		static_assert(std::is_trivially_destructible<C>::value, "asmith::gl::image : Colour type must be trivially destructible");
+
+		C* mData;
+		GLsizei mWidth;
+		GLsizei mHeight;
+		size_t mStride;
+	private:
+		static size_t choose_stride(GLsizei aWidth) throw() {
+			// Pad each row to a whole number of cache lines when the pixels divide them evenly
+			const size_t width = static_cast<size_t>(aWidth);
+			if(ALIGNMENT % sizeof(C) != 0) return width;
+			const size_t pixels = ALIGNMENT / sizeof(C);
+			return ((width + pixels - 1) / pixels) * pixels;
+		}
+
+		void allocate(GLsizei aWidth, GLsizei aHeight) {
+			if(aWidth < 0 || aHeight < 0) throw std::runtime_error("asmith::gl::image::allocate : Invalid dimensions");
+			const size_t stride = choose_stride(aWidth);
+			const size_t count = stride * static_cast<size_t>(aHeight);
+			C* const data = count == 0 ? nullptr : static_cast<C*>(implementation::aligned_allocate(count * sizeof(C), ALIGNMENT));
+			for(size_t i = 0; i < count; ++i) new(data + i) C();
+
+			implementation::aligned_free(mData);
+			mData = data;
+			mWidth = aWidth;
+			mHeight = aHeight;
+			mStride = stride;
+		}
+	public:
+		image() :
+			mData(nullptr),
+			mWidth(0),
+			mHeight(0),
+			mStride(0)
+		{}
+
+		image(GLsizei aWidth, GLsizei aHeight) :
+			image()
+		{
+			allocate(aWidth, aHeight);
+		}
+
+		image(const image_view<const C>& aOther) :
+			image()
+		{
+			allocate(aOther.get_width(), aOther.get_height());
+			for(GLsizei i = 0; i < mHeight; ++i) memcpy(row(i), aOther.row(i), sizeof(C) * static_cast<size_t>(mWidth));
+		}
+
+		image(const image<C>& aOther) :
+			image(aOther.view())
+		{}
+
+		image(image<C>&& aOther) :
+			mData(aOther.mData),
+			mWidth(aOther.mWidth),
+			mHeight(aOther.mHeight),
+			mStride(aOther.mStride)
+		{
+			aOther.mData = nullptr;
+			aOther.mWidth = 0;
+			aOther.mHeight = 0;
+			aOther.mStride = 0;
+		}
+
+		~image() {
+			implementation::aligned_free(mData);
+		}
+
+		image<C>& operator=(const image_view<const C>& aOther) {
+			// Copy before releasing the current pixels in case the view is part of this image
+			image<C> tmp(aOther);
+			return *this = std::move(tmp);
+		}
+
+		image<C>& operator=(const image<C>& aOther) {
+			return *this = aOther.view();
+		}
+
+		image<C>& operator=(image<C>&& aOther) {
+			std::swap(mData, aOther.mData);
+			std::swap(mWidth, aOther.mWidth);
+			std::swap(mHeight, aOther.mHeight);
+			std::swap(mStride, aOther.mStride);
+			return *this;
+		}
+
+		void resize(GLsizei aWidth, GLsizei aHeight) {
+			if(aWidth == mWidth && aHeight == mHeight) return;
+			allocate(aWidth, aHeight);
+		}
+
+		inline C* data() throw() {
+			return mData;
+		}
+
+		inline const C* data() const throw() {
+			return mData;
+		}
+
+		inline GLsizei get_width() const throw() {
+			return mWidth;
+		}
+
+		inline GLsizei get_height() const throw() {
+			return mHeight;
+		}
+
+		inline size_t get_stride() const throw() {
+			return mStride;
+		}
+
+		inline bool empty() const throw() {
+			return mWidth == 0 || mHeight == 0;
+		}
+
+		inline C* row(GLsizei aY) throw() {
+			return mData + mStride * static_cast<size_t>(aY);
+		}
+
+		inline const C* row(GLsizei aY) const throw() {
+			return mData + mStride * static_cast<size_t>(aY);
+		}
+
+		inline C& operator()(GLsizei aX, GLsizei aY) throw() {
+			return row(aY)[aX];
+		}
+
+		inline const C& operator()(GLsizei aX, GLsizei aY) const throw() {
+			return row(aY)[aX];
+		}
+
+		inline image_view<C> view() throw() {
+			return image_view<C>(mData, mWidth, mHeight, mStride);
+		}
+
+		inline image_view<const C> view() const throw() {
+			return image_view<const C>(mData, mWidth, mHeight, mStride);
+		}
+
+		inline operator image_view<C>() throw() {
+			return view();
+		}
+
+		inline operator image_view<const C>() const throw() {
+			return view();
+		}
+
+		inline image_view<C> sub_view(GLsizei aX, GLsizei aY, GLsizei aWidth, GLsizei aHeight) {
+			return view().sub_view(aX, aY, aWidth, aHeight);
+		}
+
+		inline image_view<const C> sub_view(GLsizei aX, GLsizei aY, GLsizei aWidth, GLsizei aHeight) const {
+			return view().sub_view(aX, aY, aWidth, aHeight);
+		}
+	};
+
+	namespace implementation {
+		enum : size_t {
+			// Rows are small, so give each task enough of them to outweigh the cost of scheduling it
+			IMAGE_ROW_GRAIN_PIXELS = 16384
+		};
+
+		static inline size_t image_row_grain(GLsizei aWidth) throw() {
+			const size_t width = aWidth > 0 ? static_cast<size_t>(aWidth) : 1;
+			return width >= IMAGE_ROW_GRAIN_PIXELS ? 1 : IMAGE_ROW_GRAIN_PIXELS / width;
+		}
+
+		template<class A, class B>
+		static inline void check_image_sizes(const image_view<A>& aDst, const image_view<B>& aSrc, const char* const aMessage) {
+			if(aDst.get_width() != aSrc.get_width() || aDst.get_height() != aSrc.get_height()) throw std::runtime_error(aMessage);
+		}
+
+		static inline void premultiply_rgba_8u(uint8_t* aPixels, size_t aCount) throw() {
+			// Rounds c * a / 255 exactly, alpha is the last byte of RGBA and BGRA
+			size_t i = 0;
+#if defined(ASMITH_GL_NEON)
+			for(; i + 16 <= aCount; i += 16) {
+				uint8x16x4_t v = vld4q_u8(aPixels + i * 4);
+				for(int c = 0; c < 3; ++c) {
+					const uint16x8_t lo = vmull_u8(vget_low_u8(v.val[c]), vget_low_u8(v.val[3]));
+					const uint16x8_t hi = vmull_u8(vget_high_u8(v.val[c]), vget_high_u8(v.val[3]));
+					v.val[c] = vcombine_u8(vraddhn_u16(lo, vrshrq_n_u16(lo, 8)), vraddhn_u16(hi, vrshrq_n_u16(hi, 8)));
+				}
+				vst4q_u8(aPixels + i * 4, v);
+			}
+#elif defined(ASMITH_GL_SSE2)
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i bias = _mm_set1_epi16(128);
+			const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+			for(; i + 4 <= aCount; i += 4) {
+				__m128i* const ptr = reinterpret_cast<__m128i*>(aPixels + i * 4);
+				const __m128i v = _mm_loadu_si128(ptr);
+				__m128i lo = _mm_unpacklo_epi8(v, zero);
+				__m128i hi = _mm_unpackhi_epi8(v, zero);
+				const __m128i alphaLo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, 0xFF), 0xFF);
+				const __m128i alphaHi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, 0xFF), 0xFF);
+				lo = _mm_add_epi16(_mm_mullo_epi16(lo, alphaLo), bias);
+				hi = _mm_add_epi16(_mm_mullo_epi16(hi, alphaHi), bias);
+				lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+				hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+				const __m128i result = _mm_packus_epi16(lo, hi);
+				_mm_storeu_si128(ptr, _mm_or_si128(_mm_and_si128(v, alphaMask), _mm_andnot_si128(alphaMask, result)));
+			}
+#endif
+			for(; i < aCount; ++i) {
+				uint8_t* const p = aPixels + i * 4;
+				for(int c = 0; c < 3; ++c) {
+					const uint32_t t = static_cast<uint32_t>(p[c]) * p[3] + 128u;
+					p[c] = static_cast<uint8_t>((t + (t >> 8)) >> 8);
+				}
+			}
+		}
+
+		static inline void premultiply_rgba_f(colour_rgba_f* aPixels, size_t aCount) throw() {
+			for(size_t i = 0; i < aCount; ++i) {
+				colour_rgba_f& p = aPixels[i];
+				p.r *= p.a;
+				p.g *= p.a;
+				p.b *= p.a;
+			}
+		}
+	}
+
+	/*!
+		\brief Convert every pixel of one view into another of the same size with convert_pixels
+		\param aSrc The pixels to convert
+		\param aDst Where to write the converted pixels, must not overlap aSrc
+		\param aPool The threads that rows are divided between
+	*/
+	template<class A, class B>
+	static inline void convert(const image_view<B>& aSrc, const image_view<A>& aDst, thread_pool& aPool = thread_pool::get_default()) {
+		typedef typename std::remove_const<B>::type src_type;
+		typedef typename image_view<A>::colour_type dst_type;
+		static_assert(! std::is_const<A>::value, "asmith::gl::convert : Destination view must not be const");
+		implementation::check_image_sizes(aDst, aSrc, "asmith::gl::convert : Images have different sizes");
+
+		const size_t width = static_cast<size_t>(aSrc.get_width());
+		aPool.parallel_for(0, static_cast<size_t>(aSrc.get_height()), implementation::image_row_grain(aSrc.get_width()), [&](size_t aBegin, size_t aEnd) {
+			for(size_t y = aBegin; y < aEnd; ++y) {
+				const GLsizei i = static_cast<GLsizei>(y);
+				convert_pixels<dst_type, src_type>(aSrc.row(i), aDst.row(i), width);
+			}
+		});
+	}
+
+	/*!
+		\brief Write aFunction(pixel) of every pixel in one view to the same position in another view
+		\param aFunction Called with a const reference to a source pixel, returns the destination pixel. It is
+		called from several threads at once.
+	*/
+	template<class A, class B, class F>
+	static inline void transform(const image_view<B>& aSrc, const image_view<A>& aDst, F aFunction, thread_pool& aPool = thread_pool::get_default()) {
+		static_assert(! std::is_const<A>::value, "asmith::gl::transform : Destination view must not be const");
+		implementation::check_image_sizes(aDst, aSrc, "asmith::gl::transform : Images have different sizes");
+
+		const GLsizei width = aSrc.get_width();
+		aPool.parallel_for(0, static_cast<size_t>(aSrc.get_height()), implementation::image_row_grain(width), [&](size_t aBegin, size_t aEnd) {
+			for(size_t y = aBegin; y < aEnd; ++y) {
+				const B* const src = aSrc.row(static_cast<GLsizei>(y));
+				A* const dst = aDst.row(static_cast<GLsizei>(y));
+				for(GLsizei x = 0; x < width; ++x) dst[x] = aFunction(src[x]);
+			}
+		});
+	}
+
+	/*!
+		\brief Resample one view to the size of another with bilinear filtering
+		\details Filtering happens on normalised floats, so sRGB images are filtered in linear space. Reductions to
+		less than half of the size skip source pixels, generate mipmaps instead for those.
+	*/
+	template<class A, class B>
+	static inline void resize(const image_view<B>& aSrc, const image_view<A>& aDst, thread_pool& aPool = thread_pool::get_default()) {
+		typedef typename std::remove_const<B>::type src_type;
+		typedef typename image_view<A>::colour_type dst_type;
+		static_assert(! std::is_const<A>::value, "asmith::gl::resize : Destination view must not be const");
+		if(aDst.empty()) return;
+		if(aSrc.empty()) throw std::runtime_error("asmith::gl::resize : Source image is empty");
+
+		const GLsizei srcWidth = aSrc.get_width();
+		const GLsizei srcHeight = aSrc.get_height();
+		const GLsizei dstWidth = aDst.get_width();
+
+		// Horizontal sample positions are the same for every row
+		std::vector<GLsizei> x0(static_cast<size_t>(dstWidth));
+		std::vector<GLsizei> x1(static_cast<size_t>(dstWidth));
+		std::vector<GLfloat> wx(static_cast<size_t>(dstWidth));
+		const GLfloat scaleX = static_cast<GLfloat>(srcWidth) / static_cast<GLfloat>(dstWidth);
+		for(GLsizei x = 0; x < dstWidth; ++x) {
+			GLfloat s = (static_cast<GLfloat>(x) + 0.5f) * scaleX - 0.5f;
+			s = std::min(std::max(s, 0.f), static_cast<GLfloat>(srcWidth - 1));
+			const GLsizei i = static_cast<GLsizei>(s);
+			x0[x] = i;
+			x1[x] = std::min(i + 1, srcWidth - 1);
+			wx[x] = s - static_cast<GLfloat>(i);
+		}
+		const GLfloat scaleY = static_cast<GLfloat>(srcHeight) / static_cast<GLfloat>(aDst.get_height());
+
+		aPool.parallel_for(0, static_cast<size_t>(aDst.get_height()), implementation::image_row_grain(srcWidth), [&](size_t aBegin, size_t aEnd) {
+			std::vector<colour_rgba_f> rows[2] = {
+				std::vector<colour_rgba_f>(static_cast<size_t>(srcWidth)),
+				std::vector<colour_rgba_f>(static_cast<size_t>(srcWidth))
+			};
+			GLsizei loaded[2] = { -1, -1 };
+			std::vector<colour_rgba_f> blended(static_cast<size_t>(srcWidth));
+			std::vector<colour_rgba_f> out(static_cast<size_t>(dstWidth));
+
+			for(size_t y = aBegin; y < aEnd; ++y) {
+				GLfloat s = (static_cast<GLfloat>(y) + 0.5f) * scaleY - 0.5f;
+				s = std::min(std::max(s, 0.f), static_cast<GLfloat>(srcHeight - 1));
+				const GLsizei sy[2] = { static_cast<GLsizei>(s), std::min(static_cast<GLsizei>(s) + 1, srcHeight - 1) };
+				const GLfloat wy = s - static_cast<GLfloat>(sy[0]);
+
+				// Neighbouring rows usually sample the same source rows, so only convert rows that changed
+				for(int i = 0; i < 2; ++i) {
+					if(loaded[0] == sy[i] || loaded[1] == sy[i]) continue;
+					const int slot = loaded[0] == sy[0] || loaded[0] == sy[1] ? 1 : 0;
+					convert_pixels<colour_rgba_f, src_type>(aSrc.row(sy[i]), &rows[slot][0], rows[slot].size());
+					loaded[slot] = sy[i];
+				}
+				const GLfloat* const r0 = &rows[loaded[0] == sy[0] ? 0 : 1][0].r;
+				const GLfloat* const r1 = &rows[loaded[0] == sy[1] ? 0 : 1][0].r;
+				GLfloat* const b = &blended[0].r;
+				const size_t count = static_cast<size_t>(srcWidth) * 4;
+				for(size_t i = 0; i < count; ++i) b[i] = r0[i] + (r1[i] - r0[i]) * wy;
+
+				for(GLsizei x = 0; x < dstWidth; ++x) {
+					const GLfloat* const p0 = &blended[x0[x]].r;
+					const GLfloat* const p1 = &blended[x1[x]].r;
+					GLfloat* const o = &out[x].r;
+					for(int c = 0; c < 4; ++c) o[c] = p0[c] + (p1[c] - p0[c]) * wx[x];
+				}
+				convert_pixels<dst_type, colour_rgba_f>(&out[0], aDst.row(static_cast<GLsizei>(y)), out.size());
+			}
+		});
+	}
+
+	/*!
+		\brief Reverse the order of the rows of a view, for example to convert between top-down image files and
+		OpenGL, which starts at the bottom row
+	*/
+	template<class C>
+	static inline void flip_vertical(const image_view<C>& aImage, thread_pool& aPool = thread_pool::get_default()) {
+		static_assert(! std::is_const<C>::value, "asmith::gl::flip_vertical : View must not be const");
+		const GLsizei height = aImage.get_height();
+		const size_t width = static_cast<size_t>(aImage.get_width());
+		aPool.parallel_for(0, static_cast<size_t>(height / 2), implementation::image_row_grain(aImage.get_width()), [&](size_t aBegin, size_t aEnd) {
+			for(size_t y = aBegin; y < aEnd; ++y) {
+				C* const top = aImage.row(static_cast<GLsizei>(y));
+				std::swap_ranges(top, top + width, aImage.row(height - 1 - static_cast<GLsizei>(y)));
+			}
+		});
+	}
+
+	/*!
+		\brief Reverse the order of the pixels in every row of a view
+	*/
+	template<class C>
+	static inline void flip_horizontal(const image_view<C>& aImage, thread_pool& aPool = thread_pool::get_default()) {
+		static_assert(! std::is_const<C>::value, "asmith::gl::flip_horizontal : View must not be const");
+		const size_t width = static_cast<size_t>(aImage.get_width());
+		aPool.parallel_for(0, static_cast<size_t>(aImage.get_height()), implementation::image_row_grain(aImage.get_width()), [&](size_t aBegin, size_t aEnd) {
+			for(size_t y = aBegin; y < aEnd; ++y) {
+				C* const row = aImage.row(static_cast<GLsizei>(y));
+				std::reverse(row, row + width);
+			}
+		});
+	}
+
+	/*!
+		\brief Multiply the colour channels of every pixel by its alpha
+		\details Linear 8 bit RGBA and BGRA images are rounded to the nearest value with integer SIMD, other
+		types are converted to normalised floats and back. Images without alpha are not changed.
+	*/
+	template<class C>
+	static inline void premultiply_alpha(const image_view<C>& aImage, thread_pool& aPool = thread_pool::get_default()) {
+		static_assert(! std::is_const<C>::value, "asmith::gl::premultiply_alpha : View must not be const");
+		if(C::MAX_ALPHA == 0) return;
+
+		enum : bool {
+			INTEGER = C::TYPE == GL_UNSIGNED_BYTE && C::ALPHA_CHANNEL == 3 && ! is_srgb_colour<C>::value
+		};
+
+		const size_t width = static_cast<size_t>(aImage.get_width());
+		aPool.parallel_for(0, static_cast<size_t>(aImage.get_height()), implementation::image_row_grain(aImage.get_width()), [&](size_t aBegin, size_t aEnd) {
+			std::vector<colour_rgba_f> tmp(INTEGER ? 0 : width);
+			for(size_t y = aBegin; y < aEnd; ++y) {
+				C* const row = aImage.row(static_cast<GLsizei>(y));
+				if(INTEGER) {
+					implementation::premultiply_rgba_8u(reinterpret_cast<uint8_t*>(row), width);
+				}else {
+					convert_pixels<colour_rgba_f, C>(row, &tmp[0], width);
+					implementation::premultiply_rgba_f(&tmp[0], width);
+					convert_pixels<C, colour_rgba_f>(&tmp[0], row, width);
+				}
+			}
+		});
+	}
+
+}}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,106 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+#ifndef ASMITH_OPENGL_INSTANCE_COLLECTOR_HPP
+#define ASMITH_OPENGL_INSTANCE_COLLECTOR_HPP
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "render_queue.hpp"
+
+#if ASMITH_GL_VERSION_GE(3,3)
+namespace asmith { namespace gl {
+
+	/*!
+		\brief Turns draws of the same mesh with the same material into one instanced draw
+		\details Draws added during a frame are grouped by material, vertex array and draw range. submit packs
+		the transform and colour of every draw into one instance buffer, ordered by group, and submits one
+		instanced packet per group to a render_queue.
+
+		The first time a vertex array is seen, the instance attributes are appended to it : the four columns
+		of the transform at the first attribute given to the constructor, followed by the colour. The vertex
+		array must already have exactly that many attributes and must be owned by a std::shared_ptr.
+		Instances of a translucent group are not sorted by depth.
+
+		submit may be called more than once before the queue is executed, the instances of each call are
+		appended after those of the previous calls. The buffer is only respecified once the queue has been
+		executed or cleared, or when the instances are submitted to a different queue, so a collector must not
+		feed two queues that are waiting to be executed at the same time.
+		\author Adam Smith
+		\date Created : 18th October 2026 Modified 18th October 2026
+		\version 1.1
+	*/
+	class instance_collector {
+	public:
+		struct instance {
+			mat4 transform;
+			vec4f colour;
+		};
+
+		struct statistics {
+			size_t frames;
+			size_t draws;
+			size_t instanced_draws;
+			size_t bytes_uploaded;
+		};
+	private:
+		struct group {
+			render_queue::packet packet;
+			GLuint count;
+			GLuint base;
+		};
+
+		context& mContext;
+		GLuint mFirstAttribute;
+		std::shared_ptr<vertex_buffer> mBuffer;
+		size_t mCapacity;
+		std::vector<group> mGroups;
+		std::unordered_multimap<uint64_t, uint32_t> mGroupIndex;
+		std::vector<instance> mInstances;
+		std::vector<uint32_t> mInstanceGroups;
+		std::vector<instance> mPacked;
+		std::vector<GLuint> mCursors;
+		const render_queue* mQueue;
+		size_t mQueueGeneration;
+		std::unordered_map<const vertex_array*, std::weak_ptr<object>> mPrepared;
+		statistics mStatistics;
+	private:
+		instance_collector(const instance_collector&) = delete;
+		instance_collector(instance_collector&&) = delete;
+		instance_collector& operator=(const instance_collector&) = delete;
+		instance_collector& operator=(instance_collector&&) = delete;
+
+		void prepare(vertex_array&);
+	public:
+		instance_collector(context&, GLuint);
+		~instance_collector();
+
+		GLuint get_first_attribute() const throw();
+
+		void add(const render_queue::packet&, const mat4&, const vec4f&);
+		size_t size() const throw();
+		void clear() throw();
+		void submit(render_queue&);
+
+		statistics get_statistics() const throw();
+		void reset_statistics() throw();
+
+		//! The average number of draws that each instanced draw replaced
+		double get_collapse_ratio() const throw();
+	};
+
+}}
+#endif
+
+#endif
\ No newline at end of file
@@ -21,9 +21,12 @@ namespace asmith { namespace gl {
 	
 	/*!
 		\brief Wrapper class for OpenGL lighting
+		\details Fixed function lighting is limited to GL_MAX_LIGHTS, see light_set for shaders that use more lights.
+		enable sends the position and spot direction again every time, because GL transforms them by the modelview
+		matrix that is current when they are sent. The other parameters are only sent again by their setters.
 		\author Adam Smith
-		\date Created : 26th June 2017 Modified 26th June 2017
-		\version 1.0
+		\date Created : 26th June 2017 Modified 18th October 2026
+		\version 1.1
 	*/
 	class light : public std::enable_shared_from_this<light> {
 	private:
@@ -40,6 +43,7 @@ namespace asmith { namespace gl {
 		GLint mCutoff;
 		const GLenum mID;
 		bool mEnabled;
+		bool mSynchronised;
 	private:
 		light(const light&) = delete;
 		light(light&&) = delete;
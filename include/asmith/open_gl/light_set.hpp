@@ -0,0 +1,135 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+#ifndef ASMITH_OPENGL_LIGHT_SET_HPP
+#define ASMITH_OPENGL_LIGHT_SET_HPP
+
+#include <vector>
+#include "light.hpp"
+#include "program.hpp"
+#include "vertex_buffer.hpp"
+
+#if ASMITH_GL_VERSION_GE(4,3)
+namespace asmith { namespace gl {
+
+	/*!
+		\brief Any number of lights, stored in a shader storage buffer instead of the fixed function light state
+		\details The lights are packed with no gaps, so a shader can loop over the first count elements :
+		\code
+		struct light_data {
+			vec4 position;
+			vec4 ambient;
+			vec4 diffuse;
+			vec4 specular;
+			vec3 spot_direction;
+			float spot_exponent;
+			vec3 attenuation;
+			float spot_cos_cutoff;
+		};
+		layout(std430, binding = 0) readonly buffer lights {
+			uint light_count;
+			light_data light_array[];
+		};
+		\endcode
+		Removing a light moves the last light into its place, so a light is identified by a handle rather than by
+		its position in the buffer. Only the lights that changed since the last upload are sent, lights that are
+		close together in the buffer are sent with one call.
+		\author Adam Smith
+		\date Created : 18th October 2026 Modified 18th October 2026
+		\version 1.0
+	*/
+	class light_set {
+	public:
+		typedef uint32_t handle;
+
+		enum : handle {
+			INVALID_HANDLE = UINT32_MAX
+		};
+
+		//! The std430 layout of one light, w of position is 0 for a directional light
+		struct light_data {
+			vec4f position;
+			vec4f ambient;
+			vec4f diffuse;
+			vec4f specular;
+			vec3f spot_direction;
+			GLfloat spot_exponent;
+			vec3f attenuation;
+			GLfloat spot_cos_cutoff;
+		};
+
+		struct statistics {
+			size_t uploads;
+			size_t ranges_uploaded;
+			size_t bytes_uploaded;
+		};
+	private:
+		struct header {
+			GLuint count;
+			GLuint padding[3];
+		};
+
+		context& mContext;
+		std::shared_ptr<vertex_buffer> mBuffer;
+		std::vector<light_data> mLights;
+		std::vector<handle> mHandles;
+		std::vector<uint32_t> mIndices;
+		std::vector<handle> mFreeHandles;
+		std::vector<uint8_t> mDirty;
+		std::vector<uint32_t> mDirtyIndices;
+		GLuint mBinding;
+		bool mCountChanged;
+		statistics mStatistics;
+	private:
+		light_set(const light_set&) = delete;
+		light_set(light_set&&) = delete;
+		light_set& operator=(const light_set&) = delete;
+		light_set& operator=(light_set&&) = delete;
+
+		uint32_t get_index(handle, const char*) const;
+		void mark_dirty(uint32_t) throw();
+	public:
+		static bool is_supported() throw();
+		static light_data convert(const light&) throw();
+
+		light_set(context&, GLuint);
+		~light_set();
+
+		handle add(const light_data&);
+		handle add(const light&);
+		void remove(handle);
+		void clear() throw();
+		bool is_valid(handle) const throw();
+		size_t size() const throw();
+		void reserve(size_t);
+
+		const light_data& get(handle) const;
+		light_data& edit(handle);
+		void set(handle, const light_data&);
+
+		/*!
+			\brief Point the storage block of a linked program at the binding of this set
+		*/
+		void attach(program&, const GLchar*);
+		void upload();
+		void bind();
+		GLuint get_binding() const throw();
+
+		statistics get_statistics() const throw();
+		void reset_statistics() throw();
+	};
+
+}}
+#endif
+
+#endif
\ No newline at end of file
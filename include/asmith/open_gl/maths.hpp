@@ -0,0 +1,550 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+#ifndef ASMITH_OPENGL_MATHS_HPP
+#define ASMITH_OPENGL_MATHS_HPP
+
+#include <cmath>
+#include <cstring>
+#include "core.hpp"
+
+#if defined(ASMITH_GL_AVX2)
+	#include <immintrin.h>
+#elif defined(ASMITH_GL_SSE2)
+	#include <emmintrin.h>
+#endif
+#if defined(ASMITH_GL_NEON)
+	#include <arm_neon.h>
+#endif
+
+namespace asmith { namespace gl {
+
+	namespace implementation {
+#if defined(ASMITH_GL_NEON)
+		typedef float32x4_t simd_float4;
+
+		static inline simd_float4 simd_load(const GLfloat* aSrc) throw() { return vld1q_f32(aSrc); }
+		static inline void simd_store(GLfloat* aDst, simd_float4 a) throw() { vst1q_f32(aDst, a); }
+		static inline simd_float4 simd_set(GLfloat a) throw() { return vdupq_n_f32(a); }
+		static inline simd_float4 simd_add(simd_float4 a, simd_float4 b) throw() { return vaddq_f32(a, b); }
+		static inline simd_float4 simd_sub(simd_float4 a, simd_float4 b) throw() { return vsubq_f32(a, b); }
+		static inline simd_float4 simd_mul(simd_float4 a, simd_float4 b) throw() { return vmulq_f32(a, b); }
+		static inline simd_float4 simd_madd(simd_float4 a, simd_float4 b, simd_float4 c) throw() { return vfmaq_f32(c, a, b); }
+		static inline GLfloat simd_sum(simd_float4 a) throw() { return vaddvq_f32(a); }
+		template<int L> static inline simd_float4 simd_splat(simd_float4 a) throw() { return vdupq_laneq_f32(a, L); }
+
+		static inline void simd_load3x4(const GLfloat* aSrc, simd_float4& x, simd_float4& y, simd_float4& z) throw() {
+			const float32x4x3_t v = vld3q_f32(aSrc);
+			x = v.val[0];
+			y = v.val[1];
+			z = v.val[2];
+		}
+
+		static inline void simd_store3x4(GLfloat* aDst, simd_float4 x, simd_float4 y, simd_float4 z) throw() {
+			float32x4x3_t v;
+			v.val[0] = x;
+			v.val[1] = y;
+			v.val[2] = z;
+			vst3q_f32(aDst, v);
+		}
+#elif defined(ASMITH_GL_SSE2)
+		typedef __m128 simd_float4;
+
+		static inline simd_float4 simd_load(const GLfloat* aSrc) throw() { return _mm_loadu_ps(aSrc); }
+		static inline void simd_store(GLfloat* aDst, simd_float4 a) throw() { _mm_storeu_ps(aDst, a); }
+		static inline simd_float4 simd_set(GLfloat a) throw() { return _mm_set1_ps(a); }
+		static inline simd_float4 simd_add(simd_float4 a, simd_float4 b) throw() { return _mm_add_ps(a, b); }
+		static inline simd_float4 simd_sub(simd_float4 a, simd_float4 b) throw() { return _mm_sub_ps(a, b); }
+		static inline simd_float4 simd_mul(simd_float4 a, simd_float4 b) throw() { return _mm_mul_ps(a, b); }
+		static inline simd_float4 simd_madd(simd_float4 a, simd_float4 b, simd_float4 c) throw() { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+		static inline GLfloat simd_sum(simd_float4 a) throw() {
+			const simd_float4 b = _mm_add_ps(a, _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)));
+			return _mm_cvtss_f32(_mm_add_ps(b, _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2))));
+		}
+		template<int L> static inline simd_float4 simd_splat(simd_float4 a) throw() { return _mm_shuffle_ps(a, a, _MM_SHUFFLE(L, L, L, L)); }
+
+		// Loads four xyz triples and returns the x, y and z of all four in their own register
+		static inline void simd_load3x4(const GLfloat* aSrc, simd_float4& x, simd_float4& y, simd_float4& z) throw() {
+			const simd_float4 a = _mm_loadu_ps(aSrc);		// x0 y0 z0 x1
+			const simd_float4 b = _mm_loadu_ps(aSrc + 4);	// y1 z1 x2 y2
+			const simd_float4 c = _mm_loadu_ps(aSrc + 8);	// z2 x3 y3 z3
+			x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 0, 3, 2)), _MM_SHUFFLE(3, 0, 3, 0));
+			y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+			z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+		}
+
+		static inline void simd_store3x4(GLfloat* aDst, simd_float4 x, simd_float4 y, simd_float4 z) throw() {
+			const simd_float4 a = _mm_shuffle_ps(_mm_unpacklo_ps(x, y), _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 1, 0));
+			const simd_float4 b = _mm_shuffle_ps(_mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0));
+			const simd_float4 c = _mm_shuffle_ps(_mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)), _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+			_mm_storeu_ps(aDst, a);
+			_mm_storeu_ps(aDst + 4, b);
+			_mm_storeu_ps(aDst + 8, c);
+		}
+#else
+		struct simd_float4 {
+			GLfloat v[4];
+		};
+
+		static inline simd_float4 simd_load(const GLfloat* aSrc) throw() { return simd_float4{{ aSrc[0], aSrc[1], aSrc[2], aSrc[3] }}; }
+		static inline void simd_store(GLfloat* aDst, simd_float4 a) throw() { for(int i = 0; i < 4; ++i) aDst[i] = a.v[i]; }
+		static inline simd_float4 simd_set(GLfloat a) throw() { return simd_float4{{ a, a, a, a }}; }
+		static inline simd_float4 simd_add(simd_float4 a, simd_float4 b) throw() { for(int i = 0; i < 4; ++i) a.v[i] += b.v[i]; return a; }
+		static inline simd_float4 simd_sub(simd_float4 a, simd_float4 b) throw() { for(int i = 0; i < 4; ++i) a.v[i] -= b.v[i]; return a; }
+		static inline simd_float4 simd_mul(simd_float4 a, simd_float4 b) throw() { for(int i = 0; i < 4; ++i) a.v[i] *= b.v[i]; return a; }
+		static inline simd_float4 simd_madd(simd_float4 a, simd_float4 b, simd_float4 c) throw() { for(int i = 0; i < 4; ++i) c.v[i] += a.v[i] * b.v[i]; return c; }
+		static inline GLfloat simd_sum(simd_float4 a) throw() { return (a.v[0] + a.v[1]) + (a.v[2] + a.v[3]); }
+		template<int L> static inline simd_float4 simd_splat(simd_float4 a) throw() { return simd_set(a.v[L]); }
+
+		static inline void simd_load3x4(const GLfloat* aSrc, simd_float4& x, simd_float4& y, simd_float4& z) throw() {
+			for(int i = 0; i < 4; ++i) {
+				x.v[i] = aSrc[i * 3];
+				y.v[i] = aSrc[i * 3 + 1];
+				z.v[i] = aSrc[i * 3 + 2];
+			}
+		}
+
+		static inline void simd_store3x4(GLfloat* aDst, simd_float4 x, simd_float4 y, simd_float4 z) throw() {
+			for(int i = 0; i < 4; ++i) {
+				aDst[i * 3] = x.v[i];
+				aDst[i * 3 + 1] = y.v[i];
+				aDst[i * 3 + 2] = z.v[i];
+			}
+		}
+#endif
+	}
+
+	/*!
+		\brief A three component vector with the layout of vec3f
+		\author Adam Smith
+		\date Created : 18th October 2026 Modified 18th October 2026
+		\version 1.0
+	*/
+	struct vector3 {
+		GLfloat x;
+		GLfloat y;
+		GLfloat z;
+
+		static inline vector3 load(const vec3f& aVector) throw() {
+			vector3 tmp;
+			std::memcpy(&tmp, &aVector, sizeof(vector3));
+			return tmp;
+		}
+
+		inline const vec3f& as_gl() const throw() { return reinterpret_cast<const vec3f&>(*this); }
+		inline vec3f& as_gl() throw() { return reinterpret_cast<vec3f&>(*this); }
+
+		inline vector3 operator+(const vector3& aOther) const throw() { return vector3{ x + aOther.x, y + aOther.y, z + aOther.z }; }
+		inline vector3 operator-(const vector3& aOther) const throw() { return vector3{ x - aOther.x, y - aOther.y, z - aOther.z }; }
+		inline vector3 operator*(GLfloat aScale) const throw() { return vector3{ x * aScale, y * aScale, z * aScale }; }
+		inline vector3 operator-() const throw() { return vector3{ -x, -y, -z }; }
+
+		inline GLfloat dot(const vector3& aOther) const throw() { return x * aOther.x + y * aOther.y + z * aOther.z; }
+		inline vector3 cross(const vector3& aOther) const throw() { return vector3{ y * aOther.z - z * aOther.y, z * aOther.x - x * aOther.z, x * aOther.y - y * aOther.x }; }
+		inline GLfloat length() const throw() { return std::sqrt(dot(*this)); }
+
+		inline vector3 normalise() const throw() {
+			const GLfloat l = length();
+			return l > 0.f ? *this * (1.f / l) : *this;
+		}
+	};
+
+	/*!
+		\brief A four component vector with the layout of vec4f, aligned for SIMD
+		\author Adam Smith
+		\date Created : 18th October 2026 Modified 18th October 2026
+		\version 1.0
+	*/
+	struct alignas(16) vector4 {
+		GLfloat x;
+		GLfloat y;
+		GLfloat z;
+		GLfloat w;
+
+		static inline vector4 load(const vec4f& aVector) throw() {
+			vector4 tmp;
+			std::memcpy(&tmp, &aVector, sizeof(vector4));
+			return tmp;
+		}
+
+		static inline vector4 from_simd(implementation::simd_float4 aValue) throw() {
+			vector4 tmp;
+			implementation::simd_store(&tmp.x, aValue);
+			return tmp;
+		}
+
+		inline implementation::simd_float4 to_simd() const throw() { return implementation::simd_load(&x); }
+		inline const vec4f& as_gl() const throw() { return reinterpret_cast<const vec4f&>(*this); }
+		inline vec4f& as_gl() throw() { return reinterpret_cast<vec4f&>(*this); }
+
+		inline vector4 operator+(const vector4& aOther) const throw() { return from_simd(implementation::simd_add(to_simd(), aOther.to_simd())); }
+		inline vector4 operator-(const vector4& aOther) const throw() { return from_simd(implementation::simd_sub(to_simd(), aOther.to_simd())); }
+		inline vector4 operator*(const vector4& aOther) const throw() { return from_simd(implementation::simd_mul(to_simd(), aOther.to_simd())); }
+		inline vector4 operator*(GLfloat aScale) const throw() { return from_simd(implementation::simd_mul(to_simd(), implementation::simd_set(aScale))); }
+
+		inline GLfloat dot(const vector4& aOther) const throw() { return implementation::simd_sum(implementation::simd_mul(to_simd(), aOther.to_simd())); }
+		inline GLfloat length() const throw() { return std::sqrt(dot(*this)); }
+	};
+
+	/*!
+		\brief A rotation stored as a unit quaternion, w is the real part
+		\author Adam Smith
+		\date Created : 18th October 2026 Modified 18th October 2026
+		\version 1.0
+	*/
+	struct alignas(16) quaternion {
+		GLfloat x;
+		GLfloat y;
+		GLfloat z;
+		GLfloat w;
+
+		static inline quaternion identity() throw() { return quaternion{ 0.f, 0.f, 0.f, 1.f }; }
+
+		static inline quaternion from_axis_angle(const vector3& aAxis, GLfloat aRadians) throw() {
+			const vector3 axis = aAxis.normalise();
+			const GLfloat s = std::sin(aRadians * 0.5f);
+			return quaternion{ axis.x * s, axis.y * s, axis.z * s, std::cos(aRadians * 0.5f) };
+		}
+
+		inline quaternion operator*(const quaternion& b) const throw() {
+			return quaternion{
+				w * b.x + x * b.w + y * b.z - z * b.y,
+				w * b.y - x * b.z + y * b.w + z * b.x,
+				w * b.z + x * b.y - y * b.x + z * b.w,
+				w * b.w - x * b.x - y * b.y - z * b.z
+			};
+		}
+
+		inline quaternion conjugate() const throw() { return quaternion{ -x, -y, -z, w }; }
+		inline GLfloat dot(const quaternion& aOther) const throw() { return x * aOther.x + y * aOther.y + z * aOther.z + w * aOther.w; }
+
+		inline quaternion normalise() const throw() {
+			const GLfloat l = std::sqrt(dot(*this));
+			if(l <= 0.f) return identity();
+			const GLfloat s = 1.f / l;
+			return quaternion{ x * s, y * s, z * s, w * s };
+		}
+
+		inline vector3 rotate(const vector3& aVector) const throw() {
+			// v + 2w(q x v) + 2q x (q x v)
+			const vector3 q{ x, y, z };
+			const vector3 t = q.cross(aVector) * 2.f;
+			return aVector + t * w + q.cross(t);
+		}
+
+		static inline quaternion slerp(const quaternion& a, quaternion b, GLfloat aWeight) throw() {
+			GLfloat cosine = a.dot(b);
+			// q and -q are the same rotation, take the shorter path
+			if(cosine < 0.f) {
+				b = quaternion{ -b.x, -b.y, -b.z, -b.w };
+				cosine = -cosine;
+			}
+			GLfloat wa = 1.f - aWeight;
+			GLfloat wb = aWeight;
+			if(cosine < 0.9995f) {
+				const GLfloat angle = std::acos(cosine);
+				const GLfloat s = 1.f / std::sin(angle);
+				wa = std::sin(wa * angle) * s;
+				wb = std::sin(wb * angle) * s;
+			}
+			return quaternion{ a.x * wa + b.x * wb, a.y * wa + b.y * wb, a.z * wa + b.z * wb, a.w * wa + b.w * wb }.normalise();
+		}
+	};
+
+	/*!
+		\brief A column major 4x4 matrix with the layout of mat4, aligned for SIMD
+		\details as_gl gives the matrix to program::set_uniform without a copy.
+		\author Adam Smith
+		\date Created : 18th October 2026 Modified 18th October 2026
+		\version 1.0
+	*/
+	struct alignas(16) matrix4 {
+		GLfloat columns[4][4];
+
+		static inline matrix4 identity() throw() {
+			return matrix4{{
+				{ 1.f, 0.f, 0.f, 0.f },
+				{ 0.f, 1.f, 0.f, 0.f },
+				{ 0.f, 0.f, 1.f, 0.f },
+				{ 0.f, 0.f, 0.f, 1.f }
+			}};
+		}
+
+		static inline matrix4 load(const mat4& aMatrix) throw() {
+			matrix4 tmp;
+			std::memcpy(&tmp, &aMatrix, sizeof(matrix4));
+			return tmp;
+		}
+
+		static inline matrix4 translation(const vector3& aOffset) throw() {
+			matrix4 tmp = identity();
+			tmp.columns[3][0] = aOffset.x;
+			tmp.columns[3][1] = aOffset.y;
+			tmp.columns[3][2] = aOffset.z;
+			return tmp;
+		}
+
+		static inline matrix4 scale(const vector3& aScale) throw() {
+			matrix4 tmp = identity();
+			tmp.columns[0][0] = aScale.x;
+			tmp.columns[1][1] = aScale.y;
+			tmp.columns[2][2] = aScale.z;
+			return tmp;
+		}
+
+		static inline matrix4 rotation(const quaternion& q) throw() {
+			const GLfloat xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+			const GLfloat xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+			const GLfloat wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+			return matrix4{{
+				{ 1.f - 2.f * (yy + zz), 2.f * (xy + wz), 2.f * (xz - wy), 0.f },
+				{ 2.f * (xy - wz), 1.f - 2.f * (xx + zz), 2.f * (yz + wx), 0.f },
+				{ 2.f * (xz + wy), 2.f * (yz - wx), 1.f - 2.f * (xx + yy), 0.f },
+				{ 0.f, 0.f, 0.f, 1.f }
+			}};
+		}
+
+		//! Translation * rotation * scale
+		static inline matrix4 transform(const vector3& aTranslation, const quaternion& aRotation, const vector3& aScale) throw() {
+			matrix4 tmp = rotation(aRotation);
+			for(int i = 0; i < 3; ++i) {
+				tmp.columns[0][i] *= aScale.x;
+				tmp.columns[1][i] *= aScale.y;
+				tmp.columns[2][i] *= aScale.z;
+			}
+			tmp.columns[3][0] = aTranslation.x;
+			tmp.columns[3][1] = aTranslation.y;
+			tmp.columns[3][2] = aTranslation.z;
+			return tmp;
+		}
+
+		//! The same projection as gluPerspective, the field of view is in radians
+		static inline matrix4 perspective(GLfloat aFieldOfView, GLfloat aAspect, GLfloat aNear, GLfloat aFar) throw() {
+			const GLfloat f = 1.f / std::tan(aFieldOfView * 0.5f);
+			const GLfloat d = 1.f / (aNear - aFar);
+			return matrix4{{
+				{ f / aAspect, 0.f, 0.f, 0.f },
+				{ 0.f, f, 0.f, 0.f },
+				{ 0.f, 0.f, (aFar + aNear) * d, -1.f },
+				{ 0.f, 0.f, 2.f * aFar * aNear * d, 0.f }
+			}};
+		}
+
+		//! The same projection as glOrtho
+		static inline matrix4 orthographic(GLfloat aLeft, GLfloat aRight, GLfloat aBottom, GLfloat aTop, GLfloat aNear, GLfloat aFar) throw() {
+			return matrix4{{
+				{ 2.f / (aRight - aLeft), 0.f, 0.f, 0.f },
+				{ 0.f, 2.f / (aTop - aBottom), 0.f, 0.f },
+				{ 0.f, 0.f, -2.f / (aFar - aNear), 0.f },
+				{ -(aRight + aLeft) / (aRight - aLeft), -(aTop + aBottom) / (aTop - aBottom), -(aFar + aNear) / (aFar - aNear), 1.f }
+			}};
+		}
+
+		//! The same view matrix as gluLookAt
+		static inline matrix4 look_at(const vector3& aEye, const vector3& aCentre, const vector3& aUp) throw() {
+			const vector3 f = (aCentre - aEye).normalise();
+			const vector3 s = f.cross(aUp).normalise();
+			const vector3 u = s.cross(f);
+			return matrix4{{
+				{ s.x, u.x, -f.x, 0.f },
+				{ s.y, u.y, -f.y, 0.f },
+				{ s.z, u.z, -f.z, 0.f },
+				{ -s.dot(aEye), -u.dot(aEye), f.dot(aEye), 1.f }
+			}};
+		}
+
+		inline const mat4& as_gl() const throw() { return reinterpret_cast<const mat4&>(*this); }
+		inline mat4& as_gl() throw() { return reinterpret_cast<mat4&>(*this); }
+
+		inline matrix4 operator*(const matrix4& aOther) const throw();
+		inline vector4 operator*(const vector4& aVector) const throw();
+
+		inline vector3 transform_point(const vector3& aPoint) const throw() {
+			return vector3{
+				columns[0][0] * aPoint.x + columns[1][0] * aPoint.y + columns[2][0] * aPoint.z + columns[3][0],
+				columns[0][1] * aPoint.x + columns[1][1] * aPoint.y + columns[2][1] * aPoint.z + columns[3][1],
+				columns[0][2] * aPoint.x + columns[1][2] * aPoint.y + columns[2][2] * aPoint.z + columns[3][2]
+			};
+		}
+
+		inline vector3 transform_direction(const vector3& aDirection) const throw() {
+			return vector3{
+				columns[0][0] * aDirection.x + columns[1][0] * aDirection.y + columns[2][0] * aDirection.z,
+				columns[0][1] * aDirection.x + columns[1][1] * aDirection.y + columns[2][1] * aDirection.z,
+				columns[0][2] * aDirection.x + columns[1][2] * aDirection.y + columns[2][2] * aDirection.z
+			};
+		}
+
+		inline matrix4 transpose() const throw() {
+			matrix4 tmp;
+			for(int i = 0; i < 4; ++i) for(int j = 0; j < 4; ++j) tmp.columns[i][j] = columns[j][i];
+			return tmp;
+		}
+
+		//! Returns false and leaves aOut unchanged if the matrix is singular
+		inline bool invert(matrix4& aOut) const throw() {
+			const GLfloat* m = &columns[0][0];
+			GLfloat inv[16];
+			inv[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] + m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+			inv[4] = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] - m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+			inv[8] = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] + m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+			inv[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] - m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+			inv[1] = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] - m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+			inv[5] = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] + m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+			inv[9] = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] - m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+			inv[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] + m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+			inv[2] = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15] + m[5] * m[3] * m[14] + m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+			inv[6] = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15] - m[4] * m[3] * m[14] - m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+			inv[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15] + m[4] * m[3] * m[13] + m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+			inv[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14] - m[4] * m[2] * m[13] - m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
+			inv[3] = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11] - m[5] * m[3] * m[10] - m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+			inv[7] = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11] + m[4] * m[3] * m[10] + m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+			inv[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11] - m[4] * m[3] * m[9] - m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+			inv[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10] + m[4] * m[2] * m[9] + m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+
+			const GLfloat determinant = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+			if(determinant == 0.f) return false;
+			const GLfloat s = 1.f / determinant;
+			GLfloat* const out = &aOut.columns[0][0];
+			for(int i = 0; i < 16; ++i) out[i] = inv[i] * s;
+			return true;
+		}
+	};
+
+	static_assert(sizeof(vector3) == sizeof(vec3f), "vector3 must have the layout of vec3f");
+	static_assert(sizeof(vector4) == sizeof(vec4f), "vector4 must have the layout of vec4f");
+	static_assert(sizeof(quaternion) == sizeof(vec4f), "quaternion must have the layout of vec4f");
+	static_assert(sizeof(matrix4) == sizeof(mat4), "matrix4 must have the layout of mat4");
+
+	/*!
+		\brief aOut = a * b, aOut may be a or b
+	*/
+	static inline void multiply(const matrix4& a, const matrix4& b, matrix4& aOut) throw() {
+		using namespace implementation;
+		// Column j of the result is the columns of a weighted by column j of b
+#if defined(ASMITH_GL_AVX2)
+		// Two columns at a time, each half of a register holds one column
+		const __m256 c0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a.columns[0]));
+		const __m256 c1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a.columns[1]));
+		const __m256 c2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a.columns[2]));
+		const __m256 c3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a.columns[3]));
+		for(int j = 0; j < 4; j += 2) {
+			const __m256 w = _mm256_loadu_ps(b.columns[j]);
+			__m256 r = _mm256_mul_ps(c0, _mm256_permute_ps(w, 0x00));
+			r = _mm256_add_ps(r, _mm256_mul_ps(c1, _mm256_permute_ps(w, 0x55)));
+			r = _mm256_add_ps(r, _mm256_mul_ps(c2, _mm256_permute_ps(w, 0xAA)));
+			r = _mm256_add_ps(r, _mm256_mul_ps(c3, _mm256_permute_ps(w, 0xFF)));
+			_mm256_storeu_ps(aOut.columns[j], r);
+		}
+#else
+		const simd_float4 c0 = simd_load(a.columns[0]);
+		const simd_float4 c1 = simd_load(a.columns[1]);
+		const simd_float4 c2 = simd_load(a.columns[2]);
+		const simd_float4 c3 = simd_load(a.columns[3]);
+		for(int j = 0; j < 4; ++j) {
+			const simd_float4 w = simd_load(b.columns[j]);
+			simd_float4 r = simd_mul(c0, simd_splat<0>(w));
+			r = simd_madd(c1, simd_splat<1>(w), r);
+			r = simd_madd(c2, simd_splat<2>(w), r);
+			r = simd_madd(c3, simd_splat<3>(w), r);
+			simd_store(aOut.columns[j], r);
+		}
+#endif
+	}
+
+	/*!
+		\brief aOut[i] = a * b[i]
+	*/
+	static inline void multiply(const matrix4& a, const matrix4* b, matrix4* aOut, size_t aCount) throw() {
+		for(size_t i = 0; i < aCount; ++i) multiply(a, b[i], aOut[i]);
+	}
+
+	/*!
+		\brief aOut[i] = a[i] * b[i]
+	*/
+	static inline void multiply(const matrix4* a, const matrix4* b, matrix4* aOut, size_t aCount) throw() {
+		for(size_t i = 0; i < aCount; ++i) multiply(a[i], b[i], aOut[i]);
+	}
+
+	/*!
+		\brief Transform points by a matrix, with w = 1 and no perspective divide
+		\details aIn and aOut may be the same array.
+	*/
+	static inline void transform_points(const matrix4& aMatrix, const vector3* aIn, vector3* aOut, size_t aCount) throw() {
+		using namespace implementation;
+		const simd_float4 c0 = simd_load(aMatrix.columns[0]);
+		const simd_float4 c1 = simd_load(aMatrix.columns[1]);
+		const simd_float4 c2 = simd_load(aMatrix.columns[2]);
+		const simd_float4 c3 = simd_load(aMatrix.columns[3]);
+		size_t i = 0;
+
+		// Groups of four points are transposed so that each register holds one coordinate of all four
+		const simd_float4 m00 = simd_set(aMatrix.columns[0][0]), m01 = simd_set(aMatrix.columns[0][1]), m02 = simd_set(aMatrix.columns[0][2]);
+		const simd_float4 m10 = simd_set(aMatrix.columns[1][0]), m11 = simd_set(aMatrix.columns[1][1]), m12 = simd_set(aMatrix.columns[1][2]);
+		const simd_float4 m20 = simd_set(aMatrix.columns[2][0]), m21 = simd_set(aMatrix.columns[2][1]), m22 = simd_set(aMatrix.columns[2][2]);
+		const simd_float4 m30 = simd_set(aMatrix.columns[3][0]), m31 = simd_set(aMatrix.columns[3][1]), m32 = simd_set(aMatrix.columns[3][2]);
+		const size_t groups = aCount - aCount % 4;
+		for(; i < groups; i += 4) {
+			simd_float4 x, y, z;
+			simd_load3x4(&aIn[i].x, x, y, z);
+			const simd_float4 rx = simd_madd(m20, z, simd_madd(m10, y, simd_madd(m00, x, m30)));
+			const simd_float4 ry = simd_madd(m21, z, simd_madd(m11, y, simd_madd(m01, x, m31)));
+			const simd_float4 rz = simd_madd(m22, z, simd_madd(m12, y, simd_madd(m02, x, m32)));
+			simd_store3x4(&aOut[i].x, rx, ry, rz);
+		}
+
+		alignas(16) GLfloat tmp[4];
+		for(; i < aCount; ++i) {
+			const vector3 p = aIn[i];
+			simd_float4 r = simd_madd(c0, simd_set(p.x), c3);
+			r = simd_madd(c1, simd_set(p.y), r);
+			r = simd_madd(c2, simd_set(p.z), r);
+			simd_store(tmp, r);
+			aOut[i] = vector3{ tmp[0], tmp[1], tmp[2] };
+		}
+	}
+
+	/*!
+		\brief Transform four component vectors by a matrix
+	*/
+	static inline void transform_vectors(const matrix4& aMatrix, const vector4* aIn, vector4* aOut, size_t aCount) throw() {
+		using namespace implementation;
+		const simd_float4 c0 = simd_load(aMatrix.columns[0]);
+		const simd_float4 c1 = simd_load(aMatrix.columns[1]);
+		const simd_float4 c2 = simd_load(aMatrix.columns[2]);
+		const simd_float4 c3 = simd_load(aMatrix.columns[3]);
+		for(size_t i = 0; i < aCount; ++i) {
+			const simd_float4 v = aIn[i].to_simd();
+			simd_float4 r = simd_mul(c0, simd_splat<0>(v));
+			r = simd_madd(c1, simd_splat<1>(v), r);
+			r = simd_madd(c2, simd_splat<2>(v), r);
+			r = simd_madd(c3, simd_splat<3>(v), r);
+			simd_store(&aOut[i].x, r);
+		}
+	}
+
+	inline matrix4 matrix4::operator*(const matrix4& aOther) const throw() {
+		matrix4 tmp;
+		multiply(*this, aOther, tmp);
+		return tmp;
+	}
+
+	inline vector4 matrix4::operator*(const vector4& aVector) const throw() {
+		vector4 tmp;
+		transform_vectors(*this, &aVector, &tmp, 1);
+		return tmp;
+	}
+
+}}
+
+#endif
\ No newline at end of file
@@ -23,8 +23,8 @@ namespace asmith { namespace gl {
 	/*!
 		\brief 
 		\author Adam Smith
-		\date Created : ? Modified 5th July 2017
-		\version 3.4
+		\date Created : ? Modified 18th October 2026
+		\version 3.5
 	*/
 	struct obj {
 		struct face {
@@ -54,13 +54,23 @@ namespace asmith { namespace gl {
 			std::string name;
 			std::vector<group> groups;
 		};
+
+		//! One corner of a triangle, the layout of the VBO that create_vao makes
+		struct vertex {
+			vec3f v;
+			vec2f t;
+			vec3f n;
+		};
 		
 		std::vector<vec3f> vertices;
 		std::vector<vec3f> normals;
 		std::vector<vec2f> texture_coordinates;
 		std::vector<object> objects;
 
+		static void add_attributes(vertex_array&, std::shared_ptr<vertex_buffer>);
+
 		void load(std::istream&);
+		std::vector<vertex> create_vertices() const;
 		std::shared_ptr<vertex_array> create_vao(context&, GLsizei&) const;
 	};
 }}
@@ -14,31 +14,167 @@
 #ifndef ASMITH_OPENGL_PROGRAM_HPP
 #define ASMITH_OPENGL_PROGRAM_HPP
 
+#include <string>
+#include <unordered_map>
 #include <vector>
 #include "shader.hpp"
+#include "vertex_buffer.hpp"
 
 namespace asmith { namespace gl {
 	
+	namespace implementation {
+		// The GLSL type that a C++ type is uploaded as, GL_NONE for types that set_uniform does not accept
+		template<class T> struct uniform_glsl_type { enum : GLenum { value = GL_NONE }; };
+		template<> struct uniform_glsl_type<GLfloat> { enum : GLenum { value = GL_FLOAT }; };
+		template<> struct uniform_glsl_type<vec2f> { enum : GLenum { value = GL_FLOAT_VEC2 }; };
+		template<> struct uniform_glsl_type<vec3f> { enum : GLenum { value = GL_FLOAT_VEC3 }; };
+		template<> struct uniform_glsl_type<vec4f> { enum : GLenum { value = GL_FLOAT_VEC4 }; };
+		template<> struct uniform_glsl_type<GLint> { enum : GLenum { value = GL_INT }; };
+		template<> struct uniform_glsl_type<vec2i> { enum : GLenum { value = GL_INT_VEC2 }; };
+		template<> struct uniform_glsl_type<vec3i> { enum : GLenum { value = GL_INT_VEC3 }; };
+		template<> struct uniform_glsl_type<vec4i> { enum : GLenum { value = GL_INT_VEC4 }; };
+		template<> struct uniform_glsl_type<GLuint> { enum : GLenum { value = GL_UNSIGNED_INT }; };
+		template<> struct uniform_glsl_type<vec2u> { enum : GLenum { value = GL_UNSIGNED_INT_VEC2 }; };
+		template<> struct uniform_glsl_type<vec3u> { enum : GLenum { value = GL_UNSIGNED_INT_VEC3 }; };
+		template<> struct uniform_glsl_type<vec4u> { enum : GLenum { value = GL_UNSIGNED_INT_VEC4 }; };
+		template<> struct uniform_glsl_type<mat2> { enum : GLenum { value = GL_FLOAT_MAT2 }; };
+		template<> struct uniform_glsl_type<mat3> { enum : GLenum { value = GL_FLOAT_MAT3 }; };
+		template<> struct uniform_glsl_type<mat4> { enum : GLenum { value = GL_FLOAT_MAT4 }; };
+
+		bool is_uniform_type_compatible(GLenum, GLenum) throw();
+	}
+
 	/*!
 		\brief OpenGL program
 		\author Adam Smith
-		\date Created : 6th November 2015 Modified 30th June 2017
-		\version 2.4
+		\date Created : 6th November 2015 Modified 18th October 2026
+		\version 2.12
 	*/
+	class program_pipeline;
+
 	class program : public object {
+		friend program_pipeline;
 	public:
 		enum id_t : GLuint{
 			INVALID_ID = 0
 		};
+
+		struct uniform_info {
+			std::string name;
+			GLint location;
+			GLenum type;
+			GLint size;
+			GLint block_index;
+			GLint offset;
+			GLint array_stride;
+			GLint matrix_stride;
+		};
+
+		struct attribute_info {
+			std::string name;
+			GLint location;
+			GLenum type;
+			GLint size;
+		};
+
+		struct block_info {
+			std::string name;
+			GLuint index;
+			GLint data_size;
+			GLint binding;
+		};
+
+		struct uniform_statistics {
+			size_t calls;
+			size_t elided;
+			size_t uploads;
+		};
 	private:
+		struct uniform_slot {
+			GLint location;
+			GLenum type;
+			uint32_t offset;
+			uint32_t bytes;
+			bool dirty;
+			bool boolean;
+		};
+
+		typedef std::unordered_map<std::string, size_t> name_table;
+
+		std::vector<uniform_info> mUniforms;
+		std::vector<uniform_info> mBufferVariables;
+		std::vector<attribute_info> mAttributes;
+		std::vector<block_info> mUniformBlocks;
+		std::vector<block_info> mStorageBlocks;
+		name_table mUniformNames;
+		name_table mAttributeNames;
+		name_table mUniformBlockNames;
+		name_table mStorageBlockNames;
+		std::vector<uint8_t> mUniformData;
+		std::vector<uniform_slot> mSlots;
+		std::vector<int32_t> mSlotByLocation;
+		std::vector<uint32_t> mDirtySlots;
+		uniform_statistics mUniformStatistics;
 		std::vector<std::shared_ptr<shader>> mShaders;
 		std::shared_ptr<program> mPreviousBind;
 		bool mBound;
+		bool mLinked;
+		bool mLinkPending;
+		bool mSeparable;
+	private:
+		std::string get_info_log() const;
+		void attach_for_link();
+		void upload_uniforms() throw();
+		void reflect();
+		const uniform_info& find_typed_uniform(const GLchar*, GLenum) const;
+		void create_uniform_shadow();
+		int32_t find_slot(GLint, GLenum) const throw();
+		int32_t find_boolean_slot(GLint, GLenum) const throw();
+		void set_uniform_value(GLint, GLenum, const void*, size_t);
+		void get_uniform_value(GLint, GLenum, void*, size_t) const;
 	public:
 		program(context&);
 		~program();
 
 		void link();
+		bool is_linked() const throw();
+
+		/*!
+			\brief Start linking without waiting for the result
+			\details The attached shaders may still be compiling from shader::compile_async. With
+			KHR_parallel_shader_compile is_ready can be polled each frame, otherwise it waits for the link.
+		*/
+		void link_async();
+		bool is_link_pending() const throw();
+		bool is_ready();
+		void finish_link();
+
+		static bool is_binary_supported() throw();
+
+		/*!
+			\brief Allow the program to be used for some of the stages of a program_pipeline
+			\details Takes effect at the next link.
+		*/
+		static bool is_separable_supported() throw();
+		void set_separable(bool);
+		bool is_separable() const throw();
+		GLbitfield get_stages() const throw();
+
+		/*!
+			\brief Run a linked compute program, which must be currently bound
+			\details dispatch_threads rounds each dimension up to a whole number of work groups. dispatch_indirect
+			reads the group counts from three GLuints at an offset into a buffer. Use memory_barrier before
+			reading what the program has written.
+		*/
+		static bool is_compute_supported() throw();
+		void get_work_group_size(GLint&, GLint&, GLint&) const;
+		void dispatch(GLuint, GLuint = 1, GLuint = 1);
+		void dispatch_threads(GLuint, GLuint = 1, GLuint = 1);
+		void dispatch_indirect(const vertex_buffer&, GLintptr = 0);
+
+		void set_binary_retrievable(bool);
+		std::vector<uint8_t> get_binary(GLenum&) const;
+		bool load_binary(GLenum, const void*, GLsizei);
 
 		void attach(std::shared_ptr<shader>);
 		void detach(std::shared_ptr<shader>);
@@ -52,6 +188,44 @@ namespace asmith { namespace gl {
 
 		GLint get_uniform_location(const GLchar*) const;
 
+		/*!
+			\brief Upload the uniforms that have changed since the last flush
+			\details set_uniform only writes to a copy of the uniform values held by the program, this is called by
+			bind and vertex_array before drawing. Call it before drawing with glDraw* directly. Does nothing if
+			the program is not currently bound.
+		*/
+		void flush_uniforms() throw();
+		uniform_statistics get_uniform_statistics() const throw();
+		void reset_uniform_statistics() throw();
+
+		/*!
+			\brief Find the location of a uniform and check that T can be uploaded to it with set_uniform
+			\details Throws if the uniform is active and its GLSL type does not match T. Returns -1 if it is not
+			active, the same as glGetUniformLocation.
+		*/
+		template<class T>
+		inline GLint get_uniform_location(const GLchar* aName) const {
+			static_assert(implementation::uniform_glsl_type<T>::value != GL_NONE, "asmith::gl::program::get_uniform_location : Type cannot be used as a uniform");
+			return find_typed_uniform(aName, implementation::uniform_glsl_type<T>::value).location;
+		}
+
+		GLint get_attribute_location(const GLchar*) const;
+		GLint get_uniform_block_index(const GLchar*) const;
+		GLint get_storage_block_index(const GLchar*) const;
+		void set_uniform_block_binding(GLuint, GLuint);
+		void set_storage_block_binding(GLuint, GLuint);
+
+		const uniform_info* find_uniform(const GLchar*) const throw();
+		const attribute_info* find_attribute(const GLchar*) const throw();
+		const block_info* find_uniform_block(const GLchar*) const throw();
+		const block_info* find_storage_block(const GLchar*) const throw();
+
+		const std::vector<uniform_info>& get_uniforms() const throw();
+		const std::vector<uniform_info>& get_buffer_variables() const throw();
+		const std::vector<attribute_info>& get_attributes() const throw();
+		const std::vector<block_info>& get_uniform_blocks() const throw();
+		const std::vector<block_info>& get_storage_blocks() const throw();
+
 		void set_uniform(GLint, GLfloat);
 		void set_uniform(GLint, GLfloat, GLfloat);
 		void set_uniform(GLint, GLfloat, GLfloat, GLfloat);
@@ -101,11 +275,33 @@ namespace asmith { namespace gl {
 		return tmp;
 	}
 
+	static std::shared_ptr<program> link_separable_program(const std::shared_ptr<shader>& aShader) {
+		std::shared_ptr<program> tmp(new program(aShader->get_context()));
+		tmp->attach(aShader);
+		tmp->set_separable(true);
+		tmp->link();
+		return tmp;
+	}
+
+	static inline void memory_barrier(GLbitfield aBarriers) {
+#ifdef GL_ARB_shader_image_load_store
+		glMemoryBarrier(aBarriers);
+#endif
+	}
+
+	static std::shared_ptr<program> link_program_async(const std::vector<std::shared_ptr<shader>>& aShaders) {
+		std::shared_ptr<program> tmp(new program(aShaders[0]->get_context()));
+		for(const std::shared_ptr<shader>& i : aShaders) tmp->attach(i);
+		tmp->link_async();
+		return tmp;
+	}
+
 	/*!
 		\brief OpenGL uniform value helper
+		\details The location is looked up once, and the construction fails if T does not match the GLSL type.
 		\author Adam Smith
-		\date Created :  23rd June 2017 Modified 23rd June 2017
-		\version 1.0
+		\date Created :  23rd June 2017 Modified 18th October 2026
+		\version 1.1
 	*/
 	template<class T>
 	class uniform {
@@ -118,7 +314,7 @@ namespace asmith { namespace gl {
 			mProgram(aProgram),
 			mLocation(-1)
 		{
-			mLocation = mProgram->get_uniform_location(aName);
+			mLocation = mProgram->get_uniform_location<T>(aName);
 			if(mLocation != -1) {
 				mProgram->get_uniform(mLocation, mValue);
 			}
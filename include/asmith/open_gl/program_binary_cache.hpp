@@ -0,0 +1,90 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+#ifndef ASMITH_OPENGL_PROGRAM_BINARY_CACHE_HPP
+#define ASMITH_OPENGL_PROGRAM_BINARY_CACHE_HPP
+
+#include <string>
+#include <vector>
+#include "program.hpp"
+
+namespace asmith { namespace gl {
+
+	/*!
+		\brief Stores linked programs on disk so that later runs skip compiling and linking
+		\details Programs are identified by a hash of the type and source of each shader, a string of defines
+		that the caller used to generate the sources, and the vendor, renderer and version strings of the
+		driver. Binaries that the driver rejects, for example after a driver update, are rebuilt from source
+		and replaced. Shaders only need their source set with shader::set_source, they are compiled on a
+		miss. The directory must already exist.
+		\author Adam Smith
+		\date Created : 18th October 2026 Modified 18th October 2026
+		\version 1.0
+	*/
+	class program_binary_cache {
+	public:
+		struct statistics {
+			size_t hits;
+			size_t misses;
+			size_t rejections;
+			size_t write_failures;
+			double build_seconds;
+			double load_seconds;
+			double saved_seconds;
+		};
+	private:
+		struct file_header {
+			uint32_t magic;
+			uint32_t version;
+			uint64_t key;
+			uint32_t format;
+			uint32_t length;
+			uint64_t build_microseconds;
+		};
+
+		enum : uint32_t {
+			FILE_MAGIC = 0x42504741,	// "AGPB"
+			FILE_VERSION = 1
+		};
+
+		context& mContext;
+		std::string mDirectory;
+		std::string mDriver;
+		statistics mStatistics;
+		bool mEnabled;
+	private:
+		program_binary_cache(const program_binary_cache&) = delete;
+		program_binary_cache(program_binary_cache&&) = delete;
+		program_binary_cache& operator=(const program_binary_cache&) = delete;
+		program_binary_cache& operator=(program_binary_cache&&) = delete;
+
+		std::string get_path(uint64_t) const;
+		bool read(uint64_t, std::vector<uint8_t>&, file_header&) const;
+		bool write(uint64_t, const program&, uint64_t) const;
+		std::shared_ptr<program> build(const std::vector<std::shared_ptr<shader>>&, uint64_t&);
+	public:
+		program_binary_cache(context&, const std::string&);
+		~program_binary_cache();
+
+		uint64_t get_key(const std::vector<std::shared_ptr<shader>>&, const std::string& = std::string()) const;
+		std::shared_ptr<program> link(const std::vector<std::shared_ptr<shader>>&, const std::string& = std::string());
+		void remove(uint64_t);
+
+		bool is_enabled() const throw();
+		statistics get_statistics() const throw();
+		void reset_statistics() throw();
+	};
+
+}}
+
+#endif
\ No newline at end of file
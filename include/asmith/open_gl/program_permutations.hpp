@@ -0,0 +1,113 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+#ifndef ASMITH_OPENGL_PROGRAM_PERMUTATIONS_HPP
+#define ASMITH_OPENGL_PROGRAM_PERMUTATIONS_HPP
+
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "program.hpp"
+#include "program_binary_cache.hpp"
+#include "shader_preprocessor.hpp"
+
+namespace asmith { namespace gl {
+
+	/*!
+		\brief The permutations of one program, built when they are first used
+		\details Each feature is a preprocessor define, a permutation is identified by a bitmask of the features
+		it is built with. get builds a permutation that does not exist yet and waits for it. Permutations that are
+		likely to be needed can be queued with warm_up, update then starts building them during idle frames
+		until its time budget runs out. With KHR_parallel_shader_compile the driver builds them in the
+		background and update only polls them.
+
+		The budget is only checked before each build is started. With a program_binary_cache a binary that is
+		found on disk loads quickly, but a miss is compiled and linked by program_binary_cache::link before
+		update returns, because the binary is written as soon as the link finishes. A single warm up can then
+		take longer than the budget, so a cold cache is best warmed up during a loading screen.
+
+		The permutations that get returns are recorded, save_used writes them to a file that load_used queues
+		for warm up in the next run.
+		\author Adam Smith
+		\date Created : 18th October 2026 Modified 18th October 2026
+		\version 1.1
+	*/
+	class program_permutations {
+	public:
+		typedef uint64_t feature_mask;
+
+		struct statistics {
+			size_t built_on_demand;
+			size_t warmed_up;
+			size_t requests;
+			size_t warm_up_hits;
+			double demand_seconds;
+			double warm_up_seconds;
+		};
+	private:
+		struct stage {
+			shader::type type;
+			std::string file;
+		};
+
+		struct permutation {
+			std::shared_ptr<program> prog;
+			bool used;
+			bool warmed_up;
+		};
+
+		context& mContext;
+		shader_preprocessor& mPreprocessor;
+		program_binary_cache* mCache;
+		std::vector<stage> mStages;
+		std::vector<std::string> mFeatures;
+		std::unordered_map<feature_mask, permutation> mPermutations;
+		std::deque<feature_mask> mWarmUpQueue;
+		std::vector<feature_mask> mPending;
+		statistics mStatistics;
+	private:
+		program_permutations(const program_permutations&) = delete;
+		program_permutations(program_permutations&&) = delete;
+		program_permutations& operator=(const program_permutations&) = delete;
+		program_permutations& operator=(program_permutations&&) = delete;
+
+		void check_mask(feature_mask) const;
+		std::shared_ptr<program> build(feature_mask, bool);
+	public:
+		program_permutations(context&, shader_preprocessor&, program_binary_cache* = nullptr);
+		~program_permutations();
+
+		void add_stage(shader::type, const std::string&);
+		feature_mask add_feature(const std::string&);
+		feature_mask get_feature(const std::string&) const;
+		shader_preprocessor::define_set get_defines(feature_mask) const;
+
+		std::shared_ptr<program> get(feature_mask);
+		bool is_built(feature_mask) const throw();
+
+		void warm_up(feature_mask);
+		void update(double);
+		size_t get_warm_up_count() const throw();
+
+		std::vector<feature_mask> get_used() const;
+		void save_used(const std::string&) const;
+		void load_used(const std::string&);
+
+		statistics get_statistics() const throw();
+		void reset_statistics() throw();
+	};
+
+}}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,86 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+#ifndef ASMITH_OPENGL_PROGRAM_PIPELINE_HPP
+#define ASMITH_OPENGL_PROGRAM_PIPELINE_HPP
+
+#include <string>
+#include <vector>
+#include "program.hpp"
+
+#ifdef GL_ARB_separate_shader_objects
+namespace asmith { namespace gl {
+
+	/*!
+		\brief Combines separable programs, each providing one or more shader stages
+		\details Each shader is compiled and linked once into a separable program, a pipeline then uses them
+		without linking. N vertex and M fragment shaders need N + M links instead of N * M. get_pipeline keeps
+		one pipeline per combination of programs in the context state, so a combination is only set up once.
+
+		A program bound with program::bind takes precedence over the bound pipeline, so a pipeline cannot be
+		bound while a program is.
+		\author Adam Smith
+		\date Created : 18th October 2026 Modified 18th October 2026
+		\version 1.0
+	*/
+	class program_pipeline : public object {
+	public:
+		enum : size_t {
+			STAGE_COUNT = 6
+		};
+
+		struct stage_key {
+			GLuint programs[STAGE_COUNT];
+
+			bool operator==(const stage_key&) const throw();
+		};
+
+		struct stage_key_hash {
+			size_t operator()(const stage_key&) const throw();
+		};
+	private:
+		std::shared_ptr<program> mPrograms[STAGE_COUNT];
+		bool mCached;
+	public:
+		static bool is_supported() throw();
+		static std::shared_ptr<program_pipeline> get_pipeline(context&, const std::vector<std::shared_ptr<program>>&);
+		static std::shared_ptr<program_pipeline> get_bound_pipeline(context&) throw();
+		static void clear_cache(context&) throw();
+
+		program_pipeline(context&);
+		~program_pipeline();
+
+		void use_program(std::shared_ptr<program>);
+		void use_program(GLbitfield, std::shared_ptr<program>);
+		void clear_stages(GLbitfield);
+		std::shared_ptr<program> get_program(shader::type) const throw();
+		stage_key get_key() const throw();
+
+		bool validate();
+		std::string get_info_log() const;
+
+		void bind();
+		void unbind();
+		bool is_currently_bound() const throw();
+
+		/*!
+			\brief Upload the uniforms that have changed in each program of the pipeline
+			\details Called by vertex_array before drawing while the pipeline is bound.
+		*/
+		void flush_uniforms() throw();
+	};
+
+}}
+#endif
+
+#endif
\ No newline at end of file
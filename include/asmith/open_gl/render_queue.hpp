@@ -0,0 +1,138 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+#ifndef ASMITH_OPENGL_RENDER_QUEUE_HPP
+#define ASMITH_OPENGL_RENDER_QUEUE_HPP
+
+#include <vector>
+#include "program.hpp"
+#include "texture.hpp"
+#include "vertex_array.hpp"
+
+namespace asmith { namespace gl {
+
+	/*!
+		\brief Collects the draws of a frame and replays them in the order that changes the least state
+		\details Each packet is given a 64 bit key when it is submitted :
+		pass (4) | translucent (1) | program (14) | textures (16) | vertex array (12) | depth (17)
+		Translucent packets move the depth in front of the program and invert it, so that they are drawn back to
+		front. execute radix sorts the keys and replays the packets, the program, textures and vertex array are
+		only changed when they differ from the previous packet. The fields of the key are truncated IDs and
+		hashes, a collision only makes the order less efficient because the replay compares the objects.
+
+		The queue holds raw pointers, the objects of a packet must exist until execute returns. Programs must
+		be owned by a std::shared_ptr and must not be bound when execute is called. A packet with an instance
+		count of 0 is drawn with draw_arrays, otherwise with draw_arrays_instanced.
+		\author Adam Smith
+		\date Created : 18th October 2026 Modified 18th October 2026
+		\version 1.2
+	*/
+	class render_queue {
+	public:
+		enum : size_t {
+			MAX_TEXTURES = 4,
+			MAX_PASSES = 16
+		};
+
+		typedef uint64_t sort_key;
+		typedef void(*uniform_function)(program&, const void*);
+
+		struct packet {
+			program* prog;
+			vertex_array* vao;
+			texture* textures[MAX_TEXTURES];
+			GLint sampler_locations[MAX_TEXTURES];	//!< The sampler uniform each texture unit is written to, -1 for none
+			size_t texture_count;
+			uniform_function set_uniforms;			//!< Called before the draw with uniform_data, may be null
+			const void* uniform_data;
+			GLenum mode;
+			GLint first;
+			GLsizei count;
+			GLfloat depth;
+			uint8_t pass;
+			bool translucent;
+			GLsizei instance_count;
+			GLuint base_instance;
+		};
+
+		struct statistics {
+			size_t frames;
+			size_t packets;
+			size_t program_changes;
+			size_t texture_changes;
+			size_t vao_changes;
+			size_t changes_avoided;	//!< Changes that replaying the packets in submission order would have made in addition
+		};
+	private:
+		struct sort_entry {
+			sort_key key;
+			uint32_t index;
+		};
+
+		context& mContext;
+		std::vector<packet> mPackets;
+		std::vector<sort_entry> mEntries;
+		std::vector<sort_entry> mSortBuffer;
+		GLfloat mNear;
+		GLfloat mFar;
+		size_t mGeneration;
+		statistics mStatistics;
+		statistics mFrameStatistics;
+	private:
+		render_queue(const render_queue&) = delete;
+		render_queue(render_queue&&) = delete;
+		render_queue& operator=(const render_queue&) = delete;
+		render_queue& operator=(render_queue&&) = delete;
+
+		size_t count_submission_changes() const throw();
+		void sort() throw();
+		void replay();
+	public:
+		/*!
+			\brief Compare the state that packets are drawn with
+			\details Everything except the vertex array, draw range, depth and instances. Packets with the same
+			material can be drawn together once their geometry has been merged.
+		*/
+		static bool same_material(const packet&, const packet&) throw();
+		static uint64_t hash_material(const packet&) throw();
+
+		render_queue(context&);
+		~render_queue();
+
+		/*!
+			\brief Set the range of the depths that packets are submitted with
+			\details Depths are quantised to 17 bits across the range, depths outside of it are clamped.
+		*/
+		void set_depth_range(GLfloat, GLfloat);
+		void reserve(size_t);
+
+		sort_key submit(const packet&);
+		size_t size() const throw();
+		void clear() throw();
+		void execute();
+
+		/*!
+			\brief Count the times that the packets have been dropped
+			\details Increases every time clear or execute is called and is not reset with the statistics, so
+			a packet submitted while the value has not changed has not been drawn yet.
+		*/
+		size_t get_generation() const throw();
+
+		statistics get_statistics() const throw();
+		statistics get_frame_statistics() const throw();
+		void reset_statistics() throw();
+	};
+
+}}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,81 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+#ifndef ASMITH_OPENGL_SAMPLER_HPP
+#define ASMITH_OPENGL_SAMPLER_HPP
+
+#include <memory>
+#include "object.hpp"
+
+#if ASMITH_GL_VERSION_GE(3,3)
+namespace asmith { namespace gl {
+
+	/*!
+		\brief OpenGL sampler object, holds filtering state independently of texture objects
+		\author Adam Smith
+		\date Created : 18th October 2026 Modified 18th October 2026
+		\version 1.0
+	*/
+	class sampler : public object {
+	public:
+		struct state {
+			vec4f border_colour;
+			GLenum min_filter;
+			GLenum mag_filter;
+			GLenum wrap_s;
+			GLenum wrap_t;
+			GLenum wrap_r;
+			GLenum compare_mode;
+			GLenum compare_func;
+
+			state() throw();
+			bool operator==(const state&) const throw();
+			bool operator!=(const state&) const throw();
+		};
+
+		struct state_hash {
+			size_t operator()(const state&) const throw();
+		};
+	private:
+		state mState;
+		bool mCached;
+	private:
+		void check_mutable(const char*) const;
+	public:
+		static std::shared_ptr<sampler> get_sampler(context&, const state&);
+		static void clear_cache(context&) throw();
+		static std::shared_ptr<sampler> get_sampler_bound_to(context&, GLuint) throw();
+		static void unbind(context&, GLuint) throw();
+
+		sampler(context&);
+		~sampler();
+
+		const state& get_state() const throw();
+		bool is_cached() const throw();
+
+		void set_state(const state&);
+		void set_filter(GLenum);
+		void set_filter(GLenum, GLenum);
+		void set_wrap(GLenum);
+		void set_wrap(GLenum, GLenum, GLenum);
+		void set_border_colour(const vec4f&);
+		void set_compare(GLenum, GLenum);
+
+		void bind(GLuint) throw();
+		bool is_bound(GLuint) const throw();
+	};
+
+}}
+#endif
+
+#endif
\ No newline at end of file
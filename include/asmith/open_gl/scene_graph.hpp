@@ -0,0 +1,117 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+#ifndef ASMITH_OPENGL_SCENE_GRAPH_HPP
+#define ASMITH_OPENGL_SCENE_GRAPH_HPP
+
+#include <vector>
+#include "maths.hpp"
+#include "thread_pool.hpp"
+
+namespace asmith { namespace gl {
+
+	/*!
+		\brief A hierarchy of transforms, the world matrix of each node is its parent's world matrix multiplied by its local matrix
+		\details Nodes are stored as separate arrays of local matrices, world matrices, parent indices and dirty
+		flags, sorted by depth so that every parent is before its children and the children of a node are next to
+		each other. update visits one depth at a time, splitting each depth across the thread pool, and only
+		recomputes the nodes whose local matrix or an ancestor's changed.
+
+		A node is identified by a handle that does not change when the arrays are sorted again. Creating,
+		destroying or re-parenting nodes only marks the order as out of date, it is rebuilt by the next update.
+		World matrices are valid after update.
+		\author Adam Smith
+		\date Created : 18th October 2026 Modified 18th October 2026
+		\version 1.1
+	*/
+	class scene_graph {
+	public:
+		typedef uint32_t node;
+
+		enum : node {
+			INVALID_NODE = UINT32_MAX
+		};
+
+		struct statistics {
+			size_t updates;
+			size_t nodes_updated;
+			size_t reorders;
+		};
+	private:
+		typedef matrix4 matrix;
+
+		struct link {
+			node parent;
+			node first_child;
+			node next_sibling;
+			node previous_sibling;
+			uint32_t index;
+		};
+
+		// Indexed by handle
+		std::vector<link> mLinks;
+		std::vector<node> mFreeNodes;
+		node mFirstRoot;
+
+		// Indexed by position in depth order
+		std::vector<matrix> mLocal;
+		std::vector<matrix> mWorld;
+		std::vector<uint32_t> mParents;
+		std::vector<uint8_t> mDirty;
+		std::vector<node> mNodes;
+		std::vector<size_t> mLevels;
+
+		thread_pool& mPool;
+		size_t mDirtyCount;
+		bool mOrderChanged;
+		statistics mStatistics;
+	private:
+		scene_graph(const scene_graph&) = delete;
+		scene_graph(scene_graph&&) = delete;
+		scene_graph& operator=(const scene_graph&) = delete;
+		scene_graph& operator=(scene_graph&&) = delete;
+
+		const link& get_link(node, const char*) const;
+		void attach(node, node) throw();
+		void detach(node) throw();
+		void mark_dirty(uint32_t) throw();
+		void reorder();
+		void update_range(size_t, size_t) throw();
+	public:
+		scene_graph();
+		scene_graph(thread_pool&);
+		~scene_graph();
+
+		node create_node(node = INVALID_NODE);
+		void destroy_node(node);
+		bool is_valid(node) const throw();
+		size_t size() const throw();
+
+		void set_parent(node, node);
+		node get_parent(node) const;
+		node get_first_child(node) const;
+		node get_next_sibling(node) const;
+
+		void set_local(node, const mat4&);
+		const mat4& get_local(node) const;
+		const mat4& get_world(node) const;
+
+		void update();
+
+		statistics get_statistics() const throw();
+		void reset_statistics() throw();
+	};
+
+}}
+
+#endif
\ No newline at end of file
@@ -14,15 +14,18 @@
 #ifndef ASMITH_OPENGL_SHADER_HPP
 #define ASMITH_OPENGL_SHADER_HPP
 
+#include <string>
 #include "object.hpp"
 
 namespace asmith { namespace gl {
 	
 	/*!
 		\brief Base class for OpenGL shader objects
+		\details The source is kept after compiling so that programs can be identified by the source of their
+		shaders, for example by program_binary_cache.
 		\author Adam Smith
-		\date Created : 6th November 2015 Modified 30th June 2017
-		\version 2.2
+		\date Created : 6th November 2015 Modified 18th October 2026
+		\version 2.4
 	*/
 	class shader : public object {
 	public:
@@ -40,14 +43,32 @@ namespace asmith { namespace gl {
 		};
 	private:
 		const type mType;
+		std::string mSource;
 		bool mCompiled;
+		bool mPending;
 	public:
 		shader(context&, type);
 		virtual ~shader();
 		
+		void set_source(const char*);
+		const std::string& get_source() const throw();
+		void compile();
 		void compile(const char*);
 		bool is_compiled() const throw();
 
+		/*!
+			\brief Start compiling without waiting for the result
+			\details Issue every compile before calling finish_compile or linking, so that a driver with
+			KHR_parallel_shader_compile can compile them at the same time.
+		*/
+		void compile_async();
+		bool is_compile_pending() const throw();
+		bool is_compile_complete() const throw();
+		void finish_compile();
+
+		static bool is_parallel_compile_supported() throw();
+		static void set_max_compiler_threads(GLuint);
+
 		type get_type() const throw();
 
 		virtual GLuint get_max_uniform_components() const throw() = 0;
@@ -0,0 +1,107 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+#ifndef ASMITH_OPENGL_SHADER_PREPROCESSOR_HPP
+#define ASMITH_OPENGL_SHADER_PREPROCESSOR_HPP
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "shader.hpp"
+
+namespace asmith { namespace gl {
+
+	/*!
+		\brief Expands #include directives and injects #define sets into GLSL source
+		\details Comments are removed and whitespace within each line is collapsed, so edits to comments and
+		indentation do not change the hash of the output. Line breaks are kept and each included file is given
+		its own source string number with #line, so compile errors can be traced back with expanded_source::files.
+		Includes are expanded whether or not they are inside #if blocks, #pragma once is supported.
+
+		Files are read once and the expansion of each source is kept, a permutation then only costs the
+		injection of its defines. Call clear_cache after editing files on disk.
+		\author Adam Smith
+		\date Created : 18th October 2026 Modified 18th October 2026
+		\version 1.0
+	*/
+	class shader_preprocessor {
+	public:
+		typedef std::map<std::string, std::string> define_set;
+
+		struct expanded_source {
+			std::string source;
+			std::string defines;
+			std::vector<std::string> files;
+			uint64_t hash;
+		};
+
+		struct statistics {
+			size_t files_loaded;
+			size_t expansions;
+			size_t permutations;
+			size_t cache_hits;
+		};
+	private:
+		struct expanded_body {
+			std::string version;
+			std::string text;
+			std::vector<std::string> files;
+		};
+
+		std::vector<std::string> mIncludeDirectories;
+		std::unordered_map<std::string, std::shared_ptr<const std::string>> mVirtualFiles;
+		std::unordered_map<std::string, std::shared_ptr<const std::string>> mFiles;
+		std::unordered_map<uint64_t, std::shared_ptr<const expanded_body>> mBodies;
+		std::unordered_map<uint64_t, std::shared_ptr<const expanded_source>> mSources;
+		mutable std::mutex mLock;
+		statistics mStatistics;
+	private:
+		shader_preprocessor(const shader_preprocessor&) = delete;
+		shader_preprocessor(shader_preprocessor&&) = delete;
+		shader_preprocessor& operator=(const shader_preprocessor&) = delete;
+		shader_preprocessor& operator=(shader_preprocessor&&) = delete;
+
+		std::shared_ptr<const std::string> load_file(const std::string&);
+		std::string resolve_include(const std::string&, const std::string&, bool);
+		void expand(const std::string&, const std::string&, std::vector<std::string>&, std::vector<std::string>&, expanded_body&);
+		std::shared_ptr<const expanded_source> expand_source(const std::string&, const std::string&, bool, const define_set&);
+	public:
+		shader_preprocessor();
+		~shader_preprocessor();
+
+		static std::string canonicalise(const std::string&);
+		static std::string get_define_string(const define_set&);
+
+		void add_include_directory(const std::string&);
+		void add_virtual_file(const std::string&, const std::string&);
+
+		std::shared_ptr<const expanded_source> preprocess(const std::string&, const define_set& = define_set(), const std::string& = std::string());
+		std::shared_ptr<const expanded_source> preprocess_file(const std::string&, const define_set& = define_set());
+
+		template<class T>
+		std::shared_ptr<shader> create_shader(context& aContext, const std::string& aFile, const define_set& aDefines = define_set()) {
+			std::shared_ptr<shader> tmp(new T(aContext));
+			tmp->set_source(preprocess_file(aFile, aDefines)->source.c_str());
+			return tmp;
+		}
+
+		void clear_cache();
+		statistics get_statistics() const;
+		void reset_statistics();
+	};
+
+}}
+
+#endif
\ No newline at end of file
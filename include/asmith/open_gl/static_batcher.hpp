@@ -0,0 +1,115 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+#ifndef ASMITH_OPENGL_STATIC_BATCHER_HPP
+#define ASMITH_OPENGL_STATIC_BATCHER_HPP
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "obj.hpp"
+#include "render_queue.hpp"
+
+namespace asmith { namespace gl {
+
+	/*!
+		\brief Merges small meshes that share a material into one vertex buffer, so that they are drawn together
+		\details The material of a mesh is the render_queue packet it would be drawn with, without the vertex
+		array, range and depth. Meshes with the same material are pre-transformed into the buffer of one batch,
+		which submit draws with a single packet. A batch is only rebuilt when a mesh is added to or removed from
+		it, moving a mesh transforms and uploads the vertices of that mesh again.
+
+		Meshes with more vertices than the threshold are cheaper to draw on their own and are rejected, as are
+		translucent meshes which need to be sorted individually.
+		\author Adam Smith
+		\date Created : 18th October 2026 Modified 18th October 2026
+		\version 1.0
+	*/
+	class static_batcher {
+	public:
+		typedef uint32_t handle;
+		typedef std::shared_ptr<const std::vector<obj::vertex>> mesh;
+
+		enum : handle {
+			INVALID_HANDLE = UINT32_MAX
+		};
+
+		struct statistics {
+			size_t rebuilds;
+			size_t updates;
+			size_t vertices_transformed;
+			size_t bytes_uploaded;
+			size_t draws_saved;
+		};
+	private:
+		struct member {
+			mesh vertices;
+			mat4 transform;
+			size_t batch;
+			size_t offset;
+			bool dirty;
+		};
+
+		struct batch {
+			render_queue::packet material;
+			std::vector<handle> members;
+			std::vector<obj::vertex> vertices;
+			std::shared_ptr<vertex_buffer> vbo;
+			std::shared_ptr<vertex_array> vao;
+			size_t capacity;
+			bool rebuild;
+		};
+
+		context& mContext;
+		size_t mThreshold;
+		std::vector<member> mMembers;
+		std::vector<handle> mFreeMembers;
+		std::vector<batch> mBatches;
+		std::unordered_multimap<uint64_t, size_t> mBatchIndex;
+		statistics mStatistics;
+	private:
+		static_batcher(const static_batcher&) = delete;
+		static_batcher(static_batcher&&) = delete;
+		static_batcher& operator=(const static_batcher&) = delete;
+		static_batcher& operator=(static_batcher&&) = delete;
+
+		size_t get_batch(const render_queue::packet&);
+		member& get_member(handle, const char*);
+		void rebuild(batch&);
+		void update(batch&);
+	public:
+		static_batcher(context&, size_t = 256);
+		~static_batcher();
+
+		size_t get_vertex_threshold() const throw();
+		bool can_batch(const render_queue::packet&, size_t) const throw();
+
+		handle add(const render_queue::packet&, mesh, const mat4&);
+		void remove(handle);
+		void set_transform(handle, const mat4&);
+		size_t size() const throw();
+
+		/*!
+			\brief Transform and upload the meshes that have changed since the last update
+			\details Called by submit.
+		*/
+		void update();
+		void submit(render_queue&);
+
+		statistics get_statistics() const throw();
+		void reset_statistics() throw();
+	};
+
+}}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,91 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+#ifndef ASMITH_OPENGL_TEXTURE_HPP
+#define ASMITH_OPENGL_TEXTURE_HPP
+
+#include <memory>
+#include "object.hpp"
+
+namespace asmith { namespace gl {
+
+	/*!
+		\brief Base class for OpenGL texture objects
+		\author Adam Smith
+		\date Created : 18th October 2026 Modified 18th October 2026
+		\version 1.3
+	*/
+	class texture : public object {
+		friend class texture_units;
+	private:
+		enum : uint8_t {
+			DIRTY_WRAP		= 1,
+			DIRTY_FILTER	= 2,
+			DIRTY_BORDER	= 4,
+			DIRTY_ALL		= DIRTY_WRAP | DIRTY_FILTER | DIRTY_BORDER
+		};
+	protected:
+		vec4f mBorderColour;
+		GLenum mTarget;
+		GLenum mWrap;
+		GLenum mFilter;
+		GLint mUnit;
+		GLuint mBindCount;
+		GLuint64 mHandle;
+		GLuint mResidentCount;
+		uint8_t mDirtyParameters;
+		bool mMipmaps;
+	protected:
+		void flush_parameters() throw();
+		void make_current() const throw();
+		void check_parameters_mutable(const char*) const;
+	public:
+		static bool is_bindless_supported() throw();
+
+		texture(context&);
+		virtual ~texture();
+
+		GLenum get_wrap() const throw();
+		GLenum get_filter() const throw();
+		const vec4f& get_border_colour() const throw();
+		bool has_mipmaps() const throw();
+
+		void set_wrap(GLenum);
+		void set_filter(GLenum);
+		void set_border_colour(const vec4f&);
+		void generate_mipmaps();
+
+		GLuint bind();
+		GLuint bind(GLenum);
+		void unbind();
+		bool is_bound() const throw();
+		bool is_bound(GLenum) const throw();
+		GLint get_unit() const throw();
+
+		GLuint64 get_handle();
+		bool has_handle() const throw();
+		void make_resident();
+		void make_non_resident();
+		bool is_resident() const throw();
+
+		static bool is_image_load_store_supported() throw();
+		static void unbind_image(GLuint);
+		void bind_image(GLuint, GLenum, GLenum, GLint = 0, GLboolean = GL_FALSE, GLint = 0);
+
+		virtual GLuint get_dimensions() const throw() = 0;
+		virtual GLenum get_default_target() const throw() = 0;
+	};
+
+}}
+
+#endif
\ No newline at end of file
@@ -14,51 +14,88 @@
 #ifndef ASMITH_OPENGL_TEXTURE_2D_HPP
 #define ASMITH_OPENGL_TEXTURE_2D_HPP
 
-#include <memory>
-#include "object.hpp"
+#include <vector>
+#include "texture.hpp"
+#include "colour_conversion.hpp"
+#include "image.hpp"
 
 namespace asmith { namespace gl {
 	
 	/*!
 		\brief
 		\author Adam Smith
-		\date Created : 27th June 2017 Modified 27th June 2017
-		\version 1.2
+		\date Created : 27th June 2017 Modified 18th October 2026
+		\version 1.8
 	*/
-	class texture_2d : public object {
+	class texture_2d : public texture {
 	private:
-		vec4f mBorderColour;
-		GLenum mTarget;
 		GLsizei mWidth;
 		GLsizei mHeight;
-		GLenum mWrap;
-		GLenum mFilter;
+		GLint mInternalFormat;
+		GLenum mFormat;
+		GLenum mType;
+		uint32_t mLoadedLevels;
+		bool mBaseSizeKnown;
 	public:
-		texture_2d(context&) throw();
-		~texture_2d() throw();
+		texture_2d(context&);
+		~texture_2d();
 
 		GLsizei get_width() const throw();
 		GLsizei get_height() const throw();
-		GLenum get_wrap() const throw();
-		GLenum get_filter() const throw();
-		const vec4f& get_border_colour() const throw();
-		bool has_mipmaps() const throw();
+		GLint get_internal_format() const throw();
+		GLenum get_format() const throw();
+		GLenum get_type() const throw();
 
-		void set_wrap(GLenum) throw();
-		void set_filter(GLenum) throw();
-		void set_border_colour(const vec4f&) throw();
-		void generate_mipmaps() throw();
+		GLint get_level_count() const throw();
+		bool is_level_loaded(GLint) const throw();
+		/*!
+			\brief Estimate the video memory used by one mip level
+			\details The size comes from the internal format. Compressed formats with a fixed block size are counted
+			in 4x4 blocks, and unsized formats fall back to the size of the format and type that were uploaded.
+		*/
+		size_t get_level_memory_usage(GLint) const throw();
+		size_t get_memory_usage() const throw();
 
-		void bind(GLenum);
-		void unbind();
-		bool is_bound(GLenum) const throw();
-
-		void load_raw(GLint, GLint, GLsizei, GLsizei, GLenum, GLenum, const GLvoid*) throw();
+		/*!
+			\brief Give the size of level 0 for a texture that is loaded from a smaller level first
+			\details Without it the size is estimated by doubling the loaded level, which is too small when
+			level 0 is not a power of two.
+		*/
+		void set_base_size(GLsizei, GLsizei);
+		void load_raw(GLint, GLint, GLsizei, GLsizei, GLenum, GLenum, const GLvoid*);
+		void load_raw(GLint, GLint, GLsizei, GLsizei, GLenum, GLenum, const GLvoid*, GLint);
+		void unload_level(GLint);
+		void set_level_range(GLint, GLint);
 
 		template<class C>
 		inline void load(const C* aData, GLsizei aWidth, GLsizei aHeight, GLint aInternalFormat = C::INTERNAL_FORMAT) {
 			load_raw(0, aInternalFormat, aWidth, aHeight, C::FORMAT, C::TYPE, aData);
 		}
+
+		/*!
+			\brief Upload a view, rows are read with its stride so a sub-view of a larger image is not copied
+		*/
+		template<class C>
+		inline void load(const image_view<C>& aImage, GLint aLevel = 0, GLint aInternalFormat = image_view<C>::colour_type::INTERNAL_FORMAT) {
+			typedef typename image_view<C>::colour_type colour_type;
+			load_raw(aLevel, aInternalFormat, aImage.get_width(), aImage.get_height(), colour_type::FORMAT, colour_type::TYPE, aImage.data(), static_cast<GLint>(aImage.get_stride()));
+		}
+
+		/*!
+			\brief Convert pixels to colour type A with convert_pixels and then upload them
+			\details For example converting linear colour_rgba_f data to colour_rgba_8u_srgb stores it as GL_SRGB8_ALPHA8.
+		*/
+		template<class A, class B>
+		inline void load_converted(const B* aData, GLsizei aWidth, GLsizei aHeight, GLint aLevel = 0) {
+			std::vector<A> pixels(static_cast<size_t>(aWidth) * static_cast<size_t>(aHeight));
+			convert_pixels<A, B>(aData, &pixels[0], pixels.size());
+			load_raw(aLevel, A::INTERNAL_FORMAT, aWidth, aHeight, A::FORMAT, A::TYPE, &pixels[0]);
+		}
+
+		// Inherited from texture
+
+		GLuint get_dimensions() const throw() override;
+		GLenum get_default_target() const throw() override;
 	};
 
 }}
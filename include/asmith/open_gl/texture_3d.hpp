@@ -0,0 +1,61 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+#ifndef ASMITH_OPENGL_TEXTURE_3D_HPP
+#define ASMITH_OPENGL_TEXTURE_3D_HPP
+
+#include "texture.hpp"
+
+namespace asmith { namespace gl {
+
+	/*!
+		\brief A volume texture addressed by three coordinates
+		\author Adam Smith
+		\date Created : 18th October 2026 Modified 18th October 2026
+		\version 1.0
+	*/
+	class texture_3d : public texture {
+	private:
+		GLsizei mWidth;
+		GLsizei mHeight;
+		GLsizei mDepth;
+	public:
+		texture_3d(context&);
+		~texture_3d();
+
+		GLsizei get_width() const throw();
+		GLsizei get_height() const throw();
+		GLsizei get_depth() const throw();
+
+		void load_raw(GLint, GLint, GLsizei, GLsizei, GLsizei, GLenum, GLenum, const GLvoid*);
+		void load_slice_raw(GLint, GLsizei, GLenum, GLenum, const GLvoid*);
+
+		template<class C>
+		inline void load(const C* aData, GLsizei aWidth, GLsizei aHeight, GLsizei aDepth, GLint aInternalFormat = C::INTERNAL_FORMAT) {
+			load_raw(0, aInternalFormat, aWidth, aHeight, aDepth, C::FORMAT, C::TYPE, aData);
+		}
+
+		template<class C>
+		inline void load_slice(GLsizei aSlice, const C* aData, GLint aLevel = 0) {
+			load_slice_raw(aLevel, aSlice, C::FORMAT, C::TYPE, aData);
+		}
+
+		// Inherited from texture
+
+		GLuint get_dimensions() const throw() override;
+		GLenum get_default_target() const throw() override;
+	};
+
+}}
+
+#endif
\ No newline at end of file
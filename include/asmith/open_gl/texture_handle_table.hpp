@@ -0,0 +1,74 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+#ifndef ASMITH_OPENGL_TEXTURE_HANDLE_TABLE_HPP
+#define ASMITH_OPENGL_TEXTURE_HANDLE_TABLE_HPP
+
+#include <vector>
+#include "texture.hpp"
+#include "vertex_buffer.hpp"
+
+namespace asmith { namespace gl {
+
+	/*!
+		\brief Maps material indices to textures, so that a draw only needs to know the index of its material
+		\details When ARB_bindless_texture is used every texture in the table is kept resident and its handle is
+		stored in a shader storage buffer, which a shader can declare as :
+		\code
+		#extension GL_ARB_bindless_texture : require
+		layout(std430, binding = 0) readonly buffer texture_handles { sampler2D textures[]; };
+		\endcode
+		Without the extension bind_fallback binds the texture to a texture unit, the caller then sets the sampler
+		uniform to the returned unit and calls unbind_fallback once the draw has been issued.
+		\author Adam Smith
+		\date Created : 18th October 2026 Modified 18th October 2026
+		\version 1.0
+	*/
+	class texture_handle_table {
+	private:
+		context& mContext;
+		std::vector<std::shared_ptr<texture>> mTextures;
+		std::vector<GLuint64> mHandles;
+		std::vector<GLuint> mFreeIndices;
+		std::shared_ptr<vertex_buffer> mBuffer;
+		size_t mDirtyBegin;
+		size_t mDirtyEnd;
+		bool mBindless;
+	private:
+		texture_handle_table(const texture_handle_table&) = delete;
+		texture_handle_table(texture_handle_table&&) = delete;
+		texture_handle_table& operator=(const texture_handle_table&) = delete;
+		texture_handle_table& operator=(texture_handle_table&&) = delete;
+
+		void mark_dirty(size_t) throw();
+	public:
+		texture_handle_table(context&);
+		texture_handle_table(context&, bool);
+		~texture_handle_table();
+
+		GLuint add(std::shared_ptr<texture>);
+		void set(GLuint, std::shared_ptr<texture>);
+		void remove(GLuint);
+		std::shared_ptr<texture> get(GLuint) const throw();
+		size_t size() const throw();
+		bool is_bindless() const throw();
+
+		void upload();
+		void bind(GLuint);
+		GLuint bind_fallback(GLuint);
+		void unbind_fallback(GLuint);
+	};
+
+}}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,103 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+#ifndef ASMITH_OPENGL_TEXTURE_STREAMER_HPP
+#define ASMITH_OPENGL_TEXTURE_STREAMER_HPP
+
+#include <functional>
+#include <vector>
+#include "texture_2d.hpp"
+
+namespace asmith { namespace gl {
+
+	/*!
+		\brief Streams the mip levels of texture_2d objects in and out of video memory within a fixed budget
+		\details Each frame the caller requests the screen space size that a texture is drawn at, update then
+		loads the levels that are needed, finest last, using the loader of the texture. When a load would exceed
+		the budget, levels are released from the least recently requested textures first. The coarsest level of
+		a texture is never released once it has been loaded. Streamed textures change their base level and so
+		cannot be used with bindless handles.
+		\author Adam Smith
+		\date Created : 18th October 2026 Modified 18th October 2026
+		\version 1.0
+	*/
+	class texture_streamer {
+	public:
+		typedef std::function<void(texture_2d&, GLint)> loader;
+
+		struct statistics {
+			size_t resident_bytes;
+			size_t resident_textures;
+			size_t levels_streamed_in;
+			size_t levels_streamed_out;
+			size_t evictions;
+			size_t budget_misses;
+		};
+	private:
+		struct entry {
+			std::shared_ptr<texture_2d> texture;
+			loader load;
+			GLsizei width;
+			GLsizei height;
+			GLint level_count;
+			GLint requested_level;
+			GLint resident_level;
+			size_t bytes;
+			float priority;
+			uint64_t last_requested;
+		};
+
+		context& mContext;
+		std::vector<entry> mEntries;
+		std::vector<GLuint> mFreeIndices;
+		statistics mStatistics;
+		size_t mBudget;
+		size_t mUsage;
+		uint64_t mFrame;
+		GLuint mUploadLimit;
+	private:
+		texture_streamer(const texture_streamer&) = delete;
+		texture_streamer(texture_streamer&&) = delete;
+		texture_streamer& operator=(const texture_streamer&) = delete;
+		texture_streamer& operator=(texture_streamer&&) = delete;
+
+		size_t estimate_level_size(const entry&, GLint) const throw();
+		bool make_room(size_t, size_t);
+		void stream_in(entry&);
+		void stream_out(entry&);
+		void update_usage(entry&) throw();
+	public:
+		texture_streamer(context&, size_t);
+		~texture_streamer();
+
+		GLuint add(std::shared_ptr<texture_2d>, GLsizei, GLsizei, loader, float = 1.f);
+		void remove(GLuint);
+		std::shared_ptr<texture_2d> get(GLuint) const throw();
+
+		void set_priority(GLuint, float);
+		void request(GLuint, GLsizei, GLsizei);
+		void update();
+
+		void set_budget(size_t) throw();
+		size_t get_budget() const throw();
+		size_t get_memory_usage() const throw();
+		void set_upload_limit(GLuint) throw();
+		GLuint get_upload_limit() const throw();
+
+		statistics get_statistics() const throw();
+		void reset_statistics() throw();
+	};
+
+}}
+
+#endif
\ No newline at end of file
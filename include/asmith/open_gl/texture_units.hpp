@@ -0,0 +1,68 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+#ifndef ASMITH_OPENGL_TEXTURE_UNITS_HPP
+#define ASMITH_OPENGL_TEXTURE_UNITS_HPP
+
+#include <memory>
+#include "texture.hpp"
+
+namespace asmith { namespace gl {
+
+	namespace implementation {
+		struct texture_unit {
+			std::weak_ptr<texture> bound_texture;
+			GLenum target;
+			uint64_t last_used;
+		};
+	}
+
+	/*!
+		\brief Assigns textures to texture image units, keeping recently used textures resident to avoid rebinding
+		\details Textures stay bound to their unit after texture::unbind, units are only reused when a texture
+		that is not currently bound needs one, the least recently used unit is chosen.
+		\author Adam Smith
+		\date Created : 18th October 2026 Modified 18th October 2026
+		\version 1.0
+	*/
+	class texture_units {
+	public:
+		struct statistics {
+			size_t binds;
+			size_t hits;
+			size_t evictions;
+			size_t multi_bind_calls;
+		};
+	private:
+		texture_units() = delete;
+
+		static GLuint find_unit(context&, uint64_t);
+		static void assign(context&, texture&, GLuint, GLenum, uint64_t) throw();
+	public:
+		static GLuint bind(context&, texture&, GLenum);
+		static void bind(context&, texture* const*, size_t, GLuint*);
+		static GLint get_unit(context&, const texture&) throw();
+		static std::shared_ptr<texture> get_texture_bound_to(context&, GLuint) throw();
+		static GLuint get_unit_count(context&) throw();
+		static void activate(context&, GLuint) throw();
+
+		static void set_multi_bind(context&, bool) throw();
+		static bool is_multi_bind_enabled(context&) throw();
+
+		static const statistics& get_statistics(context&) throw();
+		static void reset_statistics(context&) throw();
+	};
+
+}}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,73 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+#ifndef ASMITH_OPENGL_THREAD_POOL_HPP
+#define ASMITH_OPENGL_THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "core.hpp"
+
+namespace asmith { namespace gl {
+
+	/*!
+		\brief A fixed set of worker threads for splitting CPU side work, such as image processing, into ranges
+		\details No OpenGL functions may be called from a task, the worker threads do not have a current context.
+		\author Adam Smith
+		\date Created : 18th October 2026 Modified 18th October 2026
+		\version 1.0
+	*/
+	class thread_pool {
+	public:
+		typedef std::function<void(size_t, size_t)> range_function;
+	private:
+		std::vector<std::thread> mThreads;
+		std::deque<std::function<void()>> mTasks;
+		std::mutex mLock;
+		std::condition_variable mCondition;
+		bool mExit;
+	private:
+		thread_pool(const thread_pool&) = delete;
+		thread_pool(thread_pool&&) = delete;
+		thread_pool& operator=(const thread_pool&) = delete;
+		thread_pool& operator=(thread_pool&&) = delete;
+
+		void worker();
+		bool run_one();
+	public:
+		thread_pool();
+		thread_pool(size_t);
+		~thread_pool();
+
+		size_t get_thread_count() const throw();
+
+		/*!
+			\brief Call a function on sub-ranges of [aBegin, aEnd) and wait for all of them to finish
+			\details The calling thread also executes ranges, so this may be called from inside a task.
+			\param aBegin The first index
+			\param aEnd One past the last index
+			\param aGrain The minimum number of indices given to one call
+			\param aFunction Called with the first and one past the last index of each sub-range
+		*/
+		void parallel_for(size_t aBegin, size_t aEnd, size_t aGrain, const range_function& aFunction);
+
+		static thread_pool& get_default();
+	};
+
+}}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,168 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+#ifndef ASMITH_OPENGL_UNIFORM_BLOCK_HPP
+#define ASMITH_OPENGL_UNIFORM_BLOCK_HPP
+
+#include <string>
+#include <vector>
+#include "program.hpp"
+#include "vertex_buffer.hpp"
+
+namespace asmith { namespace gl {
+
+	namespace implementation {
+		// The GLSL type, array size and array element size of a block member
+		template<class T, bool SCALAR = uniform_glsl_type<T>::value != GL_NONE>
+		struct block_member_traits {
+			enum : GLenum { type = GL_NONE };
+			enum : GLint { array_size = 0 };
+			enum : size_t { element_size = 0 };
+		};
+
+		template<class T>
+		struct block_member_traits<T, true> {
+			enum : GLenum { type = uniform_glsl_type<T>::value };
+			enum : GLint { array_size = 1 };
+			enum : size_t { element_size = sizeof(T) };
+		};
+
+		template<class T, size_t N>
+		struct block_member_traits<T[N], false> {
+			enum : GLenum { type = uniform_glsl_type<T>::value };
+			enum : GLint { array_size = uniform_glsl_type<T>::value == GL_NONE ? 0 : static_cast<GLint>(N) };
+			enum : size_t { element_size = sizeof(T) };
+		};
+	}
+
+	/*!
+		\brief The buffer and layout of a uniform or shader storage block, see uniform_block
+		\author Adam Smith
+		\date Created : 18th October 2026 Modified 18th October 2026
+		\version 1.0
+	*/
+	class buffer_block {
+	protected:
+		struct member {
+			std::string name;
+			size_t offset;
+			size_t element_size;
+			GLenum type;
+			GLint array_size;
+		};
+
+		context& mContext;
+		std::shared_ptr<vertex_buffer> mBuffer;
+		std::vector<member> mMembers;
+		size_t mSize;
+		GLenum mTarget;
+		GLuint mBinding;
+		bool mDirty;
+	private:
+		buffer_block(const buffer_block&) = delete;
+		buffer_block(buffer_block&&) = delete;
+		buffer_block& operator=(const buffer_block&) = delete;
+		buffer_block& operator=(buffer_block&&) = delete;
+
+		void validate(const program&, const program::block_info&) const;
+	protected:
+		buffer_block(context&, GLenum, GLuint, size_t);
+
+		void add_member(const GLchar*, size_t, GLenum, GLint, size_t);
+		void upload(const void*);
+	public:
+		virtual ~buffer_block();
+
+		/*!
+			\brief Check the layout of a block in a linked program against the C++ struct, then bind it to this block
+			\details Each member that was added must be an active member of the block with a matching type, offset,
+			array stride and matrix stride, otherwise this throws with the first difference. Members of the
+			block that were not added are not checked.
+		*/
+		void attach(program&, const GLchar*);
+		void bind();
+
+		GLenum get_target() const throw();
+		GLuint get_binding() const throw();
+		std::shared_ptr<vertex_buffer> get_buffer() const throw();
+	};
+
+	/*!
+		\brief A uniform or shader storage block whose contents are a C++ struct
+		\details The members of the struct are described once, and then checked against the block layout of each
+		program it is attached to. One block can be attached to any number of programs, it is uploaded at most
+		once between binds no matter how many programs use it.
+		\code
+		struct camera_data { mat4 view; mat4 projection; vec4f position; };
+		uniform_block<camera_data> camera(context, 0);
+		camera.add_member("view", &camera_data::view);
+		camera.add_member("projection", &camera_data::projection);
+		camera.add_member("position", &camera_data::position);
+		camera.attach(program, "camera");
+		camera.edit().position = ...;
+		camera.bind();
+		\endcode
+		Both std140 and std430 round the stride of vec3 array elements and of matrix columns up to 16 bytes, only
+		std430 keeps mat2 columns at 8. mat3 members are rejected at compile time, use a mat4 or one vec4 member
+		for each column instead.
+		\author Adam Smith
+		\date Created : 18th October 2026 Modified 18th October 2026
+		\version 1.1
+	*/
+	template<class T>
+	class uniform_block : public buffer_block {
+	private:
+		T mValue;
+	public:
+		uniform_block(context& aContext, GLuint aBinding, GLenum aTarget = GL_UNIFORM_BUFFER) :
+			buffer_block(aContext, aTarget, aBinding, sizeof(T)),
+			mValue()
+		{}
+
+		template<class M>
+		uniform_block& add_member(const GLchar* aName, M T::* aMember) {
+			typedef implementation::block_member_traits<M> traits;
+			static_assert(traits::type != GL_NONE && traits::array_size > 0, "asmith::gl::uniform_block::add_member : Type cannot be used in a block");
+			static_assert(traits::type != GL_FLOAT_MAT3, "asmith::gl::uniform_block::add_member : mat3 columns are padded to 16 bytes in a block, use mat4 or vec4 columns");
+			const size_t offset = reinterpret_cast<const uint8_t*>(&(mValue.*aMember)) - reinterpret_cast<const uint8_t*>(&mValue);
+			buffer_block::add_member(aName, offset, traits::type, traits::array_size, traits::element_size);
+			return *this;
+		}
+
+		inline const T& get() const throw() {
+			return mValue;
+		}
+
+		inline T& edit() throw() {
+			mDirty = true;
+			return mValue;
+		}
+
+		inline void set(const T& aValue) {
+			mValue = aValue;
+			mDirty = true;
+		}
+
+		inline void upload() {
+			buffer_block::upload(&mValue);
+		}
+
+		inline void bind() {
+			upload();
+			buffer_block::bind();
+		}
+	};
+
+}}
+
+#endif
\ No newline at end of file
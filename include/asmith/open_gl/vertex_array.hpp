@@ -21,9 +21,15 @@ namespace asmith { namespace gl {
 	
 	/*!
 		\brief Base class for OpenGL vertex array objects (VAO)
+		\details Attributes are enabled once when they are added, the VAO remembers it. draw_arrays binds the VAO
+		for the draw unless it is already bound with bind, which lets a sequence of draws share one bind. While
+		a VAO is bound, binding a buffer to GL_ELEMENT_ARRAY_BUFFER changes the VAO.
+
+		Attributes with a divisor advance once per divisor instances. Without base instance support
+		draw_arrays_instanced moves the pointers of those attributes to the first instance instead.
 		\author Adam Smith
-		\date Created : 22nd June 2017 Modified 30th June 2017
-		\version 1.2
+		\date Created : 22nd June 2017 Modified 18th October 2026
+		\version 1.4
 	*/
 	class vertex_array : public object {
 	public:
@@ -33,17 +39,32 @@ namespace asmith { namespace gl {
 			GLboolean normalised;
 			GLsizei stride;
 			const GLvoid* pointer;
+			GLuint divisor;
 		};
 	private:
 		std::vector<vertex_attribute> mAttributes;
 		std::vector<std::shared_ptr<vertex_buffer>> mBuffers;
+#if ASMITH_GL_VERSION_GE(3,3)
+		mutable GLuint mBaseInstance;
+#endif
 	public:
+		static bool is_instancing_supported() throw();
+		static bool is_base_instance_supported() throw();
+
 		vertex_array(context& aContext);
 		~vertex_array();
 
 		GLuint add_attribute(std::shared_ptr<vertex_buffer>, const vertex_attribute&);
+		GLuint get_attribute_count() const throw();
+
+		void bind() throw();
+		void unbind() throw();
+		bool is_currently_bound() const throw();
 
 		void draw_arrays(GLenum, GLint, GLsizei) const throw();
+#if ASMITH_GL_VERSION_GE(3,3)
+		void draw_arrays_instanced(GLenum, GLint, GLsizei, GLsizei, GLuint = 0) const throw();
+#endif
 	};
 }}
 
@@ -21,8 +21,8 @@ namespace asmith { namespace gl {
 	/*!
 		\brief Base class for OpenGL shader objects
 		\author Adam Smith
-		\date Created : 4th November 2015 Modified 30th June 2017
-		\version 2.4
+		\date Created : 4th November 2015 Modified 18th October 2026
+		\version 2.5
 	*/
 	class vertex_buffer : public object {
 	private:
@@ -53,6 +53,15 @@ namespace asmith { namespace gl {
 		bool is_bound() const throw();
 		GLenum get_bind_target() const throw();
 
+		/*!
+			\brief Bind to an indexed binding point of GL_UNIFORM_BUFFER, GL_SHADER_STORAGE_BUFFER,
+			GL_ATOMIC_COUNTER_BUFFER or GL_TRANSFORM_FEEDBACK_BUFFER
+			\details The generic binding point of the target is left unchanged. bind_range fails if the offset is not
+			a multiple of the offset alignment of the target, or the range is outside of the buffer.
+		*/
+		bool bind_base(GLenum, GLuint) throw();
+		bool bind_range(GLenum, GLuint, GLintptr, GLsizeiptr) throw();
+
 		GLsizeiptr size() const throw();
 
 #if ASMITH_GL_VERSION_GE(3, 0)	
@@ -18,7 +18,16 @@ namespace asmith { namespace gl { namespace implementation {
 	// context_state
 
 	context_state::context_state() :
-		lighting_enabled(false)
+		currently_bound_vertex_array(0),
+		lighting_enabled(false),
+		texture_unit_statistics{ 0, 0, 0, 0 },
+		texture_unit_clock(0),
+		active_texture_unit(0),
+#if ASMITH_GL_VERSION_GE(4,4)
+		texture_multi_bind(true)
+#else
+		texture_multi_bind(false)
+#endif
 	{}
 
 }}}
\ No newline at end of file
@@ -0,0 +1,34 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+#include "asmith/open_gl/image.hpp"
+#include <cstdlib>
+
+namespace asmith { namespace gl { namespace implementation {
+
+	void* aligned_allocate(size_t aBytes, size_t aAlignment) {
+		// Over allocate and store the address returned by malloc in front of the aligned block
+		void* const base = std::malloc(aBytes + aAlignment + sizeof(void*));
+		if(base == nullptr) throw std::bad_alloc();
+		const uintptr_t address = reinterpret_cast<uintptr_t>(base) + sizeof(void*);
+		void** const aligned = reinterpret_cast<void**>((address + aAlignment - 1) & ~static_cast<uintptr_t>(aAlignment - 1));
+		aligned[-1] = base;
+		return aligned;
+	}
+
+	void aligned_free(void* aPointer) throw() {
+		if(aPointer == nullptr) return;
+		std::free(static_cast<void**>(aPointer)[-1]);
+	}
+
+}}}
\ No newline at end of file
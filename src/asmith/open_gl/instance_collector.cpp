@@ -0,0 +1,176 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+#include "asmith/open_gl/instance_collector.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#if ASMITH_GL_VERSION_GE(3,3)
+namespace asmith { namespace gl {
+
+	static uint64_t hash_geometry(const render_queue::packet& aPacket) throw() {
+		uint64_t hash = render_queue::hash_material(aPacket);
+		hash = implementation::hash_fnv1a(&aPacket.vao, sizeof(aPacket.vao), hash);
+		hash = implementation::hash_fnv1a(&aPacket.first, sizeof(aPacket.first), hash);
+		return implementation::hash_fnv1a(&aPacket.count, sizeof(aPacket.count), hash);
+	}
+
+	static bool same_geometry(const render_queue::packet& a, const render_queue::packet& b) throw() {
+		return a.vao == b.vao && a.first == b.first && a.count == b.count && render_queue::same_material(a, b);
+	}
+
+	// instance_collector
+
+	instance_collector::instance_collector(context& aContext, GLuint aFirstAttribute) :
+		mContext(aContext),
+		mFirstAttribute(aFirstAttribute),
+		mBuffer(new vertex_buffer(aContext)),
+		mCapacity(0),
+		mQueue(nullptr),
+		mQueueGeneration(0),
+		mStatistics{ 0, 0, 0, 0 }
+	{
+		mBuffer->set_usage(GL_STREAM_DRAW);
+	}
+
+	instance_collector::~instance_collector() {
+
+	}
+
+	GLuint instance_collector::get_first_attribute() const throw() {
+		return mFirstAttribute;
+	}
+
+	void instance_collector::prepare(vertex_array& aVao) {
+		const auto i = mPrepared.find(&aVao);
+		if(i != mPrepared.end() && i->second.lock().get() == &aVao) return;
+
+		if(aVao.get_attribute_count() != mFirstAttribute) throw std::runtime_error("asmith::gl::instance_collector::submit : Vertex array does not end at the first instance attribute");
+		const GLsizei stride = sizeof(instance);
+		for(size_t c = 0; c < 4; ++c) {
+			aVao.add_attribute(mBuffer, { 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(sizeof(GLfloat) * 4 * c), 1 });
+		}
+		aVao.add_attribute(mBuffer, { 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(sizeof(mat4)), 1 });
+		mPrepared[&aVao] = aVao.shared_from_this();
+	}
+
+	void instance_collector::add(const render_queue::packet& aPacket, const mat4& aTransform, const vec4f& aColour) {
+		if(aPacket.vao == nullptr) throw std::runtime_error("asmith::gl::instance_collector::add : Vertex array is null");
+		if(mInstances.size() >= UINT32_MAX) throw std::runtime_error("asmith::gl::instance_collector::add : Too many draws");
+
+		const uint64_t hash = hash_geometry(aPacket);
+		uint32_t g = UINT32_MAX;
+		const auto range = mGroupIndex.equal_range(hash);
+		for(auto i = range.first; i != range.second; ++i) {
+			if(same_geometry(mGroups[i->second].packet, aPacket)) {
+				g = i->second;
+				break;
+			}
+		}
+		if(g == UINT32_MAX) {
+			g = static_cast<uint32_t>(mGroups.size());
+			mGroups.push_back(group{ aPacket, 0, 0 });
+			mGroupIndex.emplace(hash, g);
+		}else if(aPacket.depth < mGroups[g].packet.depth) {
+			// The group is sorted by its nearest instance
+			mGroups[g].packet.depth = aPacket.depth;
+		}
+		++mGroups[g].count;
+
+		instance tmp;
+		std::memcpy(&tmp.transform, &aTransform, sizeof(mat4));
+		std::memcpy(&tmp.colour, &aColour, sizeof(vec4f));
+		mInstances.push_back(tmp);
+		mInstanceGroups.push_back(g);
+	}
+
+	size_t instance_collector::size() const throw() {
+		return mInstances.size();
+	}
+
+	void instance_collector::clear() throw() {
+		mGroups.clear();
+		mGroupIndex.clear();
+		mInstances.clear();
+		mInstanceGroups.clear();
+	}
+
+	void instance_collector::submit(render_queue& aQueue) {
+		const size_t count = mInstances.size();
+		if(count == 0) return;
+
+		// Packets submitted earlier are drawn from the same buffer until the queue has executed them
+		if(mQueue != &aQueue || mQueueGeneration != aQueue.get_generation()) {
+			mQueue = &aQueue;
+			mQueueGeneration = aQueue.get_generation();
+			mPacked.clear();
+		}
+		const size_t first = mPacked.size();
+		const size_t total = first + count;
+		if(total > UINT32_MAX) throw std::runtime_error("asmith::gl::instance_collector::submit : Too many instances before the queue was executed");
+
+		// Counting sort the instances by group so that each group is one range of the buffer
+		GLuint offset = static_cast<GLuint>(first);
+		for(group& i : mGroups) {
+			i.base = offset;
+			offset += i.count;
+		}
+		mPacked.resize(total);
+		mCursors.resize(mGroups.size());
+		for(size_t i = 0; i < mGroups.size(); ++i) mCursors[i] = mGroups[i].base;
+		for(size_t i = 0; i < count; ++i) mPacked[mCursors[mInstanceGroups[i]]++] = mInstances[i];
+
+		size_t uploaded;
+		if(total > mCapacity) {
+			// New storage does not have the instances of the earlier calls, so they are sent again
+			mCapacity = std::max(total, mCapacity * 2);
+			mBuffer->buffer(nullptr, mCapacity * sizeof(instance));
+			mBuffer->sub_buffer(0, mPacked.data(), total * sizeof(instance));
+			uploaded = total;
+		}else {
+			// Respecifying the storage at the start of a frame lets the driver keep the previous frame's data for draws that are still in flight
+			if(first == 0) mBuffer->buffer(nullptr, mCapacity * sizeof(instance));
+			mBuffer->sub_buffer(static_cast<GLintptr>(first * sizeof(instance)), mPacked.data() + first, count * sizeof(instance));
+			uploaded = count;
+		}
+
+		for(group& i : mGroups) {
+			prepare(*i.packet.vao);
+			render_queue::packet p = i.packet;
+			p.instance_count = static_cast<GLsizei>(i.count);
+			p.base_instance = i.base;
+			aQueue.submit(p);
+		}
+
+		if(first == 0) ++mStatistics.frames;
+		mStatistics.draws += count;
+		mStatistics.instanced_draws += mGroups.size();
+		mStatistics.bytes_uploaded += uploaded * sizeof(instance);
+		clear();
+	}
+
+	instance_collector::statistics instance_collector::get_statistics() const throw() {
+		return mStatistics;
+	}
+
+	void instance_collector::reset_statistics() throw() {
+		mStatistics = statistics{ 0, 0, 0, 0 };
+	}
+
+	double instance_collector::get_collapse_ratio() const throw() {
+		return mStatistics.instanced_draws == 0 ? 0.0 : static_cast<double>(mStatistics.draws) / static_cast<double>(mStatistics.instanced_draws);
+	}
+
+}}
+#endif
\ No newline at end of file
@@ -63,7 +63,8 @@ namespace asmith { namespace gl {
 		mExponent(30),
 		mCutoff(180),
 		mID(aID),
-		mEnabled(false)
+		mEnabled(false),
+		mSynchronised(false)
 	{}
 
 	light::~light() throw() {
@@ -73,17 +74,21 @@ namespace asmith { namespace gl {
 	void light::enable() throw() {
 		if(mEnabled) return;
 		glEnable(mID);
+		mEnabled = true;
+		// GL_POSITION and GL_SPOT_DIRECTION are transformed by the modelview matrix when they are sent, so they
+		// are sent again for the current camera. The other parameters are sent by their setters, so only the first time.
 		set_position(get_position());
+		set_spot_direction(get_spot_direction());
+		if(mSynchronised) return;
+		mSynchronised = true;
 		set_ambient(get_ambient());
 		set_diffuse(get_diffuse());
 		set_specular(get_specular());
-		set_spot_direction(get_spot_direction());
 		set_spot_exponent(get_spot_exponent());
 		set_spot_cutoff(get_spot_cutoff());
 		set_constant_attenuation(get_constant_attenuation());
 		set_linear_attenuation(get_linear_attenuation());
 		set_quadratic_attenuation(get_quadratic_attenuation());
-		mEnabled = true;
 	}
 
 	void light::disable() throw() {
@@ -0,0 +1,229 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+#include "asmith/open_gl/light_set.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#if ASMITH_GL_VERSION_GE(4,3)
+namespace asmith { namespace gl {
+
+	enum : size_t {
+		// Clean lights between two dirty ones are sent again if the gap is at most this many lights
+		MERGE_GAP = 4
+	};
+
+	static_assert(sizeof(light_set::light_data) == sizeof(GLfloat) * 24, "asmith::gl::light_set::light_data does not match the std430 layout");
+
+	// light_set
+
+	bool light_set::is_supported() throw() {
+		return GLEW_VERSION_4_3 || GLEW_ARB_shader_storage_buffer_object ? true : false;
+	}
+
+	light_set::light_data light_set::convert(const light& aLight) throw() {
+		light_data tmp;
+		std::memcpy(&tmp.position, &aLight.get_position(), sizeof(vec4f));
+		std::memcpy(&tmp.ambient, &aLight.get_ambient(), sizeof(vec4f));
+		std::memcpy(&tmp.diffuse, &aLight.get_diffuse(), sizeof(vec4f));
+		std::memcpy(&tmp.specular, &aLight.get_specular(), sizeof(vec4f));
+		std::memcpy(&tmp.spot_direction, &aLight.get_spot_direction(), sizeof(vec3f));
+		tmp.spot_exponent = static_cast<GLfloat>(aLight.get_spot_exponent());
+		const GLfloat attenuation[3] = { aLight.get_constant_attenuation(), aLight.get_linear_attenuation(), aLight.get_quadratic_attenuation() };
+		std::memcpy(&tmp.attenuation, attenuation, sizeof(vec3f));
+		// A cutoff of 180 degrees is not a spot light, its cosine of -1 lets every direction through
+		tmp.spot_cos_cutoff = std::cos(static_cast<GLfloat>(aLight.get_spot_cutoff()) * 0.01745329252f);
+		return tmp;
+	}
+
+	light_set::light_set(context& aContext, GLuint aBinding) :
+		mContext(aContext),
+		mBinding(aBinding),
+		mCountChanged(true),
+		mStatistics{ 0, 0, 0 }
+	{
+		if(! is_supported()) throw std::runtime_error("asmith::gl::light_set::light_set : Shader storage buffers are not supported");
+		mBuffer.reset(new vertex_buffer(aContext));
+		mBuffer->set_usage(GL_DYNAMIC_DRAW);
+	}
+
+	light_set::~light_set() {
+
+	}
+
+	uint32_t light_set::get_index(handle aHandle, const char* aFunction) const {
+		if(! is_valid(aHandle)) throw std::runtime_error(std::string("asmith::gl::light_set::") + aFunction + " : Invalid handle");
+		return mIndices[aHandle];
+	}
+
+	void light_set::mark_dirty(uint32_t aIndex) throw() {
+		if(mDirty[aIndex]) return;
+		mDirty[aIndex] = 1;
+		mDirtyIndices.push_back(aIndex);
+	}
+
+	light_set::handle light_set::add(const light_data& aLight) {
+		if(mLights.size() >= UINT32_MAX - 1) throw std::runtime_error("asmith::gl::light_set::add : Too many lights");
+
+		handle h;
+		if(mFreeHandles.empty()) {
+			h = static_cast<handle>(mIndices.size());
+			mIndices.push_back(0);
+		}else {
+			h = mFreeHandles.back();
+			mFreeHandles.pop_back();
+		}
+
+		const uint32_t index = static_cast<uint32_t>(mLights.size());
+		mIndices[h] = index;
+		mLights.push_back(aLight);
+		mHandles.push_back(h);
+		mDirty.push_back(0);
+		mark_dirty(index);
+		mCountChanged = true;
+		return h;
+	}
+
+	light_set::handle light_set::add(const light& aLight) {
+		return add(convert(aLight));
+	}
+
+	void light_set::remove(handle aHandle) {
+		const uint32_t index = get_index(aHandle, "remove");
+		const uint32_t last = static_cast<uint32_t>(mLights.size() - 1);
+		if(index != last) {
+			// Keep the lights packed by moving the last one into the gap
+			mLights[index] = mLights[last];
+			mHandles[index] = mHandles[last];
+			mIndices[mHandles[index]] = index;
+			mark_dirty(index);
+		}
+		mLights.pop_back();
+		mHandles.pop_back();
+		mDirty.pop_back();
+		mIndices[aHandle] = UINT32_MAX;
+		mFreeHandles.push_back(aHandle);
+		mCountChanged = true;
+	}
+
+	void light_set::clear() throw() {
+		mLights.clear();
+		mHandles.clear();
+		mIndices.clear();
+		mFreeHandles.clear();
+		mDirty.clear();
+		mDirtyIndices.clear();
+		mCountChanged = true;
+	}
+
+	bool light_set::is_valid(handle aHandle) const throw() {
+		return aHandle < mIndices.size() && mIndices[aHandle] != UINT32_MAX;
+	}
+
+	size_t light_set::size() const throw() {
+		return mLights.size();
+	}
+
+	void light_set::reserve(size_t aCount) {
+		mLights.reserve(aCount);
+		mHandles.reserve(aCount);
+		mIndices.reserve(aCount);
+		mDirty.reserve(aCount);
+	}
+
+	const light_set::light_data& light_set::get(handle aHandle) const {
+		return mLights[get_index(aHandle, "get")];
+	}
+
+	light_set::light_data& light_set::edit(handle aHandle) {
+		const uint32_t index = get_index(aHandle, "edit");
+		mark_dirty(index);
+		return mLights[index];
+	}
+
+	void light_set::set(handle aHandle, const light_data& aLight) {
+		const uint32_t index = get_index(aHandle, "set");
+		mLights[index] = aLight;
+		mark_dirty(index);
+	}
+
+	void light_set::attach(program& aProgram, const GLchar* aName) {
+		if(! aProgram.is_linked()) throw std::runtime_error("asmith::gl::light_set::attach : Program has not been linked");
+		const program::block_info* const b = aProgram.find_storage_block(aName);
+		if(b == nullptr) throw std::runtime_error(std::string("asmith::gl::light_set::attach : Program has no storage block named '") + aName + "'");
+		aProgram.set_storage_block_binding(b->index, mBinding);
+	}
+
+	void light_set::upload() {
+		const size_t count = mLights.size();
+		const GLsizeiptr bytes = static_cast<GLsizeiptr>(sizeof(header) + count * sizeof(light_data));
+
+		if(mBuffer->size() < bytes) {
+			// Grow geometrically so that adding lights does not reallocate the buffer every frame
+			GLsizeiptr capacity = mBuffer->size() > 0 ? mBuffer->size() : static_cast<GLsizeiptr>(sizeof(header) + sizeof(light_data) * 64);
+			while(capacity < bytes) capacity *= 2;
+			mBuffer->buffer(nullptr, capacity);
+			for(uint32_t i = 0; i < count; ++i) mark_dirty(i);
+			mCountChanged = true;
+		}
+
+		if(mCountChanged) {
+			const header h = { static_cast<GLuint>(count), { 0, 0, 0 } };
+			mBuffer->sub_buffer(0, &h, sizeof(header));
+			++mStatistics.ranges_uploaded;
+			mStatistics.bytes_uploaded += sizeof(header);
+			mCountChanged = false;
+		}
+
+		if(! mDirtyIndices.empty()) {
+			// Removing lights can leave indices that are past the end
+			std::sort(mDirtyIndices.begin(), mDirtyIndices.end());
+			size_t i = 0;
+			const size_t dirtyCount = mDirtyIndices.size();
+			while(i < dirtyCount && mDirtyIndices[i] < count) {
+				const uint32_t begin = mDirtyIndices[i];
+				uint32_t end = begin + 1;
+				for(++i; i < dirtyCount && mDirtyIndices[i] < count && mDirtyIndices[i] <= end + MERGE_GAP; ++i) end = mDirtyIndices[i] + 1;
+
+				const size_t rangeBytes = (end - begin) * sizeof(light_data);
+				mBuffer->sub_buffer(static_cast<GLintptr>(sizeof(header) + begin * sizeof(light_data)), &mLights[begin], static_cast<GLsizeiptr>(rangeBytes));
+				++mStatistics.ranges_uploaded;
+				mStatistics.bytes_uploaded += rangeBytes;
+			}
+			for(uint32_t j : mDirtyIndices) if(j < count) mDirty[j] = 0;
+			mDirtyIndices.clear();
+		}
+		++mStatistics.uploads;
+	}
+
+	void light_set::bind() {
+		upload();
+		mBuffer->bind_base(GL_SHADER_STORAGE_BUFFER, mBinding);
+	}
+
+	GLuint light_set::get_binding() const throw() {
+		return mBinding;
+	}
+
+	light_set::statistics light_set::get_statistics() const throw() {
+		return mStatistics;
+	}
+
+	void light_set::reset_statistics() throw() {
+		mStatistics = statistics{ 0, 0, 0 };
+	}
+
+}}
+#endif
\ No newline at end of file
@@ -219,17 +219,17 @@ namespace asmith { namespace gl {
 		if(normals.empty()) normals.push_back({0.f, 0.f, 1.f});
 	}
 
-	std::shared_ptr<vertex_array> obj::create_vao(context& aContext, GLsizei & aVerts) const {
-		struct vertex {
-			vec3f v;
-			vec2f t;
-			vec3f n;
-		};
+	void obj::add_attributes(vertex_array& aVao, std::shared_ptr<vertex_buffer> aVbo) {
+		aVao.add_attribute(aVbo, { 3, GL_FLOAT, GL_FALSE, sizeof(vertex), (GLvoid*)(0), 0 });
+		aVao.add_attribute(aVbo, { 2, GL_FLOAT, GL_FALSE, sizeof(vertex), (GLvoid*)(sizeof(GLfloat) * 3), 0 });
+		aVao.add_attribute(aVbo, { 3, GL_FLOAT, GL_FALSE, sizeof(vertex), (GLvoid*)(sizeof(GLfloat) * 5), 0 });
+	}
 
-		aVerts = 0;
-		for(const object& o : objects) for(const group& g : o.groups) aVerts += g.faces.size();
+	std::vector<obj::vertex> obj::create_vertices() const {
+		size_t faces = 0;
+		for(const object& o : objects) for(const group& g : o.groups) faces += g.faces.size();
 
-		std::vector<vertex> model(aVerts * 3);
+		std::vector<vertex> model(faces * 3);
 		size_t index = 0;
 		for(const object& obj : objects) {
 			for(const group& grp : obj.groups) {
@@ -247,7 +247,6 @@ namespace asmith { namespace gl {
 					}else {
 						// Non-triangular faces
 						const size_t newVerts = (p.count - 3) * 3;
-						aVerts += newVerts;
 						for(size_t j = 0; j < newVerts; ++j) model.push_back(vertex());
 						for(size_t j = 1; j < p.count - 1; ++j) {
 							vertex& v1 = model[index++];
@@ -270,15 +269,19 @@ namespace asmith { namespace gl {
 				}
 			}
 		}
+		return model;
+	}
+
+	std::shared_ptr<vertex_array> obj::create_vao(context& aContext, GLsizei & aVerts) const {
+		const std::vector<vertex> model = create_vertices();
+		aVerts = static_cast<GLsizei>(model.size());
+
 		std::shared_ptr<gl::vertex_buffer> vbo(new gl::vertex_buffer(aContext));
 		std::shared_ptr<gl::vertex_array> vao(new gl::vertex_array(aContext));
 
 		vbo->set_usage(GL_STATIC_DRAW);
 		vbo->buffer(&model[0], model.size() * sizeof(vertex));
-
-		vao->add_attribute(vbo, { 3, GL_FLOAT, GL_FALSE, sizeof(vertex), (GLvoid*)(0) });
-		vao->add_attribute(vbo, { 2, GL_FLOAT, GL_FALSE, sizeof(vertex), (GLvoid*)(sizeof(GLfloat) * 3) });
-		vao->add_attribute(vbo, { 3, GL_FLOAT, GL_FALSE, sizeof(vertex), (GLvoid*)(sizeof(GLfloat) * 5) });
+		add_attributes(*vao, vbo);
 
 		return vao;
 	}
@@ -12,16 +12,159 @@
 //	limitations under the License.
 
 #include "asmith/open_gl/program.hpp"
+#include <cstring>
 #include <string>
 #include "asmith/open_gl/context_state.hpp"
 
 namespace asmith { namespace gl {
+
+	static bool is_sampler_type(GLenum aType) throw() {
+		switch(aType) {
+		case GL_SAMPLER_1D:
+		case GL_SAMPLER_2D:
+		case GL_SAMPLER_3D:
+		case GL_SAMPLER_CUBE:
+		case GL_SAMPLER_1D_SHADOW:
+		case GL_SAMPLER_2D_SHADOW:
+		case GL_SAMPLER_1D_ARRAY:
+		case GL_SAMPLER_2D_ARRAY:
+		case GL_SAMPLER_1D_ARRAY_SHADOW:
+		case GL_SAMPLER_2D_ARRAY_SHADOW:
+		case GL_SAMPLER_2D_MULTISAMPLE:
+		case GL_SAMPLER_2D_MULTISAMPLE_ARRAY:
+		case GL_SAMPLER_CUBE_SHADOW:
+		case GL_SAMPLER_BUFFER:
+		case GL_SAMPLER_2D_RECT:
+		case GL_SAMPLER_2D_RECT_SHADOW:
+		case GL_SAMPLER_CUBE_MAP_ARRAY:
+		case GL_SAMPLER_CUBE_MAP_ARRAY_SHADOW:
+		case GL_INT_SAMPLER_1D:
+		case GL_INT_SAMPLER_2D:
+		case GL_INT_SAMPLER_3D:
+		case GL_INT_SAMPLER_CUBE:
+		case GL_INT_SAMPLER_1D_ARRAY:
+		case GL_INT_SAMPLER_2D_ARRAY:
+		case GL_INT_SAMPLER_2D_MULTISAMPLE:
+		case GL_INT_SAMPLER_2D_MULTISAMPLE_ARRAY:
+		case GL_INT_SAMPLER_BUFFER:
+		case GL_INT_SAMPLER_2D_RECT:
+		case GL_INT_SAMPLER_CUBE_MAP_ARRAY:
+		case GL_UNSIGNED_INT_SAMPLER_1D:
+		case GL_UNSIGNED_INT_SAMPLER_2D:
+		case GL_UNSIGNED_INT_SAMPLER_3D:
+		case GL_UNSIGNED_INT_SAMPLER_CUBE:
+		case GL_UNSIGNED_INT_SAMPLER_1D_ARRAY:
+		case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY:
+		case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE:
+		case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE_ARRAY:
+		case GL_UNSIGNED_INT_SAMPLER_BUFFER:
+		case GL_UNSIGNED_INT_SAMPLER_2D_RECT:
+		case GL_UNSIGNED_INT_SAMPLER_CUBE_MAP_ARRAY:
+#if ASMITH_GL_VERSION_GE(4,2)
+		case GL_IMAGE_1D:
+		case GL_IMAGE_2D:
+		case GL_IMAGE_3D:
+		case GL_IMAGE_2D_RECT:
+		case GL_IMAGE_CUBE:
+		case GL_IMAGE_BUFFER:
+		case GL_IMAGE_1D_ARRAY:
+		case GL_IMAGE_2D_ARRAY:
+		case GL_IMAGE_CUBE_MAP_ARRAY:
+		case GL_INT_IMAGE_2D:
+		case GL_INT_IMAGE_3D:
+		case GL_INT_IMAGE_2D_ARRAY:
+		case GL_UNSIGNED_INT_IMAGE_2D:
+		case GL_UNSIGNED_INT_IMAGE_3D:
+		case GL_UNSIGNED_INT_IMAGE_2D_ARRAY:
+#endif
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	static GLenum get_bool_equivalent(GLenum aType) throw() {
+		switch(aType) {
+		case GL_BOOL:		return GL_INT;
+		case GL_BOOL_VEC2:	return GL_INT_VEC2;
+		case GL_BOOL_VEC3:	return GL_INT_VEC3;
+		case GL_BOOL_VEC4:	return GL_INT_VEC4;
+		default:			return GL_NONE;
+		}
+	}
+
+	bool implementation::is_uniform_type_compatible(GLenum aCpp, GLenum aGlsl) throw() {
+		if(aCpp == aGlsl) return true;
+		// Samplers and images are set with the index of a texture or image unit
+		if(aCpp == GL_INT && is_sampler_type(aGlsl)) return true;
+		// Booleans may be set with glUniform*i, glUniform*ui or glUniform*f
+		const GLenum boolean = get_bool_equivalent(aGlsl);
+		if(boolean == GL_NONE) return false;
+		switch(boolean) {
+		case GL_INT:		return aCpp == GL_INT || aCpp == GL_UNSIGNED_INT || aCpp == GL_FLOAT;
+		case GL_INT_VEC2:	return aCpp == GL_INT_VEC2 || aCpp == GL_UNSIGNED_INT_VEC2 || aCpp == GL_FLOAT_VEC2;
+		case GL_INT_VEC3:	return aCpp == GL_INT_VEC3 || aCpp == GL_UNSIGNED_INT_VEC3 || aCpp == GL_FLOAT_VEC3;
+		default:			return aCpp == GL_INT_VEC4 || aCpp == GL_UNSIGNED_INT_VEC4 || aCpp == GL_FLOAT_VEC4;
+		}
+	}
+
+	static size_t get_boolean_component_count(GLenum aType) throw() {
+		// The C++ types that GL accepts for a boolean uniform, 0 for any other
+		switch(aType) {
+		case GL_INT: case GL_UNSIGNED_INT: case GL_FLOAT:					return 1;
+		case GL_INT_VEC2: case GL_UNSIGNED_INT_VEC2: case GL_FLOAT_VEC2:	return 2;
+		case GL_INT_VEC3: case GL_UNSIGNED_INT_VEC3: case GL_FLOAT_VEC3:	return 3;
+		case GL_INT_VEC4: case GL_UNSIGNED_INT_VEC4: case GL_FLOAT_VEC4:	return 4;
+		default:															return 0;
+		}
+	}
+
+	static void convert_to_boolean(GLenum aType, const void* aValue, GLint* aOut, size_t aCount) throw() {
+		for(size_t i = 0; i < aCount; ++i) {
+			switch(aType) {
+			case GL_FLOAT: case GL_FLOAT_VEC2: case GL_FLOAT_VEC3: case GL_FLOAT_VEC4:
+				aOut[i] = static_cast<const GLfloat*>(aValue)[i] != 0.f ? 1 : 0;
+				break;
+			default:
+				// GLint and GLuint are both zero for false
+				aOut[i] = static_cast<const GLuint*>(aValue)[i] != 0u ? 1 : 0;
+				break;
+			}
+		}
+	}
+
+	static void convert_from_boolean(GLenum aType, const GLint* aValue, void* aOut, size_t aCount) throw() {
+		for(size_t i = 0; i < aCount; ++i) {
+			switch(aType) {
+			case GL_FLOAT: case GL_FLOAT_VEC2: case GL_FLOAT_VEC3: case GL_FLOAT_VEC4:
+				static_cast<GLfloat*>(aOut)[i] = aValue[i] != 0 ? 1.f : 0.f;
+				break;
+			case GL_UNSIGNED_INT: case GL_UNSIGNED_INT_VEC2: case GL_UNSIGNED_INT_VEC3: case GL_UNSIGNED_INT_VEC4:
+				static_cast<GLuint*>(aOut)[i] = aValue[i] != 0 ? 1u : 0u;
+				break;
+			default:
+				static_cast<GLint*>(aOut)[i] = aValue[i] != 0 ? 1 : 0;
+				break;
+			}
+		}
+	}
+
+	static std::string strip_array_suffix(const std::string& aName) {
+		// Arrays are reported as name[0], they should also be found by name
+		const size_t size = aName.size();
+		if(size > 3 && aName.compare(size - 3, 3, "[0]") == 0) return aName.substr(0, size - 3);
+		return aName;
+	}
 	
 	// program
 	
 	program::program(context& aContext) :
 		object(aContext),
-		mBound(false)
+		mUniformStatistics{ 0, 0, 0 },
+		mBound(false),
+		mLinked(false),
+		mLinkPending(false),
+		mSeparable(false)
 	{
 		mID = glCreateProgram();
 		if (mID == object::INVALID_ID) throw std::runtime_error("asmith::gl::program::destroy : glCreateProgram returned 0");
@@ -58,10 +201,12 @@ namespace asmith { namespace gl {
 
 	void program::bind() {
 		if(is_bound()) throw std::runtime_error("asmith::gl::program::bind : Program is already bound");
+		finish_link();
 		mPreviousBind = mContext.state->currently_bound_program;
 		mContext.state->currently_bound_program = std::static_pointer_cast<program>(shared_from_this());
 		mBound = true;
 		glUseProgram(mID);
+		flush_uniforms();
 	}
 
 	void program::unbind() {
@@ -88,190 +233,891 @@ namespace asmith { namespace gl {
 		return mContext.state->currently_bound_program == shared_from_this();
 	}
 
-	void program::link() {
+	void program::attach_for_link() {
+		if(mLinkPending) throw std::runtime_error("asmith::gl::program::link : Program is already linking");
 		for(const std::shared_ptr<shader>& i : mShaders) {
-			if(! i->is_compiled()) throw std::runtime_error("asmith::gl::program::link : Shader has not been compiled");
+			if(! (i->is_compiled() || i->is_compile_pending())) throw std::runtime_error("asmith::gl::program::link : Shader has not been compiled");
 			glAttachShader(mID, i->get_id());
 		}
+	}
+
+	void program::link() {
+		link_async();
+		finish_link();
+	}
+
+	void program::link_async() {
+		attach_for_link();
 		glLinkProgram(mID);
+		mLinked = false;
+		mLinkPending = true;
+
+		// The shaders are no longer needed once the link has been issued
+		for(const std::shared_ptr<shader>& i : mShaders){
+			glDetachShader(mID, static_cast<GLuint>(i->get_id()));
+		}
+	}
+
+	bool program::is_link_pending() const throw() {
+		return mLinkPending;
+	}
+
+	bool program::is_ready() {
+		if(! mLinkPending) return mLinked;
+#ifdef GL_KHR_parallel_shader_compile
+		if(shader::is_parallel_compile_supported()) {
+			GLint complete = GL_FALSE;
+			glGetProgramiv(mID, GL_COMPLETION_STATUS_KHR, &complete);
+			if(complete == GL_FALSE) return false;
+		}
+#endif
+		finish_link();
+		return true;
+	}
+
+	void program::finish_link() {
+		if(! mLinkPending) return;
+		mLinkPending = false;
         
 		GLint status = 0;
 		glGetProgramiv(mID, GL_LINK_STATUS, &status);
 		if(status == GL_FALSE){
-			GLint logLength = 0;
-			glGetProgramiv(mID, GL_INFO_LOG_LENGTH, &logLength);
-        
-			std::string log(logLength, '\0');
-			glGetProgramInfoLog(mID, logLength, &logLength, &log[0]);
-        
-			throw std::runtime_error(std::string("asmith::gl::program::link : Link error : ") + log.c_str());
+			// A shader that failed to compile gives a more useful message than the link log
+			for(const std::shared_ptr<shader>& i : mShaders) i->finish_compile();
+			throw std::runtime_error(std::string("asmith::gl::program::link : Link error : ") + get_info_log().c_str());
 		}
-		
-		for(const std::shared_ptr<shader>& i : mShaders){
-			glDetachShader(mID, static_cast<GLuint>(i->get_id()));
+		for(const std::shared_ptr<shader>& i : mShaders) i->finish_compile();
+		mLinked = true;
+		reflect();
+	}
+
+	void program::reflect() {
+		mUniforms.clear();
+		mBufferVariables.clear();
+		mAttributes.clear();
+		mUniformBlocks.clear();
+		mStorageBlocks.clear();
+		mUniformNames.clear();
+		mAttributeNames.clear();
+		mUniformBlockNames.clear();
+		mStorageBlockNames.clear();
+
+		GLint count = 0;
+		GLint maxLength = 0;
+		std::vector<GLchar> name;
+
+		// Uniforms
+		glGetProgramiv(mID, GL_ACTIVE_UNIFORMS, &count);
+		glGetProgramiv(mID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+		name.resize(static_cast<size_t>(maxLength > 0 ? maxLength : 1));
+		mUniforms.resize(static_cast<size_t>(count));
+		for(GLint i = 0; i < count; ++i) {
+			uniform_info& u = mUniforms[i];
+			GLsizei length = 0;
+			glGetActiveUniform(mID, static_cast<GLuint>(i), maxLength, &length, &u.size, &u.type, &name[0]);
+			u.name.assign(&name[0], static_cast<size_t>(length));
+			u.location = glGetUniformLocation(mID, u.name.c_str());
+		}
+		if(count > 0) {
+			std::vector<GLuint> indices(static_cast<size_t>(count));
+			for(GLint i = 0; i < count; ++i) indices[i] = static_cast<GLuint>(i);
+			std::vector<GLint> values(static_cast<size_t>(count));
+			const GLenum properties[4] = { GL_UNIFORM_BLOCK_INDEX, GL_UNIFORM_OFFSET, GL_UNIFORM_ARRAY_STRIDE, GL_UNIFORM_MATRIX_STRIDE };
+			GLint uniform_info::* const members[4] = { &uniform_info::block_index, &uniform_info::offset, &uniform_info::array_stride, &uniform_info::matrix_stride };
+			for(int j = 0; j < 4; ++j) {
+				glGetActiveUniformsiv(mID, count, &indices[0], properties[j], &values[0]);
+				for(GLint i = 0; i < count; ++i) mUniforms[i].*members[j] = values[i];
+			}
+		}
+		for(size_t i = 0; i < mUniforms.size(); ++i) {
+			mUniformNames.emplace(mUniforms[i].name, i);
+			mUniformNames.emplace(strip_array_suffix(mUniforms[i].name), i);
+		}
+
+		// Attributes
+		glGetProgramiv(mID, GL_ACTIVE_ATTRIBUTES, &count);
+		glGetProgramiv(mID, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxLength);
+		name.resize(static_cast<size_t>(maxLength > 0 ? maxLength : 1));
+		mAttributes.resize(static_cast<size_t>(count));
+		for(GLint i = 0; i < count; ++i) {
+			attribute_info& a = mAttributes[i];
+			GLsizei length = 0;
+			glGetActiveAttrib(mID, static_cast<GLuint>(i), maxLength, &length, &a.size, &a.type, &name[0]);
+			a.name.assign(&name[0], static_cast<size_t>(length));
+			a.location = glGetAttribLocation(mID, a.name.c_str());
+			mAttributeNames.emplace(a.name, static_cast<size_t>(i));
+			mAttributeNames.emplace(strip_array_suffix(a.name), static_cast<size_t>(i));
+		}
+
+		// Uniform blocks
+		glGetProgramiv(mID, GL_ACTIVE_UNIFORM_BLOCKS, &count);
+		glGetProgramiv(mID, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxLength);
+		name.resize(static_cast<size_t>(maxLength > 0 ? maxLength : 1));
+		mUniformBlocks.resize(static_cast<size_t>(count));
+		for(GLint i = 0; i < count; ++i) {
+			block_info& b = mUniformBlocks[i];
+			GLsizei length = 0;
+			glGetActiveUniformBlockName(mID, static_cast<GLuint>(i), maxLength, &length, &name[0]);
+			b.name.assign(&name[0], static_cast<size_t>(length));
+			b.index = static_cast<GLuint>(i);
+			glGetActiveUniformBlockiv(mID, b.index, GL_UNIFORM_BLOCK_DATA_SIZE, &b.data_size);
+			glGetActiveUniformBlockiv(mID, b.index, GL_UNIFORM_BLOCK_BINDING, &b.binding);
+			mUniformBlockNames.emplace(b.name, static_cast<size_t>(i));
+		}
+
+#if ASMITH_GL_VERSION_GE(4,3)
+		// Shader storage blocks and their members are only available through the program interface query
+		glGetProgramInterfaceiv(mID, GL_SHADER_STORAGE_BLOCK, GL_ACTIVE_RESOURCES, &count);
+		glGetProgramInterfaceiv(mID, GL_SHADER_STORAGE_BLOCK, GL_MAX_NAME_LENGTH, &maxLength);
+		name.resize(static_cast<size_t>(maxLength > 0 ? maxLength : 1));
+		mStorageBlocks.resize(static_cast<size_t>(count));
+		for(GLint i = 0; i < count; ++i) {
+			block_info& b = mStorageBlocks[i];
+			GLsizei length = 0;
+			glGetProgramResourceName(mID, GL_SHADER_STORAGE_BLOCK, static_cast<GLuint>(i), maxLength, &length, &name[0]);
+			b.name.assign(&name[0], static_cast<size_t>(length));
+			b.index = static_cast<GLuint>(i);
+			const GLenum properties[2] = { GL_BUFFER_DATA_SIZE, GL_BUFFER_BINDING };
+			GLint values[2] = { 0, 0 };
+			glGetProgramResourceiv(mID, GL_SHADER_STORAGE_BLOCK, b.index, 2, properties, 2, nullptr, values);
+			b.data_size = values[0];
+			b.binding = values[1];
+			mStorageBlockNames.emplace(b.name, static_cast<size_t>(i));
+		}
+
+		glGetProgramInterfaceiv(mID, GL_BUFFER_VARIABLE, GL_ACTIVE_RESOURCES, &count);
+		glGetProgramInterfaceiv(mID, GL_BUFFER_VARIABLE, GL_MAX_NAME_LENGTH, &maxLength);
+		name.resize(static_cast<size_t>(maxLength > 0 ? maxLength : 1));
+		mBufferVariables.resize(static_cast<size_t>(count));
+		for(GLint i = 0; i < count; ++i) {
+			uniform_info& v = mBufferVariables[i];
+			GLsizei length = 0;
+			glGetProgramResourceName(mID, GL_BUFFER_VARIABLE, static_cast<GLuint>(i), maxLength, &length, &name[0]);
+			v.name.assign(&name[0], static_cast<size_t>(length));
+			v.location = -1;
+			const GLenum properties[6] = { GL_TYPE, GL_ARRAY_SIZE, GL_BLOCK_INDEX, GL_OFFSET, GL_ARRAY_STRIDE, GL_MATRIX_STRIDE };
+			GLint values[6] = { 0, 0, -1, -1, -1, -1 };
+			glGetProgramResourceiv(mID, GL_BUFFER_VARIABLE, static_cast<GLuint>(i), 6, properties, 6, nullptr, values);
+			v.type = static_cast<GLenum>(values[0]);
+			v.size = values[1];
+			v.block_index = values[2];
+			v.offset = values[3];
+			v.array_stride = values[4];
+			v.matrix_stride = values[5];
+		}
+#endif
+
+		create_uniform_shadow();
+	}
+
+	std::string program::get_info_log() const {
+		GLint logLength = 0;
+		glGetProgramiv(mID, GL_INFO_LOG_LENGTH, &logLength);
+		if(logLength <= 0) return std::string();
+
+		std::string log(logLength, '\0');
+		glGetProgramInfoLog(mID, logLength, &logLength, &log[0]);
+		return log;
+	}
+
+	bool program::is_linked() const throw() {
+		return mLinked;
+	}
+
+	bool program::is_binary_supported() throw() {
+#ifdef GL_ARB_get_program_binary
+		if(! (GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary)) return false;
+		// Drivers are allowed to support the functions without supporting any binary formats
+		GLint formats = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+		return formats > 0;
+#else
+		return false;
+#endif
+	}
+
+	bool program::is_separable_supported() throw() {
+#ifdef GL_ARB_separate_shader_objects
+		return GLEW_VERSION_4_1 || GLEW_ARB_separate_shader_objects ? true : false;
+#else
+		return false;
+#endif
+	}
+
+	void program::set_separable(bool aSeparable) {
+		if(! is_separable_supported()) throw std::runtime_error("asmith::gl::program::set_separable : Separable programs are not supported");
+#ifdef GL_ARB_separate_shader_objects
+		glProgramParameteri(mID, GL_PROGRAM_SEPARABLE, aSeparable ? GL_TRUE : GL_FALSE);
+		mSeparable = aSeparable;
+#endif
+	}
+
+	bool program::is_separable() const throw() {
+		return mSeparable;
+	}
+
+	GLbitfield program::get_stages() const throw() {
+		GLbitfield stages = 0;
+#ifdef GL_ARB_separate_shader_objects
+		for(const std::shared_ptr<shader>& i : mShaders) {
+			switch(i->get_type()) {
+			case shader::VERTEX:					stages |= GL_VERTEX_SHADER_BIT; break;
+			case shader::GEOMETRY:					stages |= GL_GEOMETRY_SHADER_BIT; break;
+			case shader::FRAGMENT:					stages |= GL_FRAGMENT_SHADER_BIT; break;
+	#if ASMITH_GL_VERSION_MAJOR >= 4
+		#if ASMITH_GL_VERSION_MINOR >= 3 || ASMITH_GL_VERSION_MAJOR > 4
+			case shader::COMPUTE:					stages |= GL_COMPUTE_SHADER_BIT; break;
+		#endif
+			case shader::TESSELLATION_CONTROL:		stages |= GL_TESS_CONTROL_SHADER_BIT; break;
+			case shader::TESSELLATION_EVALUATION:	stages |= GL_TESS_EVALUATION_SHADER_BIT; break;
+	#endif
+			default: break;
+			}
 		}
+#endif
+		return stages;
+	}
+
+	bool program::is_compute_supported() throw() {
+#ifdef GL_ARB_compute_shader
+		return GLEW_VERSION_4_3 || GLEW_ARB_compute_shader ? true : false;
+#else
+		return false;
+#endif
+	}
+
+	void program::get_work_group_size(GLint& aX, GLint& aY, GLint& aZ) const {
+		if(! mLinked) throw std::runtime_error("asmith::gl::program::get_work_group_size : Program has not been linked");
+		if(! is_compute_supported()) throw std::runtime_error("asmith::gl::program::get_work_group_size : Compute shaders are not supported");
+#ifdef GL_ARB_compute_shader
+		GLint size[3] = { 0, 0, 0 };
+		glGetProgramiv(mID, GL_COMPUTE_WORK_GROUP_SIZE, size);
+		aX = size[0];
+		aY = size[1];
+		aZ = size[2];
+#endif
+	}
+
+	void program::dispatch(GLuint aX, GLuint aY, GLuint aZ) {
+		if(! is_currently_bound()) throw std::runtime_error("asmith::gl::program::dispatch : Program is not the currently bound program");
+		if(! is_compute_supported()) throw std::runtime_error("asmith::gl::program::dispatch : Compute shaders are not supported");
+		if(aX == 0 || aY == 0 || aZ == 0) return;
+#ifdef GL_ARB_compute_shader
+		flush_uniforms();
+		glDispatchCompute(aX, aY, aZ);
+#endif
+	}
+
+	void program::dispatch_threads(GLuint aX, GLuint aY, GLuint aZ) {
+		GLint x, y, z;
+		get_work_group_size(x, y, z);
+		if(x <= 0 || y <= 0 || z <= 0) throw std::runtime_error("asmith::gl::program::dispatch_threads : Program does not contain a compute shader");
+		dispatch((aX + x - 1) / x, (aY + y - 1) / y, (aZ + z - 1) / z);
+	}
+
+	void program::dispatch_indirect(const vertex_buffer& aBuffer, GLintptr aOffset) {
+		if(! is_currently_bound()) throw std::runtime_error("asmith::gl::program::dispatch_indirect : Program is not the currently bound program");
+		if(! is_compute_supported()) throw std::runtime_error("asmith::gl::program::dispatch_indirect : Compute shaders are not supported");
+		if(aOffset < 0 || aOffset % 4 != 0) throw std::runtime_error("asmith::gl::program::dispatch_indirect : Offset must be a multiple of 4");
+		if(aOffset + static_cast<GLintptr>(sizeof(GLuint) * 3) > aBuffer.size()) throw std::runtime_error("asmith::gl::program::dispatch_indirect : Offset is outside of the buffer");
+#ifdef GL_ARB_compute_shader
+		flush_uniforms();
+		glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, aBuffer.get_id());
+		glDispatchComputeIndirect(aOffset);
+	#if ASMITH_GL_VERSION_GE(4,3)
+		const std::shared_ptr<vertex_buffer> previous = vertex_buffer::get_buffer_bound_to(mContext, GL_DISPATCH_INDIRECT_BUFFER);
+		glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, previous ? static_cast<GLuint>(previous->get_id()) : 0);
+	#else
+		// The binding point is only tracked by vertex_buffer from GL 4.3
+		glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, 0);
+	#endif
+#endif
+	}
+
+	void program::set_binary_retrievable(bool aRetrievable) {
+		if(! is_binary_supported()) throw std::runtime_error("asmith::gl::program::set_binary_retrievable : Program binaries are not supported");
+#ifdef GL_ARB_get_program_binary
+		// Only takes effect at the next link
+		glProgramParameteri(mID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, aRetrievable ? GL_TRUE : GL_FALSE);
+#endif
+	}
+
+	std::vector<uint8_t> program::get_binary(GLenum& aFormat) const {
+		if(! mLinked) throw std::runtime_error("asmith::gl::program::get_binary : Program has not been linked");
+		if(! is_binary_supported()) throw std::runtime_error("asmith::gl::program::get_binary : Program binaries are not supported");
+		std::vector<uint8_t> binary;
+#ifdef GL_ARB_get_program_binary
+		GLint length = 0;
+		glGetProgramiv(mID, GL_PROGRAM_BINARY_LENGTH, &length);
+		if(length <= 0) return binary;
+		binary.resize(static_cast<size_t>(length));
+		glGetProgramBinary(mID, length, &length, &aFormat, &binary[0]);
+		binary.resize(static_cast<size_t>(length));
+#endif
+		return binary;
+	}
+
+	bool program::load_binary(GLenum aFormat, const void* aBinary, GLsizei aLength) {
+		if(! is_binary_supported()) throw std::runtime_error("asmith::gl::program::load_binary : Program binaries are not supported");
+#ifdef GL_ARB_get_program_binary
+		glProgramBinary(mID, aFormat, aBinary, aLength);
+		// Drivers reject binaries from other driver versions, the caller should then link from source
+		GLint status = 0;
+		glGetProgramiv(mID, GL_LINK_STATUS, &status);
+		mLinked = status != GL_FALSE;
+		if(mLinked) reflect();
+#endif
+		return mLinked;
 	}
 
 	GLint program::get_uniform_location(const GLchar* aName) const {
-		if(mID == 0) throw std::runtime_error("asmith::gl::program::get_uniform_location : Program has not been linked");
-		return glGetUniformLocation(mID, aName);
+		if(! mLinked) throw std::runtime_error("asmith::gl::program::get_uniform_location : Program has not been linked");
+		const uniform_info* const u = find_uniform(aName);
+		if(u) return u->location;
+		// Elements and members of arrays, such as name[2], are not in the table
+		return std::strchr(aName, '[') ? glGetUniformLocation(mID, aName) : -1;
+	}
+
+	const program::uniform_info& program::find_typed_uniform(const GLchar* aName, GLenum aType) const {
+		static const uniform_info INACTIVE = { std::string(), -1, GL_NONE, 0, -1, -1, -1, -1 };
+		if(! mLinked) throw std::runtime_error("asmith::gl::program::get_uniform_location : Program has not been linked");
+		const uniform_info* const u = find_uniform(aName);
+		if(u == nullptr) return INACTIVE;
+		if(! implementation::is_uniform_type_compatible(aType, u->type)) {
+			throw std::runtime_error(std::string("asmith::gl::program::get_uniform_location : Type does not match the GLSL type of ") + aName);
+		}
+		return *u;
+	}
+
+	GLint program::get_attribute_location(const GLchar* aName) const {
+		if(! mLinked) throw std::runtime_error("asmith::gl::program::get_attribute_location : Program has not been linked");
+		const attribute_info* const a = find_attribute(aName);
+		return a ? a->location : -1;
+	}
+
+	GLint program::get_uniform_block_index(const GLchar* aName) const {
+		if(! mLinked) throw std::runtime_error("asmith::gl::program::get_uniform_block_index : Program has not been linked");
+		const block_info* const b = find_uniform_block(aName);
+		return b ? static_cast<GLint>(b->index) : -1;
+	}
+
+	GLint program::get_storage_block_index(const GLchar* aName) const {
+		if(! mLinked) throw std::runtime_error("asmith::gl::program::get_storage_block_index : Program has not been linked");
+		const block_info* const b = find_storage_block(aName);
+		return b ? static_cast<GLint>(b->index) : -1;
+	}
+
+	void program::set_uniform_block_binding(GLuint aIndex, GLuint aBinding) {
+		if(aIndex >= mUniformBlocks.size()) throw std::runtime_error("asmith::gl::program::set_uniform_block_binding : Invalid uniform block index");
+		block_info& b = mUniformBlocks[aIndex];
+		if(b.binding == static_cast<GLint>(aBinding)) return;
+		glUniformBlockBinding(mID, aIndex, aBinding);
+		b.binding = static_cast<GLint>(aBinding);
+	}
+
+	void program::set_storage_block_binding(GLuint aIndex, GLuint aBinding) {
+		if(aIndex >= mStorageBlocks.size()) throw std::runtime_error("asmith::gl::program::set_storage_block_binding : Invalid storage block index");
+#if ASMITH_GL_VERSION_GE(4,3)
+		block_info& b = mStorageBlocks[aIndex];
+		if(b.binding == static_cast<GLint>(aBinding)) return;
+		glShaderStorageBlockBinding(mID, aIndex, aBinding);
+		b.binding = static_cast<GLint>(aBinding);
+#else
+		(void) aBinding;
+		throw std::runtime_error("asmith::gl::program::set_storage_block_binding : Shader storage blocks require OpenGL 4.3");
+#endif
+	}
+
+	const program::uniform_info* program::find_uniform(const GLchar* aName) const throw() {
+		const auto i = mUniformNames.find(aName);
+		return i == mUniformNames.end() ? nullptr : &mUniforms[i->second];
+	}
+
+	const program::attribute_info* program::find_attribute(const GLchar* aName) const throw() {
+		const auto i = mAttributeNames.find(aName);
+		return i == mAttributeNames.end() ? nullptr : &mAttributes[i->second];
+	}
+
+	const program::block_info* program::find_uniform_block(const GLchar* aName) const throw() {
+		const auto i = mUniformBlockNames.find(aName);
+		return i == mUniformBlockNames.end() ? nullptr : &mUniformBlocks[i->second];
+	}
+
+	const program::block_info* program::find_storage_block(const GLchar* aName) const throw() {
+		const auto i = mStorageBlockNames.find(aName);
+		return i == mStorageBlockNames.end() ? nullptr : &mStorageBlocks[i->second];
+	}
+
+	const std::vector<program::uniform_info>& program::get_uniforms() const throw() {
+		return mUniforms;
+	}
+
+	const std::vector<program::uniform_info>& program::get_buffer_variables() const throw() {
+		return mBufferVariables;
+	}
+
+	const std::vector<program::attribute_info>& program::get_attributes() const throw() {
+		return mAttributes;
+	}
+
+	const std::vector<program::block_info>& program::get_uniform_blocks() const throw() {
+		return mUniformBlocks;
+	}
+
+	const std::vector<program::block_info>& program::get_storage_blocks() const throw() {
+		return mStorageBlocks;
 	}
 
 
 	void program::set_uniform(GLint aLocation, GLfloat a) {
-		glUniform1f(aLocation, a);
+		set_uniform_value(aLocation, GL_FLOAT, &a, sizeof(GLfloat));
 	}
 
 	void program::set_uniform(GLint aLocation, GLfloat a, GLfloat b) {
-		glUniform2f(aLocation, a, b);
+		const GLfloat tmp[2] = { a, b };
+		set_uniform_value(aLocation, GL_FLOAT_VEC2, tmp, sizeof(tmp));
 	}
 
 	void program::set_uniform(GLint aLocation, GLfloat a, GLfloat b, GLfloat c) {
-		glUniform3f(aLocation, a, b, c);
+		const GLfloat tmp[3] = { a, b, c };
+		set_uniform_value(aLocation, GL_FLOAT_VEC3, tmp, sizeof(tmp));
 	}
 
 	void program::set_uniform(GLint aLocation, GLfloat a, GLfloat b, GLfloat c, GLfloat d) {
-		glUniform4f(aLocation, a, b, c, d);
+		const GLfloat tmp[4] = { a, b, c, d };
+		set_uniform_value(aLocation, GL_FLOAT_VEC4, tmp, sizeof(tmp));
 	}
 
 	void program::set_uniform(GLint aLocation, GLint a) {
-		glUniform1i(aLocation, a);
+		set_uniform_value(aLocation, GL_INT, &a, sizeof(GLint));
 	}
 
 	void program::set_uniform(GLint aLocation, GLint a, GLint b) {
-		glUniform2i(aLocation, a, b);
+		const GLint tmp[2] = { a, b };
+		set_uniform_value(aLocation, GL_INT_VEC2, tmp, sizeof(tmp));
 	}
 
 	void program::set_uniform(GLint aLocation, GLint a, GLint b, GLint c) {
-		glUniform3i(aLocation, a, b, c);
+		const GLint tmp[3] = { a, b, c };
+		set_uniform_value(aLocation, GL_INT_VEC3, tmp, sizeof(tmp));
 	}
 
 	void program::set_uniform(GLint aLocation, GLint a, GLint b, GLint c, GLint d) {
-		glUniform4i(aLocation, a, b, c, d);
+		const GLint tmp[4] = { a, b, c, d };
+		set_uniform_value(aLocation, GL_INT_VEC4, tmp, sizeof(tmp));
 	}
 
 	void program::set_uniform(GLint aLocation, GLuint a) {
-		glUniform1ui(aLocation, a);
+		set_uniform_value(aLocation, GL_UNSIGNED_INT, &a, sizeof(GLuint));
 	}
 
 	void program::set_uniform(GLint aLocation, GLuint a, GLuint b) {
-		glUniform2ui(aLocation, a, b);
+		const GLuint tmp[2] = { a, b };
+		set_uniform_value(aLocation, GL_UNSIGNED_INT_VEC2, tmp, sizeof(tmp));
 	}
 
 	void program::set_uniform(GLint aLocation, GLuint a, GLuint b, GLuint c) {
-		glUniform3ui(aLocation, a, b, c);
+		const GLuint tmp[3] = { a, b, c };
+		set_uniform_value(aLocation, GL_UNSIGNED_INT_VEC3, tmp, sizeof(tmp));
 	}
 
 	void program::set_uniform(GLint aLocation, GLuint a, GLuint b, GLuint c, GLuint d) {
-		glUniform4ui(aLocation, a, b, c, d);
+		const GLuint tmp[4] = { a, b, c, d };
+		set_uniform_value(aLocation, GL_UNSIGNED_INT_VEC4, tmp, sizeof(tmp));
 	}
 
 	void program::set_uniform(GLint aLocation, const vec2f& aValue) {
-		glUniform2fv(aLocation, 1, &aValue[0]);
+		set_uniform_value(aLocation, GL_FLOAT_VEC2, &aValue[0], sizeof(GLfloat) * 2);
 	}
 
 	void program::set_uniform(GLint aLocation, const vec3f& aValue) {
-		glUniform3fv(aLocation, 1, &aValue[0]);
+		set_uniform_value(aLocation, GL_FLOAT_VEC3, &aValue[0], sizeof(GLfloat) * 3);
 	}
 
 	void program::set_uniform(GLint aLocation, const vec4f& aValue) {
-		glUniform4fv(aLocation, 1, &aValue[0]);
+		set_uniform_value(aLocation, GL_FLOAT_VEC4, &aValue[0], sizeof(GLfloat) * 4);
 	}
 
 	void program::set_uniform(GLint aLocation, const vec2i& aValue) {
-		glUniform2iv(aLocation, 1, &aValue[0]);
+		set_uniform_value(aLocation, GL_INT_VEC2, &aValue[0], sizeof(GLint) * 2);
 	}
 
 	void program::set_uniform(GLint aLocation, const vec3i& aValue) {
-		glUniform3iv(aLocation, 1, &aValue[0]);
+		set_uniform_value(aLocation, GL_INT_VEC3, &aValue[0], sizeof(GLint) * 3);
 	}
 
 	void program::set_uniform(GLint aLocation, const vec4i& aValue) {
-		glUniform4iv(aLocation, 1, &aValue[0]);
+		set_uniform_value(aLocation, GL_INT_VEC4, &aValue[0], sizeof(GLint) * 4);
 	}
 
 	void program::set_uniform(GLint aLocation, const vec2u& aValue) {
-		glUniform2uiv(aLocation, 1, &aValue[0]);
+		set_uniform_value(aLocation, GL_UNSIGNED_INT_VEC2, &aValue[0], sizeof(GLuint) * 2);
 	}
 
 	void program::set_uniform(GLint aLocation, const vec3u& aValue) {
-		glUniform3uiv(aLocation, 1, &aValue[0]);
+		set_uniform_value(aLocation, GL_UNSIGNED_INT_VEC3, &aValue[0], sizeof(GLuint) * 3);
 	}
 
 	void program::set_uniform(GLint aLocation, const vec4u& aValue) {
-		glUniform4uiv(aLocation, 1, &aValue[0]);
+		set_uniform_value(aLocation, GL_UNSIGNED_INT_VEC4, &aValue[0], sizeof(GLuint) * 4);
+	}
+
+	static void transpose_matrix(const GLfloat* aSrc, GLfloat* aDst, int aSize) throw() {
+		for(int i = 0; i < aSize; ++i) for(int j = 0; j < aSize; ++j) aDst[i * aSize + j] = aSrc[j * aSize + i];
 	}
 
 	void program::set_uniform(GLint aLocation, const mat2& aValue, GLboolean aTranspose) {
-		glUniformMatrix2fv(aLocation, 1, aTranspose, &aValue[0][0]);
+		// The shadow copy is always stored in column major order
+		GLfloat tmp[2 * 2];
+		if(aTranspose) transpose_matrix(&aValue[0][0], tmp, 2);
+		else memcpy(tmp, &aValue[0][0], sizeof(tmp));
+		set_uniform_value(aLocation, GL_FLOAT_MAT2, tmp, sizeof(tmp));
 	}
 
 	void program::set_uniform(GLint aLocation, const mat3& aValue, GLboolean aTranspose) {
-		glUniformMatrix3fv(aLocation, 1, aTranspose, &aValue[0][0]);
+		GLfloat tmp[3 * 3];
+		if(aTranspose) transpose_matrix(&aValue[0][0], tmp, 3);
+		else memcpy(tmp, &aValue[0][0], sizeof(tmp));
+		set_uniform_value(aLocation, GL_FLOAT_MAT3, tmp, sizeof(tmp));
 	}
 
 	void program::set_uniform(GLint aLocation, const mat4& aValue, GLboolean aTranspose) {
-		glUniformMatrix4fv(aLocation, 1, aTranspose, &aValue[0][0]);
+		GLfloat tmp[4 * 4];
+		if(aTranspose) transpose_matrix(&aValue[0][0], tmp, 4);
+		else memcpy(tmp, &aValue[0][0], sizeof(tmp));
+		set_uniform_value(aLocation, GL_FLOAT_MAT4, tmp, sizeof(tmp));
 	}
 
 	void program::get_uniform(GLint aLocation, GLfloat& aValue) const {
-		glGetUniformfv(mID, 1, &aValue);
+		get_uniform_value(aLocation, GL_FLOAT, &aValue, sizeof(GLfloat));
 	}
 
 	void program::get_uniform(GLint aLocation, GLint& aValue) const {
-		glGetUniformiv(mID, 1, &aValue);
+		get_uniform_value(aLocation, GL_INT, &aValue, sizeof(GLint));
 	}
 
 	void program::get_uniform(GLint aLocation, GLuint& aValue) const {
-		glGetUniformuiv(mID, 1, &aValue);
+		get_uniform_value(aLocation, GL_UNSIGNED_INT, &aValue, sizeof(GLuint));
 	}
 
 	void program::get_uniform(GLint aLocation, vec2f& aValue) const {
-		glGetUniformfv(mID, 2, &aValue[0]);
+		get_uniform_value(aLocation, GL_FLOAT_VEC2, &aValue[0], sizeof(GLfloat) * 2);
 	}
 
 	void program::get_uniform(GLint aLocation, vec3f& aValue) const {
-		glGetUniformfv(mID, 3, &aValue[0]);
+		get_uniform_value(aLocation, GL_FLOAT_VEC3, &aValue[0], sizeof(GLfloat) * 3);
 	}
 
 	void program::get_uniform(GLint aLocation, vec4f& aValue) const {
-		glGetUniformfv(mID, 4, &aValue[0]);
+		get_uniform_value(aLocation, GL_FLOAT_VEC4, &aValue[0], sizeof(GLfloat) * 4);
 	}
 
 	void program::get_uniform(GLint aLocation, vec2i& aValue) const {
-		glGetUniformiv(mID, 2, &aValue[0]);
+		get_uniform_value(aLocation, GL_INT_VEC2, &aValue[0], sizeof(GLint) * 2);
 	}
 
 	void program::get_uniform(GLint aLocation, vec3i& aValue) const {
-		glGetUniformiv(mID, 3, &aValue[0]);
+		get_uniform_value(aLocation, GL_INT_VEC3, &aValue[0], sizeof(GLint) * 3);
 	}
 
 	void program::get_uniform(GLint aLocation, vec4i& aValue) const {
-		glGetUniformiv(mID, 4, &aValue[0]);
+		get_uniform_value(aLocation, GL_INT_VEC4, &aValue[0], sizeof(GLint) * 4);
 	}
 
 	void program::get_uniform(GLint aLocation, vec2u& aValue) const {
-		glGetUniformuiv(mID, 2, &aValue[0]);
+		get_uniform_value(aLocation, GL_UNSIGNED_INT_VEC2, &aValue[0], sizeof(GLuint) * 2);
 	}
 
 	void program::get_uniform(GLint aLocation, vec3u& aValue) const {
-		glGetUniformuiv(mID, 3, &aValue[0]);
+		get_uniform_value(aLocation, GL_UNSIGNED_INT_VEC3, &aValue[0], sizeof(GLuint) * 3);
 	}
 
 	void program::get_uniform(GLint aLocation, vec4u& aValue) const {
-		glGetUniformuiv(mID, 4, &aValue[0]);
+		get_uniform_value(aLocation, GL_UNSIGNED_INT_VEC4, &aValue[0], sizeof(GLuint) * 4);
 	}
 
 	void program::get_uniform(GLint aLocation, mat2& aValue) const {
-		glGetUniformfv(mID, 2*2, &aValue[0][0]);
+		get_uniform_value(aLocation, GL_FLOAT_MAT2, &aValue[0][0], sizeof(GLfloat) * 2 * 2);
 	}
 
 	void program::get_uniform(GLint aLocation, mat3& aValue) const {
-		glGetUniformfv(mID, 3*3, &aValue[0][0]);
+		get_uniform_value(aLocation, GL_FLOAT_MAT3, &aValue[0][0], sizeof(GLfloat) * 3 * 3);
 	}
 
 	void program::get_uniform(GLint aLocation, mat4& aValue) const {
-		glGetUniformfv(mID, 4*4, &aValue[0][0]);
+		get_uniform_value(aLocation, GL_FLOAT_MAT4, &aValue[0][0], sizeof(GLfloat) * 4 * 4);
+	}
+
+	// Uniform shadow storage
+
+	static GLenum get_uniform_upload_type(GLenum aType) throw() {
+		switch(aType) {
+		case GL_FLOAT:
+		case GL_FLOAT_VEC2:
+		case GL_FLOAT_VEC3:
+		case GL_FLOAT_VEC4:
+		case GL_INT:
+		case GL_INT_VEC2:
+		case GL_INT_VEC3:
+		case GL_INT_VEC4:
+		case GL_UNSIGNED_INT:
+		case GL_UNSIGNED_INT_VEC2:
+		case GL_UNSIGNED_INT_VEC3:
+		case GL_UNSIGNED_INT_VEC4:
+		case GL_FLOAT_MAT2:
+		case GL_FLOAT_MAT3:
+		case GL_FLOAT_MAT4:
+			return aType;
+		default:
+			// Booleans are shadowed as integers and samplers as the index of their texture unit
+			if(is_sampler_type(aType)) return GL_INT;
+			return get_bool_equivalent(aType);
+		}
+	}
+
+	static uint32_t get_uniform_upload_size(GLenum aType) throw() {
+		switch(aType) {
+		case GL_FLOAT:
+		case GL_INT:
+		case GL_UNSIGNED_INT:
+			return 4;
+		case GL_FLOAT_VEC2:
+		case GL_INT_VEC2:
+		case GL_UNSIGNED_INT_VEC2:
+			return 8;
+		case GL_FLOAT_VEC3:
+		case GL_INT_VEC3:
+		case GL_UNSIGNED_INT_VEC3:
+			return 12;
+		case GL_FLOAT_VEC4:
+		case GL_INT_VEC4:
+		case GL_UNSIGNED_INT_VEC4:
+		case GL_FLOAT_MAT2:
+			return 16;
+		case GL_FLOAT_MAT3:
+			return 36;
+		case GL_FLOAT_MAT4:
+			return 64;
+		default:
+			return 0;
+		}
+	}
+
+	static void upload_uniform(GLint aLocation, GLenum aType, const void* aValue) throw() {
+		const GLfloat* const f = static_cast<const GLfloat*>(aValue);
+		const GLint* const i = static_cast<const GLint*>(aValue);
+		const GLuint* const u = static_cast<const GLuint*>(aValue);
+		switch(aType) {
+		case GL_FLOAT:				glUniform1fv(aLocation, 1, f); break;
+		case GL_FLOAT_VEC2:			glUniform2fv(aLocation, 1, f); break;
+		case GL_FLOAT_VEC3:			glUniform3fv(aLocation, 1, f); break;
+		case GL_FLOAT_VEC4:			glUniform4fv(aLocation, 1, f); break;
+		case GL_INT:				glUniform1iv(aLocation, 1, i); break;
+		case GL_INT_VEC2:			glUniform2iv(aLocation, 1, i); break;
+		case GL_INT_VEC3:			glUniform3iv(aLocation, 1, i); break;
+		case GL_INT_VEC4:			glUniform4iv(aLocation, 1, i); break;
+		case GL_UNSIGNED_INT:		glUniform1uiv(aLocation, 1, u); break;
+		case GL_UNSIGNED_INT_VEC2:	glUniform2uiv(aLocation, 1, u); break;
+		case GL_UNSIGNED_INT_VEC3:	glUniform3uiv(aLocation, 1, u); break;
+		case GL_UNSIGNED_INT_VEC4:	glUniform4uiv(aLocation, 1, u); break;
+		case GL_FLOAT_MAT2:			glUniformMatrix2fv(aLocation, 1, GL_FALSE, f); break;
+		case GL_FLOAT_MAT3:			glUniformMatrix3fv(aLocation, 1, GL_FALSE, f); break;
+		case GL_FLOAT_MAT4:			glUniformMatrix4fv(aLocation, 1, GL_FALSE, f); break;
+		default: break;
+		}
+	}
+
+#ifdef GL_ARB_separate_shader_objects
+	static void upload_program_uniform(GLuint aProgram, GLint aLocation, GLenum aType, const void* aValue) throw() {
+		const GLfloat* const f = static_cast<const GLfloat*>(aValue);
+		const GLint* const i = static_cast<const GLint*>(aValue);
+		const GLuint* const u = static_cast<const GLuint*>(aValue);
+		switch(aType) {
+		case GL_FLOAT:				glProgramUniform1fv(aProgram, aLocation, 1, f); break;
+		case GL_FLOAT_VEC2:			glProgramUniform2fv(aProgram, aLocation, 1, f); break;
+		case GL_FLOAT_VEC3:			glProgramUniform3fv(aProgram, aLocation, 1, f); break;
+		case GL_FLOAT_VEC4:			glProgramUniform4fv(aProgram, aLocation, 1, f); break;
+		case GL_INT:				glProgramUniform1iv(aProgram, aLocation, 1, i); break;
+		case GL_INT_VEC2:			glProgramUniform2iv(aProgram, aLocation, 1, i); break;
+		case GL_INT_VEC3:			glProgramUniform3iv(aProgram, aLocation, 1, i); break;
+		case GL_INT_VEC4:			glProgramUniform4iv(aProgram, aLocation, 1, i); break;
+		case GL_UNSIGNED_INT:		glProgramUniform1uiv(aProgram, aLocation, 1, u); break;
+		case GL_UNSIGNED_INT_VEC2:	glProgramUniform2uiv(aProgram, aLocation, 1, u); break;
+		case GL_UNSIGNED_INT_VEC3:	glProgramUniform3uiv(aProgram, aLocation, 1, u); break;
+		case GL_UNSIGNED_INT_VEC4:	glProgramUniform4uiv(aProgram, aLocation, 1, u); break;
+		case GL_FLOAT_MAT2:			glProgramUniformMatrix2fv(aProgram, aLocation, 1, GL_FALSE, f); break;
+		case GL_FLOAT_MAT3:			glProgramUniformMatrix3fv(aProgram, aLocation, 1, GL_FALSE, f); break;
+		case GL_FLOAT_MAT4:			glProgramUniformMatrix4fv(aProgram, aLocation, 1, GL_FALSE, f); break;
+		default: break;
+		}
+	}
+#endif
+
+	void program::create_uniform_shadow() {
+		mUniformData.clear();
+		mSlots.clear();
+		mSlotByLocation.clear();
+		mDirtySlots.clear();
+
+		for(const uniform_info& u : mUniforms) {
+			// Uniforms in blocks are stored in buffers instead
+			if(u.location < 0 || u.block_index != -1) continue;
+			const GLenum type = get_uniform_upload_type(u.type);
+			const uint32_t bytes = get_uniform_upload_size(type);
+			if(bytes == 0) continue;
+
+			const std::string base = strip_array_suffix(u.name);
+			for(GLint i = 0; i < u.size; ++i) {
+				const GLint location = u.size == 1 ? u.location : glGetUniformLocation(mID, (base + '[' + std::to_string(i) + ']').c_str());
+				if(location < 0) continue;
+
+				uniform_slot slot;
+				slot.location = location;
+				slot.type = type;
+				slot.offset = static_cast<uint32_t>(mUniformData.size());
+				slot.bytes = bytes;
+				slot.dirty = false;
+				slot.boolean = get_bool_equivalent(u.type) != GL_NONE;
+				mUniformData.resize(mUniformData.size() + bytes);
+
+				// Start from the values the program has after linking, such as initialisers in the GLSL
+				void* const data = &mUniformData[slot.offset];
+				switch(type) {
+				case GL_INT: case GL_INT_VEC2: case GL_INT_VEC3: case GL_INT_VEC4:
+					glGetUniformiv(mID, location, static_cast<GLint*>(data));
+					break;
+				case GL_UNSIGNED_INT: case GL_UNSIGNED_INT_VEC2: case GL_UNSIGNED_INT_VEC3: case GL_UNSIGNED_INT_VEC4:
+					glGetUniformuiv(mID, location, static_cast<GLuint*>(data));
+					break;
+				default:
+					glGetUniformfv(mID, location, static_cast<GLfloat*>(data));
+					break;
+				}
+
+				if(static_cast<size_t>(location) >= mSlotByLocation.size()) mSlotByLocation.resize(static_cast<size_t>(location) + 1, -1);
+				mSlotByLocation[location] = static_cast<int32_t>(mSlots.size());
+				mSlots.push_back(slot);
+			}
+		}
+	}
+
+	int32_t program::find_slot(GLint aLocation, GLenum aType) const throw() {
+		if(aLocation < 0 || static_cast<size_t>(aLocation) >= mSlotByLocation.size()) return -1;
+		const int32_t index = mSlotByLocation[aLocation];
+		return index >= 0 && mSlots[index].type == aType ? index : -1;
+	}
+
+	int32_t program::find_boolean_slot(GLint aLocation, GLenum aType) const throw() {
+		if(aLocation < 0 || static_cast<size_t>(aLocation) >= mSlotByLocation.size()) return -1;
+		const int32_t index = mSlotByLocation[aLocation];
+		if(index < 0 || ! mSlots[index].boolean) return -1;
+		return get_boolean_component_count(aType) * sizeof(GLint) == mSlots[index].bytes ? index : -1;
+	}
+
+	void program::set_uniform_value(GLint aLocation, GLenum aType, const void* aValue, size_t aBytes) {
+		++mUniformStatistics.calls;
+		// GL ignores location -1, so there is nothing to upload
+		if(aLocation == -1) {
+			++mUniformStatistics.elided;
+			return;
+		}
+
+		int32_t index = find_slot(aLocation, aType);
+		GLint boolean[4];
+		if(index < 0 || mSlots[index].boolean) {
+			// Booleans may be set with floats or unsigned integers, GL stores 0 or 1 whichever is used
+			const int32_t b = find_boolean_slot(aLocation, aType);
+			if(b >= 0) {
+				index = b;
+				convert_to_boolean(aType, aValue, boolean, aBytes / sizeof(GLint));
+				aValue = boolean;
+			}
+		}
+
+		if(index < 0) {
+			// Not shadowed, it is uploaded now. A type that GL rejects leaves the uniform and its shadow unchanged
+			if(is_currently_bound()) {
+				upload_uniform(aLocation, aType, aValue);
+			}else {
+				// glUniform would write to whichever program is current
+				if(! is_separable_supported()) throw std::runtime_error("asmith::gl::program::set_uniform : Program must be bound to set a uniform that is not shadowed");
+#ifdef GL_ARB_separate_shader_objects
+				upload_program_uniform(mID, aLocation, aType, aValue);
+#endif
+			}
+			++mUniformStatistics.uploads;
+			return;
+		}
+
+		uniform_slot& slot = mSlots[index];
+		uint8_t* const data = &mUniformData[slot.offset];
+		if(memcmp(data, aValue, aBytes) == 0) {
+			++mUniformStatistics.elided;
+			return;
+		}
+		memcpy(data, aValue, aBytes);
+		if(! slot.dirty) {
+			slot.dirty = true;
+			mDirtySlots.push_back(static_cast<uint32_t>(index));
+		}
+	}
+
+	void program::get_uniform_value(GLint aLocation, GLenum aType, void* aValue, size_t aBytes) const {
+		const int32_t index = find_slot(aLocation, aType);
+		if(index >= 0) {
+			memcpy(aValue, &mUniformData[mSlots[index].offset], aBytes);
+			return;
+		}
+		if(aLocation == -1) throw std::runtime_error("asmith::gl::program::get_uniform : Invalid uniform location");
+
+		// A boolean read as a float or unsigned integer, the shadow may hold a value that is not uploaded yet
+		const int32_t b = find_boolean_slot(aLocation, aType);
+		if(b >= 0) {
+			convert_from_boolean(aType, reinterpret_cast<const GLint*>(&mUniformData[mSlots[b].offset]), aValue, aBytes / sizeof(GLint));
+			return;
+		}
+
+		// Read the whole uniform into a buffer large enough for any type, the caller may want fewer components
+		union {
+			GLfloat f[16];
+			GLint i[16];
+			GLuint u[16];
+		} tmp;
+		switch(aType) {
+		case GL_INT: case GL_INT_VEC2: case GL_INT_VEC3: case GL_INT_VEC4:
+			glGetUniformiv(mID, aLocation, tmp.i);
+			break;
+		case GL_UNSIGNED_INT: case GL_UNSIGNED_INT_VEC2: case GL_UNSIGNED_INT_VEC3: case GL_UNSIGNED_INT_VEC4:
+			glGetUniformuiv(mID, aLocation, tmp.u);
+			break;
+		default:
+			glGetUniformfv(mID, aLocation, tmp.f);
+			break;
+		}
+		memcpy(aValue, &tmp, aBytes);
+	}
+
+	void program::flush_uniforms() throw() {
+		if(mDirtySlots.empty() || ! is_currently_bound()) return;
+		upload_uniforms();
+	}
+
+	void program::upload_uniforms() throw() {
+		for(const uint32_t i : mDirtySlots) {
+			uniform_slot& slot = mSlots[i];
+			upload_uniform(slot.location, slot.type, &mUniformData[slot.offset]);
+			slot.dirty = false;
+		}
+		mUniformStatistics.uploads += mDirtySlots.size();
+		mDirtySlots.clear();
+	}
+
+	program::uniform_statistics program::get_uniform_statistics() const throw() {
+		return mUniformStatistics;
+	}
+
+	void program::reset_uniform_statistics() throw() {
+		mUniformStatistics = uniform_statistics{ 0, 0, 0 };
 	}
 
 	//! \todo 2x3, 3x2, 2x4, 4x2, 3x4 and 4x3 matrix support
@@ -0,0 +1,169 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+#include "asmith/open_gl/program_binary_cache.hpp"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+namespace asmith { namespace gl {
+
+	static std::string get_driver_string(GLenum aName) {
+		const GLubyte* const str = glGetString(aName);
+		return str ? std::string(reinterpret_cast<const char*>(str)) : std::string();
+	}
+
+	// program_binary_cache
+
+	program_binary_cache::program_binary_cache(context& aContext, const std::string& aDirectory) :
+		mContext(aContext),
+		mDirectory(aDirectory),
+		mStatistics{ 0, 0, 0, 0, 0.0, 0.0, 0.0 },
+		mEnabled(program::is_binary_supported())
+	{
+		if(! mDirectory.empty() && mDirectory.back() != '/' && mDirectory.back() != '\\') mDirectory += '/';
+		// Separate the strings so that moving text from one to another cannot produce the same key
+		mDriver = get_driver_string(GL_VENDOR) + '\n' + get_driver_string(GL_RENDERER) + '\n' + get_driver_string(GL_VERSION);
+	}
+
+	program_binary_cache::~program_binary_cache() {
+
+	}
+
+	uint64_t program_binary_cache::get_key(const std::vector<std::shared_ptr<shader>>& aShaders, const std::string& aDefines) const {
+		uint64_t hash = implementation::hash_fnv1a(mDriver.c_str(), mDriver.size() + 1);
+		hash = implementation::hash_fnv1a(aDefines.c_str(), aDefines.size() + 1, hash);
+		for(const std::shared_ptr<shader>& i : aShaders) {
+			const std::string& source = i->get_source();
+			if(source.empty()) throw std::runtime_error("asmith::gl::program_binary_cache::get_key : Shader has no source");
+			const GLenum type = i->get_type();
+			hash = implementation::hash_fnv1a(&type, sizeof(GLenum), hash);
+			hash = implementation::hash_fnv1a(source.c_str(), source.size() + 1, hash);
+		}
+		return hash;
+	}
+
+	std::string program_binary_cache::get_path(uint64_t aKey) const {
+		char name[17];
+		std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(aKey));
+		return mDirectory + name + ".glbin";
+	}
+
+	bool program_binary_cache::read(uint64_t aKey, std::vector<uint8_t>& aBinary, file_header& aHeader) const {
+		std::ifstream file(get_path(aKey), std::ios::binary);
+		if(! file) return false;
+		if(! file.read(reinterpret_cast<char*>(&aHeader), sizeof(file_header))) return false;
+		if(aHeader.magic != FILE_MAGIC || aHeader.version != FILE_VERSION || aHeader.key != aKey || aHeader.length == 0) return false;
+		aBinary.resize(aHeader.length);
+		return file.read(reinterpret_cast<char*>(&aBinary[0]), aHeader.length) ? true : false;
+	}
+
+	bool program_binary_cache::write(uint64_t aKey, const program& aProgram, uint64_t aBuildMicroseconds) const {
+		file_header header;
+		GLenum format = 0;
+		const std::vector<uint8_t> binary = aProgram.get_binary(format);
+		if(binary.empty()) return false;
+
+		header.magic = FILE_MAGIC;
+		header.version = FILE_VERSION;
+		header.key = aKey;
+		header.format = format;
+		header.length = static_cast<uint32_t>(binary.size());
+		header.build_microseconds = aBuildMicroseconds;
+
+		// Write to a temporary file first so that another process never reads half of a binary
+		const std::string path = get_path(aKey);
+		const std::string tmp = path + ".tmp";
+		{
+			std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+			if(! file) return false;
+			file.write(reinterpret_cast<const char*>(&header), sizeof(file_header));
+			file.write(reinterpret_cast<const char*>(&binary[0]), binary.size());
+			if(! file) {
+				file.close();
+				std::remove(tmp.c_str());
+				return false;
+			}
+		}
+		std::remove(path.c_str());
+		if(std::rename(tmp.c_str(), path.c_str()) != 0) {
+			std::remove(tmp.c_str());
+			return false;
+		}
+		return true;
+	}
+
+	std::shared_ptr<program> program_binary_cache::build(const std::vector<std::shared_ptr<shader>>& aShaders, uint64_t& aMicroseconds) {
+		const auto start = std::chrono::steady_clock::now();
+		std::shared_ptr<program> tmp(new program(mContext));
+		for(const std::shared_ptr<shader>& i : aShaders) {
+			if(! (i->is_compiled() || i->is_compile_pending())) i->compile_async();
+			tmp->attach(i);
+		}
+		if(mEnabled) tmp->set_binary_retrievable(true);
+		tmp->link();
+		aMicroseconds = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+		mStatistics.build_seconds += static_cast<double>(aMicroseconds) / 1000000.0;
+		return tmp;
+	}
+
+	std::shared_ptr<program> program_binary_cache::link(const std::vector<std::shared_ptr<shader>>& aShaders, const std::string& aDefines) {
+		if(aShaders.empty()) throw std::runtime_error("asmith::gl::program_binary_cache::link : No shaders");
+		uint64_t microseconds = 0;
+		if(! mEnabled) {
+			++mStatistics.misses;
+			return build(aShaders, microseconds);
+		}
+
+		const uint64_t key = get_key(aShaders, aDefines);
+		std::vector<uint8_t> binary;
+		file_header header;
+		if(read(key, binary, header)) {
+			const auto start = std::chrono::steady_clock::now();
+			std::shared_ptr<program> tmp(new program(mContext));
+			for(const std::shared_ptr<shader>& i : aShaders) tmp->attach(i);
+			if(tmp->load_binary(header.format, &binary[0], static_cast<GLsizei>(binary.size()))) {
+				const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+				const double saved = static_cast<double>(header.build_microseconds) / 1000000.0 - seconds;
+				++mStatistics.hits;
+				mStatistics.load_seconds += seconds;
+				if(saved > 0.0) mStatistics.saved_seconds += saved;
+				return tmp;
+			}
+			++mStatistics.rejections;
+		}
+
+		++mStatistics.misses;
+		std::shared_ptr<program> tmp = build(aShaders, microseconds);
+		if(! write(key, *tmp, microseconds)) ++mStatistics.write_failures;
+		return tmp;
+	}
+
+	void program_binary_cache::remove(uint64_t aKey) {
+		std::remove(get_path(aKey).c_str());
+	}
+
+	bool program_binary_cache::is_enabled() const throw() {
+		return mEnabled;
+	}
+
+	program_binary_cache::statistics program_binary_cache::get_statistics() const throw() {
+		return mStatistics;
+	}
+
+	void program_binary_cache::reset_statistics() throw() {
+		mStatistics = statistics{ 0, 0, 0, 0, 0.0, 0.0, 0.0 };
+	}
+
+}}
\ No newline at end of file
@@ -0,0 +1,249 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+#include "asmith/open_gl/program_permutations.hpp"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace asmith { namespace gl {
+
+	static std::shared_ptr<shader> create_stage_shader(context& aContext, shader::type aType) {
+		switch(aType) {
+		case shader::VERTEX:					return std::shared_ptr<shader>(new vertex_shader(aContext));
+		case shader::GEOMETRY:					return std::shared_ptr<shader>(new geometry_shader(aContext));
+		case shader::FRAGMENT:					return std::shared_ptr<shader>(new fragment_shader(aContext));
+#if ASMITH_GL_VERSION_MAJOR >= 4
+	#if ASMITH_GL_VERSION_MINOR >= 3 || ASMITH_GL_VERSION_MAJOR > 4
+		case shader::COMPUTE:					return std::shared_ptr<shader>(new compute_shader(aContext));
+	#endif
+		case shader::TESSELLATION_CONTROL:		return std::shared_ptr<shader>(new tessellation_control_shader(aContext));
+		case shader::TESSELLATION_EVALUATION:	return std::shared_ptr<shader>(new tessellation_evaluation_shader(aContext));
+#endif
+		default:								throw std::runtime_error("asmith::gl::program_permutations::build : Unknown shader type");
+		}
+	}
+
+	// program_permutations
+
+	program_permutations::program_permutations(context& aContext, shader_preprocessor& aPreprocessor, program_binary_cache* aCache) :
+		mContext(aContext),
+		mPreprocessor(aPreprocessor),
+		mCache(aCache),
+		mStatistics{ 0, 0, 0, 0, 0.0, 0.0 }
+	{}
+
+	program_permutations::~program_permutations() {
+
+	}
+
+	void program_permutations::add_stage(shader::type aType, const std::string& aFile) {
+		if(! mPermutations.empty()) throw std::runtime_error("asmith::gl::program_permutations::add_stage : Permutations have already been built");
+		for(const stage& i : mStages) if(i.type == aType) throw std::runtime_error("asmith::gl::program_permutations::add_stage : Stage has already been added");
+		mStages.push_back(stage{ aType, aFile });
+	}
+
+	program_permutations::feature_mask program_permutations::add_feature(const std::string& aDefine) {
+		if(! mPermutations.empty()) throw std::runtime_error("asmith::gl::program_permutations::add_feature : Permutations have already been built");
+		if(mFeatures.size() >= 64) throw std::runtime_error("asmith::gl::program_permutations::add_feature : Too many features");
+		if(std::find(mFeatures.begin(), mFeatures.end(), aDefine) != mFeatures.end()) throw std::runtime_error("asmith::gl::program_permutations::add_feature : Feature has already been added");
+		mFeatures.push_back(aDefine);
+		return static_cast<feature_mask>(1) << (mFeatures.size() - 1);
+	}
+
+	program_permutations::feature_mask program_permutations::get_feature(const std::string& aDefine) const {
+		const auto i = std::find(mFeatures.begin(), mFeatures.end(), aDefine);
+		if(i == mFeatures.end()) throw std::runtime_error("asmith::gl::program_permutations::get_feature : Unknown feature '" + aDefine + "'");
+		return static_cast<feature_mask>(1) << (i - mFeatures.begin());
+	}
+
+	shader_preprocessor::define_set program_permutations::get_defines(feature_mask aMask) const {
+		check_mask(aMask);
+		shader_preprocessor::define_set defines;
+		for(size_t i = 0; i < mFeatures.size(); ++i) if(aMask & (static_cast<feature_mask>(1) << i)) defines.emplace(mFeatures[i], "1");
+		return defines;
+	}
+
+	void program_permutations::check_mask(feature_mask aMask) const {
+		const feature_mask valid = mFeatures.size() >= 64 ? ~static_cast<feature_mask>(0) : (static_cast<feature_mask>(1) << mFeatures.size()) - 1;
+		if(aMask & ~valid) throw std::runtime_error("asmith::gl::program_permutations : Mask contains features that have not been added");
+	}
+
+	std::shared_ptr<program> program_permutations::build(feature_mask aMask, bool aAsync) {
+		if(mStages.empty()) throw std::runtime_error("asmith::gl::program_permutations::build : No stages have been added");
+		const shader_preprocessor::define_set defines = get_defines(aMask);
+		std::vector<std::shared_ptr<shader>> shaders;
+		for(const stage& i : mStages) {
+			std::shared_ptr<shader> tmp = create_stage_shader(mContext, i.type);
+			tmp->set_source(mPreprocessor.preprocess_file(i.file, defines)->source.c_str());
+			shaders.push_back(tmp);
+		}
+
+		// The defines are already part of the sources, so they do not need to be added to the key
+		if(mCache) return mCache->link(shaders);
+
+		std::shared_ptr<program> tmp(new program(mContext));
+		for(const std::shared_ptr<shader>& i : shaders) {
+			i->compile_async();
+			tmp->attach(i);
+		}
+		if(aAsync) tmp->link_async();
+		else tmp->link();
+		return tmp;
+	}
+
+	std::shared_ptr<program> program_permutations::get(feature_mask aMask) {
+		check_mask(aMask);
+		++mStatistics.requests;
+
+		const auto i = mPermutations.find(aMask);
+		if(i != mPermutations.end()) {
+			permutation& p = i->second;
+			if(p.warmed_up && ! p.used) ++mStatistics.warm_up_hits;
+			p.used = true;
+			const std::shared_ptr<program> prog = p.prog;
+			if(prog->is_link_pending()) {
+				mPending.erase(std::find(mPending.begin(), mPending.end(), aMask));
+				try {
+					prog->finish_link();
+				}catch(...) {
+					mPermutations.erase(i);
+					throw;
+				}
+			}
+			return prog;
+		}
+
+		const auto start = std::chrono::steady_clock::now();
+		permutation p;
+		p.prog = build(aMask, false);
+		p.used = true;
+		p.warmed_up = false;
+		mPermutations.emplace(aMask, p);
+		++mStatistics.built_on_demand;
+		mStatistics.demand_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		return p.prog;
+	}
+
+	bool program_permutations::is_built(feature_mask aMask) const throw() {
+		const auto i = mPermutations.find(aMask);
+		return i != mPermutations.end() && ! i->second.prog->is_link_pending();
+	}
+
+	void program_permutations::warm_up(feature_mask aMask) {
+		check_mask(aMask);
+		if(mPermutations.find(aMask) != mPermutations.end()) return;
+		if(std::find(mWarmUpQueue.begin(), mWarmUpQueue.end(), aMask) != mWarmUpQueue.end()) return;
+		mWarmUpQueue.push_back(aMask);
+	}
+
+	void program_permutations::update(double aSeconds) {
+		const auto start = std::chrono::steady_clock::now();
+
+		// Collect the permutations that the driver has finished linking since the last update
+		for(size_t i = 0; i < mPending.size();) {
+			const feature_mask mask = mPending[i];
+			const std::shared_ptr<program> prog = mPermutations[mask].prog;
+			bool ready;
+			try {
+				// is_ready finishes the link and throws if it failed
+				ready = prog->is_ready();
+			}catch(...) {
+				// The error is not reported here, get will build it again and throw where the permutation is used
+				mPending.erase(mPending.begin() + i);
+				mPermutations.erase(mask);
+				continue;
+			}
+			if(ready) mPending.erase(mPending.begin() + i);
+			else ++i;
+		}
+
+		while(! mWarmUpQueue.empty() && std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() < aSeconds) {
+			const feature_mask mask = mWarmUpQueue.front();
+			mWarmUpQueue.pop_front();
+			if(mPermutations.find(mask) != mPermutations.end()) continue;
+
+			permutation p;
+			try {
+				p.prog = build(mask, true);
+			}catch(...) {
+				// As above, a permutation that does not build is left for get to report
+				continue;
+			}
+			p.used = false;
+			p.warmed_up = true;
+			mPermutations.emplace(mask, p);
+			if(p.prog->is_link_pending()) mPending.push_back(mask);
+			++mStatistics.warmed_up;
+		}
+
+		mStatistics.warm_up_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	size_t program_permutations::get_warm_up_count() const throw() {
+		return mWarmUpQueue.size() + mPending.size();
+	}
+
+	std::vector<program_permutations::feature_mask> program_permutations::get_used() const {
+		std::vector<feature_mask> used;
+		for(const auto& i : mPermutations) if(i.second.used) used.push_back(i.first);
+		std::sort(used.begin(), used.end());
+		return used;
+	}
+
+	void program_permutations::save_used(const std::string& aPath) const {
+		// One permutation per line, as the names of its features so that the file survives features being reordered
+		std::ofstream file(aPath);
+		if(! file) throw std::runtime_error("asmith::gl::program_permutations::save_used : Could not open '" + aPath + "'");
+		for(const feature_mask mask : get_used()) {
+			file << '-';
+			for(size_t i = 0; i < mFeatures.size(); ++i) if(mask & (static_cast<feature_mask>(1) << i)) file << ' ' << mFeatures[i];
+			file << '\n';
+		}
+	}
+
+	void program_permutations::load_used(const std::string& aPath) {
+		std::ifstream file(aPath);
+		if(! file) return;
+		std::string line;
+		while(std::getline(file, line)) {
+			std::istringstream ss(line);
+			std::string name;
+			if(! (ss >> name) || name != "-") continue;
+
+			feature_mask mask = 0;
+			bool known = true;
+			while(ss >> name) {
+				const auto i = std::find(mFeatures.begin(), mFeatures.end(), name);
+				if(i == mFeatures.end()) {
+					// The feature has been removed since the file was written
+					known = false;
+					break;
+				}
+				mask |= static_cast<feature_mask>(1) << (i - mFeatures.begin());
+			}
+			if(known) warm_up(mask);
+		}
+	}
+
+	program_permutations::statistics program_permutations::get_statistics() const throw() {
+		return mStatistics;
+	}
+
+	void program_permutations::reset_statistics() throw() {
+		mStatistics = statistics{ 0, 0, 0, 0, 0.0, 0.0 };
+	}
+
+}}
\ No newline at end of file
@@ -0,0 +1,187 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+#include "asmith/open_gl/program_pipeline.hpp"
+#include <stdexcept>
+#include "asmith/open_gl/context_state.hpp"
+
+#ifdef GL_ARB_separate_shader_objects
+namespace asmith { namespace gl {
+
+	static const GLbitfield STAGE_BITS[program_pipeline::STAGE_COUNT] = {
+		GL_VERTEX_SHADER_BIT,
+		GL_TESS_CONTROL_SHADER_BIT,
+		GL_TESS_EVALUATION_SHADER_BIT,
+		GL_GEOMETRY_SHADER_BIT,
+		GL_FRAGMENT_SHADER_BIT,
+		GL_COMPUTE_SHADER_BIT
+	};
+
+	static size_t get_stage_index(GLenum aType) throw() {
+		switch(aType) {
+		case GL_VERTEX_SHADER:			return 0;
+		case GL_TESS_CONTROL_SHADER:	return 1;
+		case GL_TESS_EVALUATION_SHADER:	return 2;
+		case GL_GEOMETRY_SHADER:		return 3;
+		case GL_FRAGMENT_SHADER:		return 4;
+		case GL_COMPUTE_SHADER:			return 5;
+		default:						return program_pipeline::STAGE_COUNT;
+		}
+	}
+
+	// program_pipeline::stage_key
+
+	bool program_pipeline::stage_key::operator==(const stage_key& aOther) const throw() {
+		for(size_t i = 0; i < STAGE_COUNT; ++i) if(programs[i] != aOther.programs[i]) return false;
+		return true;
+	}
+
+	size_t program_pipeline::stage_key_hash::operator()(const stage_key& aKey) const throw() {
+		return static_cast<size_t>(implementation::hash_fnv1a(aKey.programs, sizeof(aKey.programs)));
+	}
+
+	// program_pipeline
+
+	bool program_pipeline::is_supported() throw() {
+		return program::is_separable_supported();
+	}
+
+	std::shared_ptr<program_pipeline> program_pipeline::get_pipeline(context& aContext, const std::vector<std::shared_ptr<program>>& aPrograms) {
+		stage_key key = {};
+		for(const std::shared_ptr<program>& i : aPrograms) {
+			const GLbitfield stages = i->get_stages();
+			for(size_t j = 0; j < STAGE_COUNT; ++j) {
+				if(! (stages & STAGE_BITS[j])) continue;
+				if(key.programs[j] != 0) throw std::runtime_error("asmith::gl::program_pipeline::get_pipeline : Two programs provide the same stage");
+				key.programs[j] = i->get_id();
+			}
+		}
+
+		std::shared_ptr<program_pipeline>& p = aContext.state->pipeline_cache[key];
+		if(! p) {
+			std::shared_ptr<program_pipeline> tmp(new program_pipeline(aContext));
+			for(const std::shared_ptr<program>& i : aPrograms) tmp->use_program(i);
+			tmp->mCached = true;
+			p = tmp;
+		}
+		return p;
+	}
+
+	std::shared_ptr<program_pipeline> program_pipeline::get_bound_pipeline(context& aContext) throw() {
+		return aContext.state->currently_bound_pipeline;
+	}
+
+	void program_pipeline::clear_cache(context& aContext) throw() {
+		aContext.state->pipeline_cache.clear();
+	}
+
+	program_pipeline::program_pipeline(context& aContext) :
+		object(aContext),
+		mCached(false)
+	{
+		if(! is_supported()) throw std::runtime_error("asmith::gl::program_pipeline::program_pipeline : Separable programs are not supported");
+		glGenProgramPipelines(1, &mID);
+		if(mID == object::INVALID_ID) throw std::runtime_error("asmith::gl::program_pipeline::program_pipeline : glGenProgramPipelines returned 0");
+	}
+
+	program_pipeline::~program_pipeline() {
+		if(mID == 0) return;
+		glDeleteProgramPipelines(1, &mID);
+		mID = 0;
+	}
+
+	void program_pipeline::use_program(std::shared_ptr<program> aProgram) {
+		if(! aProgram) throw std::runtime_error("asmith::gl::program_pipeline::use_program : Program is null");
+		use_program(aProgram->get_stages(), aProgram);
+	}
+
+	void program_pipeline::use_program(GLbitfield aStages, std::shared_ptr<program> aProgram) {
+		if(mCached) throw std::runtime_error("asmith::gl::program_pipeline::use_program : Pipelines from get_pipeline are shared and cannot be changed");
+		if(! aProgram) throw std::runtime_error("asmith::gl::program_pipeline::use_program : Program is null");
+		if(! aProgram->is_separable()) throw std::runtime_error("asmith::gl::program_pipeline::use_program : Program is not separable");
+		aProgram->finish_link();
+		if(! aProgram->is_linked()) throw std::runtime_error("asmith::gl::program_pipeline::use_program : Program has not been linked");
+		if((aStages & aProgram->get_stages()) != aStages) throw std::runtime_error("asmith::gl::program_pipeline::use_program : Program does not contain all of the stages");
+
+		glUseProgramStages(mID, aStages, aProgram->get_id());
+		for(size_t i = 0; i < STAGE_COUNT; ++i) if(aStages & STAGE_BITS[i]) mPrograms[i] = aProgram;
+	}
+
+	void program_pipeline::clear_stages(GLbitfield aStages) {
+		if(mCached) throw std::runtime_error("asmith::gl::program_pipeline::clear_stages : Pipelines from get_pipeline are shared and cannot be changed");
+		glUseProgramStages(mID, aStages, 0);
+		for(size_t i = 0; i < STAGE_COUNT; ++i) if(aStages & STAGE_BITS[i]) mPrograms[i].reset();
+	}
+
+	std::shared_ptr<program> program_pipeline::get_program(shader::type aType) const throw() {
+		const size_t i = get_stage_index(aType);
+		return i < STAGE_COUNT ? mPrograms[i] : std::shared_ptr<program>();
+	}
+
+	program_pipeline::stage_key program_pipeline::get_key() const throw() {
+		stage_key key;
+		for(size_t i = 0; i < STAGE_COUNT; ++i) key.programs[i] = mPrograms[i] ? static_cast<GLuint>(mPrograms[i]->get_id()) : 0;
+		return key;
+	}
+
+	bool program_pipeline::validate() {
+		glValidateProgramPipeline(mID);
+		GLint status = GL_FALSE;
+		glGetProgramPipelineiv(mID, GL_VALIDATE_STATUS, &status);
+		return status != GL_FALSE;
+	}
+
+	std::string program_pipeline::get_info_log() const {
+		GLint logLength = 0;
+		glGetProgramPipelineiv(mID, GL_INFO_LOG_LENGTH, &logLength);
+		if(logLength <= 0) return std::string();
+
+		std::string log(logLength, '\0');
+		glGetProgramPipelineInfoLog(mID, logLength, &logLength, &log[0]);
+		log.resize(static_cast<size_t>(logLength));
+		return log;
+	}
+
+	void program_pipeline::bind() {
+		if(mContext.state->currently_bound_program) throw std::runtime_error("asmith::gl::program_pipeline::bind : A program is bound, which would be used instead of the pipeline");
+		std::shared_ptr<program_pipeline>& bound = mContext.state->currently_bound_pipeline;
+		if(bound.get() != this) {
+			glBindProgramPipeline(mID);
+			bound = std::static_pointer_cast<program_pipeline>(shared_from_this());
+		}
+		flush_uniforms();
+	}
+
+	void program_pipeline::unbind() {
+		if(! is_currently_bound()) throw std::runtime_error("asmith::gl::program_pipeline::unbind : Pipeline is not bound");
+		glBindProgramPipeline(0);
+		mContext.state->currently_bound_pipeline.reset();
+	}
+
+	bool program_pipeline::is_currently_bound() const throw() {
+		return mContext.state->currently_bound_pipeline.get() == this;
+	}
+
+	void program_pipeline::flush_uniforms() throw() {
+		if(! is_currently_bound()) return;
+		for(size_t i = 0; i < STAGE_COUNT; ++i) {
+			program* const p = mPrograms[i].get();
+			if(p == nullptr || p->mDirtySlots.empty()) continue;
+			// glUniform writes to the active program of the bound pipeline
+			glActiveShaderProgram(mID, p->get_id());
+			p->upload_uniforms();
+		}
+	}
+
+}}
+#endif
\ No newline at end of file
@@ -0,0 +1,293 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+#include "asmith/open_gl/render_queue.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace asmith { namespace gl {
+
+	enum : uint64_t {
+		PASS_SHIFT			= 60,
+		TRANSLUCENT_SHIFT	= 59,
+		PROGRAM_BITS		= 14,
+		TEXTURE_BITS		= 16,
+		VAO_BITS			= 12,
+		DEPTH_BITS			= 17,
+		PROGRAM_MASK		= (1ull << PROGRAM_BITS) - 1,
+		TEXTURE_MASK		= (1ull << TEXTURE_BITS) - 1,
+		VAO_MASK			= (1ull << VAO_BITS) - 1,
+		DEPTH_MASK			= (1ull << DEPTH_BITS) - 1
+	};
+
+	static bool same_textures(const render_queue::packet* aPrevious, const render_queue::packet& aNext) throw() {
+		if(aPrevious == nullptr) return aNext.texture_count == 0;
+		if(aPrevious->texture_count != aNext.texture_count) return false;
+		for(size_t i = 0; i < aNext.texture_count; ++i) if(aPrevious->textures[i] != aNext.textures[i]) return false;
+		return true;
+	}
+
+	static uint64_t quantise_depth(GLfloat aDepth, GLfloat aNear, GLfloat aFar) throw() {
+		GLfloat t = (aDepth - aNear) / (aFar - aNear);
+		// Also catches NaN
+		if(! (t > 0.f)) t = 0.f;
+		if(t > 1.f) t = 1.f;
+		return static_cast<uint64_t>(t * static_cast<GLfloat>(DEPTH_MASK) + 0.5f);
+	}
+
+	// render_queue
+
+	bool render_queue::same_material(const packet& a, const packet& b) throw() {
+		if(a.prog != b.prog || a.texture_count != b.texture_count || a.set_uniforms != b.set_uniforms) return false;
+		if(a.uniform_data != b.uniform_data || a.mode != b.mode || a.pass != b.pass || a.translucent != b.translucent) return false;
+		for(size_t i = 0; i < a.texture_count; ++i) {
+			if(a.textures[i] != b.textures[i] || a.sampler_locations[i] != b.sampler_locations[i]) return false;
+		}
+		return true;
+	}
+
+	uint64_t render_queue::hash_material(const packet& aPacket) throw() {
+		uint64_t hash = implementation::hash_fnv1a(&aPacket.prog, sizeof(aPacket.prog));
+		hash = implementation::hash_fnv1a(aPacket.textures, sizeof(texture*) * aPacket.texture_count, hash);
+		hash = implementation::hash_fnv1a(aPacket.sampler_locations, sizeof(GLint) * aPacket.texture_count, hash);
+		hash = implementation::hash_fnv1a(&aPacket.set_uniforms, sizeof(aPacket.set_uniforms), hash);
+		hash = implementation::hash_fnv1a(&aPacket.uniform_data, sizeof(aPacket.uniform_data), hash);
+		hash = implementation::hash_fnv1a(&aPacket.mode, sizeof(aPacket.mode), hash);
+		hash = implementation::hash_fnv1a(&aPacket.pass, sizeof(aPacket.pass), hash);
+		return implementation::hash_fnv1a(&aPacket.translucent, sizeof(aPacket.translucent), hash);
+	}
+
+	render_queue::render_queue(context& aContext) :
+		mContext(aContext),
+		mNear(0.f),
+		mFar(1.f),
+		mGeneration(0),
+		mStatistics{ 0, 0, 0, 0, 0, 0 },
+		mFrameStatistics{ 0, 0, 0, 0, 0, 0 }
+	{}
+
+	render_queue::~render_queue() {
+
+	}
+
+	void render_queue::set_depth_range(GLfloat aNear, GLfloat aFar) {
+		if(! (aFar > aNear)) throw std::runtime_error("asmith::gl::render_queue::set_depth_range : Far must be greater than near");
+		mNear = aNear;
+		mFar = aFar;
+	}
+
+	void render_queue::reserve(size_t aCount) {
+		mPackets.reserve(aCount);
+		mEntries.reserve(aCount);
+		mSortBuffer.reserve(aCount);
+	}
+
+	render_queue::sort_key render_queue::submit(const packet& aPacket) {
+		if(aPacket.prog == nullptr) throw std::runtime_error("asmith::gl::render_queue::submit : Program is null");
+		if(aPacket.vao == nullptr) throw std::runtime_error("asmith::gl::render_queue::submit : Vertex array is null");
+		if(aPacket.texture_count > MAX_TEXTURES) throw std::runtime_error("asmith::gl::render_queue::submit : Too many textures");
+		if(aPacket.pass >= MAX_PASSES) throw std::runtime_error("asmith::gl::render_queue::submit : Pass is out of range");
+#if ! ASMITH_GL_VERSION_GE(3,3)
+		if(aPacket.instance_count > 0) throw std::runtime_error("asmith::gl::render_queue::submit : Instancing is not supported");
+#endif
+		if(mPackets.size() >= UINT32_MAX) throw std::runtime_error("asmith::gl::render_queue::submit : Too many packets");
+		for(size_t i = 0; i < aPacket.texture_count; ++i) if(aPacket.textures[i] == nullptr) throw std::runtime_error("asmith::gl::render_queue::submit : Texture is null");
+
+		const uint64_t prog = aPacket.prog->get_id() & PROGRAM_MASK;
+		const uint64_t textures = implementation::hash_fnv1a(aPacket.textures, sizeof(texture*) * aPacket.texture_count) & TEXTURE_MASK;
+		const uint64_t vao = aPacket.vao->get_id() & VAO_MASK;
+		const uint64_t depth = quantise_depth(aPacket.depth, mNear, mFar);
+
+		sort_key key = static_cast<uint64_t>(aPacket.pass) << PASS_SHIFT;
+		if(aPacket.translucent) {
+			// Blending needs back to front order, state changes come second
+			key |= 1ull << TRANSLUCENT_SHIFT;
+			key |= (DEPTH_MASK - depth) << (TRANSLUCENT_SHIFT - DEPTH_BITS);
+			key |= prog << (TEXTURE_BITS + VAO_BITS);
+			key |= textures << VAO_BITS;
+			key |= vao;
+		}else {
+			// Front to back within a state group lets early depth testing reject hidden fragments
+			key |= prog << (TEXTURE_BITS + VAO_BITS + DEPTH_BITS);
+			key |= textures << (VAO_BITS + DEPTH_BITS);
+			key |= vao << DEPTH_BITS;
+			key |= depth;
+		}
+
+		mEntries.push_back(sort_entry{ key, static_cast<uint32_t>(mPackets.size()) });
+		mPackets.push_back(aPacket);
+		return key;
+	}
+
+	size_t render_queue::size() const throw() {
+		return mPackets.size();
+	}
+
+	void render_queue::clear() throw() {
+		mPackets.clear();
+		mEntries.clear();
+		++mGeneration;
+	}
+
+	size_t render_queue::count_submission_changes() const throw() {
+		size_t changes = 0;
+		const packet* previous = nullptr;
+		for(const packet& i : mPackets) {
+			if(previous == nullptr || previous->prog != i.prog) ++changes;
+			if(! same_textures(previous, i)) ++changes;
+			if(previous == nullptr || previous->vao != i.vao) ++changes;
+			previous = &i;
+		}
+		return changes;
+	}
+
+	void render_queue::sort() throw() {
+		const size_t count = mEntries.size();
+		if(count < 2) return;
+
+		// LSD radix sort on 8 bit digits, all of the histograms are built in one pass over the keys
+		size_t histograms[8][256] = {};
+		for(const sort_entry& i : mEntries) {
+			sort_key key = i.key;
+			for(size_t d = 0; d < 8; ++d) {
+				++histograms[d][key & 255];
+				key >>= 8;
+			}
+		}
+
+		mSortBuffer.resize(count);
+		sort_entry* src = mEntries.data();
+		sort_entry* dst = mSortBuffer.data();
+		for(size_t d = 0; d < 8; ++d) {
+			size_t* const histogram = histograms[d];
+			const size_t shift = d * 8;
+			// Every key has the same digit, the pass would not change the order
+			if(histogram[(src[0].key >> shift) & 255] == count) continue;
+
+			size_t offset = 0;
+			for(size_t i = 0; i < 256; ++i) {
+				const size_t n = histogram[i];
+				histogram[i] = offset;
+				offset += n;
+			}
+			for(size_t i = 0; i < count; ++i) dst[histogram[(src[i].key >> shift) & 255]++] = src[i];
+			std::swap(src, dst);
+		}
+		if(src != mEntries.data()) mEntries.swap(mSortBuffer);
+	}
+
+	void render_queue::replay() {
+		program* prog = nullptr;
+		const packet* textures = nullptr;
+		size_t boundTextures = 0;
+		vertex_array* vao = nullptr;
+		GLuint units[MAX_TEXTURES];
+
+		const auto release = [&]() {
+			if(vao) vao->unbind();
+			for(size_t i = 0; i < boundTextures; ++i) textures->textures[i]->unbind();
+			if(prog) prog->unbind();
+		};
+
+		try {
+			for(const sort_entry& e : mEntries) {
+				const packet& p = mPackets[e.index];
+
+				const bool programChanged = p.prog != prog;
+				if(programChanged) {
+					if(prog) prog->unbind();
+					prog = nullptr;
+					p.prog->bind();
+					prog = p.prog;
+					++mFrameStatistics.program_changes;
+				}
+
+				const bool texturesChanged = ! same_textures(textures, p);
+				if(texturesChanged) {
+					for(size_t i = 0; i < boundTextures; ++i) textures->textures[i]->unbind();
+					textures = &p;
+					boundTextures = 0;
+					for(size_t i = 0; i < p.texture_count; ++i) {
+						units[i] = p.textures[i]->bind();
+						++boundTextures;
+					}
+					++mFrameStatistics.texture_changes;
+				}
+
+				// The shadow copy elides the samplers that the program already has
+				if(programChanged || texturesChanged) {
+					for(size_t i = 0; i < p.texture_count; ++i) if(p.sampler_locations[i] != -1) prog->set_uniform(p.sampler_locations[i], static_cast<GLint>(units[i]));
+				}
+
+				if(p.vao != vao) {
+					p.vao->bind();
+					vao = p.vao;
+					++mFrameStatistics.vao_changes;
+				}
+
+				if(p.set_uniforms) p.set_uniforms(*prog, p.uniform_data);
+#if ASMITH_GL_VERSION_GE(3,3)
+				if(p.instance_count > 0) vao->draw_arrays_instanced(p.mode, p.first, p.count, p.instance_count, p.base_instance);
+				else
+#endif
+				vao->draw_arrays(p.mode, p.first, p.count);
+			}
+		}catch(...) {
+			release();
+			throw;
+		}
+		release();
+	}
+
+	void render_queue::execute() {
+		mFrameStatistics = statistics{ 1, mPackets.size(), 0, 0, 0, 0 };
+		const size_t unsorted = count_submission_changes();
+
+		sort();
+		try {
+			replay();
+		}catch(...) {
+			clear();
+			throw;
+		}
+		clear();
+
+		const size_t sorted = mFrameStatistics.program_changes + mFrameStatistics.texture_changes + mFrameStatistics.vao_changes;
+		mFrameStatistics.changes_avoided = unsorted > sorted ? unsorted - sorted : 0;
+
+		mStatistics.frames += mFrameStatistics.frames;
+		mStatistics.packets += mFrameStatistics.packets;
+		mStatistics.program_changes += mFrameStatistics.program_changes;
+		mStatistics.texture_changes += mFrameStatistics.texture_changes;
+		mStatistics.vao_changes += mFrameStatistics.vao_changes;
+		mStatistics.changes_avoided += mFrameStatistics.changes_avoided;
+	}
+
+	size_t render_queue::get_generation() const throw() {
+		return mGeneration;
+	}
+
+	render_queue::statistics render_queue::get_statistics() const throw() {
+		return mStatistics;
+	}
+
+	render_queue::statistics render_queue::get_frame_statistics() const throw() {
+		return mFrameStatistics;
+	}
+
+	void render_queue::reset_statistics() throw() {
+		mStatistics = statistics{ 0, 0, 0, 0, 0, 0 };
+		mFrameStatistics = statistics{ 0, 0, 0, 0, 0, 0 };
+	}
+
+}}
\ No newline at end of file
@@ -0,0 +1,203 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+#include "asmith/open_gl/sampler.hpp"
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include "asmith/open_gl/context_state.hpp"
+
+#if ASMITH_GL_VERSION_GE(3,3)
+namespace asmith { namespace gl {
+
+	// sampler::state
+
+	sampler::state::state() throw() :
+		min_filter(GL_NEAREST_MIPMAP_LINEAR),
+		mag_filter(GL_LINEAR),
+		wrap_s(GL_REPEAT),
+		wrap_t(GL_REPEAT),
+		wrap_r(GL_REPEAT),
+		compare_mode(GL_NONE),
+		compare_func(GL_LEQUAL)
+	{
+		border_colour[0] = 0.f;
+		border_colour[1] = 0.f;
+		border_colour[2] = 0.f;
+		border_colour[3] = 0.f;
+	}
+
+	bool sampler::state::operator==(const state& aOther) const throw() {
+		return
+			min_filter == aOther.min_filter &&
+			mag_filter == aOther.mag_filter &&
+			wrap_s == aOther.wrap_s &&
+			wrap_t == aOther.wrap_t &&
+			wrap_r == aOther.wrap_r &&
+			compare_mode == aOther.compare_mode &&
+			compare_func == aOther.compare_func &&
+			memcmp(&border_colour[0], &aOther.border_colour[0], sizeof(GLfloat) * 4) == 0;
+	}
+
+	bool sampler::state::operator!=(const state& aOther) const throw() {
+		return ! operator==(aOther);
+	}
+
+	// sampler::state_hash
+
+	size_t sampler::state_hash::operator()(const state& aState) const throw() {
+		const GLenum enums[7] = {
+			aState.min_filter,
+			aState.mag_filter,
+			aState.wrap_s,
+			aState.wrap_t,
+			aState.wrap_r,
+			aState.compare_mode,
+			aState.compare_func
+		};
+		const uint64_t hash = implementation::hash_fnv1a(enums, sizeof(enums));
+		return static_cast<size_t>(implementation::hash_fnv1a(&aState.border_colour[0], sizeof(GLfloat) * 4, hash));
+	}
+
+	// sampler
+
+	std::shared_ptr<sampler> sampler::get_sampler(context& aContext, const state& aState) {
+		std::shared_ptr<sampler>& s = aContext.state->sampler_cache[aState];
+		if(! s) {
+			s.reset(new sampler(aContext));
+			s->set_state(aState);
+			s->mCached = true;
+		}
+		return s;
+	}
+
+	void sampler::clear_cache(context& aContext) throw() {
+		aContext.state->sampler_cache.clear();
+	}
+
+	std::shared_ptr<sampler> sampler::get_sampler_bound_to(context& aContext, GLuint aUnit) throw() {
+		const std::vector<std::weak_ptr<sampler>>& units = aContext.state->bound_samplers;
+		return aUnit < units.size() ? units[aUnit].lock() : std::shared_ptr<sampler>();
+	}
+
+	void sampler::unbind(context& aContext, GLuint aUnit) throw() {
+		std::vector<std::weak_ptr<sampler>>& units = aContext.state->bound_samplers;
+		if(aUnit >= units.size() || units[aUnit].expired()) return;
+		glBindSampler(aUnit, 0);
+		units[aUnit].reset();
+	}
+
+	sampler::sampler(context& aContext) :
+		object(aContext),
+		mCached(false)
+	{
+		glGenSamplers(1, &mID);
+		if(mID == object::INVALID_ID) throw std::runtime_error("asmith::gl::sampler::sampler : glGenSamplers returned 0");
+	}
+
+	sampler::~sampler() {
+		if(mID == 0) return;
+		glDeleteSamplers(1, &mID);
+		mID = 0;
+	}
+
+	void sampler::check_mutable(const char* aFunction) const {
+		if(mCached) throw std::runtime_error(std::string("asmith::gl::sampler::") + aFunction + " : Cached samplers cannot be modified");
+	}
+
+	const sampler::state& sampler::get_state() const throw() {
+		return mState;
+	}
+
+	bool sampler::is_cached() const throw() {
+		return mCached;
+	}
+
+	void sampler::set_state(const state& aState) {
+		check_mutable("set_state");
+		set_filter(aState.min_filter, aState.mag_filter);
+		set_wrap(aState.wrap_s, aState.wrap_t, aState.wrap_r);
+		set_border_colour(aState.border_colour);
+		set_compare(aState.compare_mode, aState.compare_func);
+	}
+
+	void sampler::set_filter(GLenum aValue) {
+		set_filter(aValue, aValue == GL_NEAREST || aValue == GL_NEAREST_MIPMAP_NEAREST || aValue == GL_NEAREST_MIPMAP_LINEAR ? GL_NEAREST : GL_LINEAR);
+	}
+
+	void sampler::set_filter(GLenum aMin, GLenum aMag) {
+		check_mutable("set_filter");
+		if(mState.min_filter != aMin) {
+			mState.min_filter = aMin;
+			glSamplerParameteri(mID, GL_TEXTURE_MIN_FILTER, aMin);
+		}
+		if(mState.mag_filter != aMag) {
+			mState.mag_filter = aMag;
+			glSamplerParameteri(mID, GL_TEXTURE_MAG_FILTER, aMag);
+		}
+	}
+
+	void sampler::set_wrap(GLenum aValue) {
+		set_wrap(aValue, aValue, aValue);
+	}
+
+	void sampler::set_wrap(GLenum aS, GLenum aT, GLenum aR) {
+		check_mutable("set_wrap");
+		if(mState.wrap_s != aS) {
+			mState.wrap_s = aS;
+			glSamplerParameteri(mID, GL_TEXTURE_WRAP_S, aS);
+		}
+		if(mState.wrap_t != aT) {
+			mState.wrap_t = aT;
+			glSamplerParameteri(mID, GL_TEXTURE_WRAP_T, aT);
+		}
+		if(mState.wrap_r != aR) {
+			mState.wrap_r = aR;
+			glSamplerParameteri(mID, GL_TEXTURE_WRAP_R, aR);
+		}
+	}
+
+	void sampler::set_border_colour(const vec4f& aValue) {
+		check_mutable("set_border_colour");
+		if(memcmp(&mState.border_colour[0], &aValue[0], sizeof(GLfloat) * 4) == 0) return;
+		memcpy(&mState.border_colour[0], &aValue[0], sizeof(GLfloat) * 4);
+		glSamplerParameterfv(mID, GL_TEXTURE_BORDER_COLOR, &mState.border_colour[0]);
+	}
+
+	void sampler::set_compare(GLenum aMode, GLenum aFunc) {
+		check_mutable("set_compare");
+		if(mState.compare_mode != aMode) {
+			mState.compare_mode = aMode;
+			glSamplerParameteri(mID, GL_TEXTURE_COMPARE_MODE, aMode);
+		}
+		if(mState.compare_func != aFunc) {
+			mState.compare_func = aFunc;
+			glSamplerParameteri(mID, GL_TEXTURE_COMPARE_FUNC, aFunc);
+		}
+	}
+
+	void sampler::bind(GLuint aUnit) throw() {
+		std::vector<std::weak_ptr<sampler>>& units = mContext.state->bound_samplers;
+		if(aUnit >= units.size()) units.resize(aUnit + 1);
+		if(units[aUnit].lock().get() == this) return;
+		glBindSampler(aUnit, mID);
+		units[aUnit] = std::static_pointer_cast<sampler>(shared_from_this());
+	}
+
+	bool sampler::is_bound(GLuint aUnit) const throw() {
+		const std::vector<std::weak_ptr<sampler>>& units = mContext.state->bound_samplers;
+		return aUnit < units.size() && units[aUnit].lock().get() == this;
+	}
+
+}}
+#endif
\ No newline at end of file
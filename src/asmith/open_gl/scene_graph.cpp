@@ -0,0 +1,261 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+#include "asmith/open_gl/scene_graph.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace asmith { namespace gl {
+
+	enum : size_t {
+		// Depths with fewer nodes than this are updated on the calling thread
+		PARALLEL_GRAIN = 4096
+	};
+
+	// scene_graph
+
+	scene_graph::scene_graph() :
+		scene_graph(thread_pool::get_default())
+	{}
+
+	scene_graph::scene_graph(thread_pool& aPool) :
+		mFirstRoot(INVALID_NODE),
+		mPool(aPool),
+		mDirtyCount(0),
+		mOrderChanged(false),
+		mStatistics{ 0, 0, 0 }
+	{
+		mLevels.push_back(0);
+	}
+
+	scene_graph::~scene_graph() {
+
+	}
+
+	const scene_graph::link& scene_graph::get_link(node aNode, const char* aFunction) const {
+		if(! is_valid(aNode)) throw std::runtime_error(std::string("asmith::gl::scene_graph::") + aFunction + " : Invalid node");
+		return mLinks[aNode];
+	}
+
+	void scene_graph::attach(node aNode, node aParent) throw() {
+		link& l = mLinks[aNode];
+		node& first = aParent == INVALID_NODE ? mFirstRoot : mLinks[aParent].first_child;
+		l.parent = aParent;
+		l.previous_sibling = INVALID_NODE;
+		l.next_sibling = first;
+		if(first != INVALID_NODE) mLinks[first].previous_sibling = aNode;
+		first = aNode;
+	}
+
+	void scene_graph::detach(node aNode) throw() {
+		link& l = mLinks[aNode];
+		if(l.previous_sibling != INVALID_NODE) mLinks[l.previous_sibling].next_sibling = l.next_sibling;
+		else if(l.parent == INVALID_NODE) mFirstRoot = l.next_sibling;
+		else mLinks[l.parent].first_child = l.next_sibling;
+		if(l.next_sibling != INVALID_NODE) mLinks[l.next_sibling].previous_sibling = l.previous_sibling;
+		l.parent = INVALID_NODE;
+		l.next_sibling = INVALID_NODE;
+		l.previous_sibling = INVALID_NODE;
+	}
+
+	void scene_graph::mark_dirty(uint32_t aIndex) throw() {
+		if(mDirty[aIndex]) return;
+		mDirty[aIndex] = 1;
+		++mDirtyCount;
+	}
+
+	scene_graph::node scene_graph::create_node(node aParent) {
+		if(aParent != INVALID_NODE) get_link(aParent, "create_node");
+		if(mLocal.size() >= UINT32_MAX - 1) throw std::runtime_error("asmith::gl::scene_graph::create_node : Too many nodes");
+
+		node n;
+		if(mFreeNodes.empty()) {
+			n = static_cast<node>(mLinks.size());
+			mLinks.push_back(link());
+		}else {
+			n = mFreeNodes.back();
+			mFreeNodes.pop_back();
+		}
+
+		// The node is added at the end, reorder moves it after its parent
+		const uint32_t index = static_cast<uint32_t>(mLocal.size());
+		mLinks[n] = link{ INVALID_NODE, INVALID_NODE, INVALID_NODE, INVALID_NODE, index };
+		mLocal.push_back(matrix4::identity());
+		mWorld.push_back(matrix4::identity());
+		mParents.push_back(UINT32_MAX);
+		mDirty.push_back(0);
+		mNodes.push_back(n);
+		attach(n, aParent);
+		mark_dirty(index);
+		mOrderChanged = true;
+		return n;
+	}
+
+	void scene_graph::destroy_node(node aNode) {
+		get_link(aNode, "destroy_node");
+		detach(aNode);
+
+		std::vector<node> stack(1, aNode);
+		while(! stack.empty()) {
+			const node n = stack.back();
+			stack.pop_back();
+			for(node c = mLinks[n].first_child; c != INVALID_NODE; c = mLinks[c].next_sibling) stack.push_back(c);
+
+			// The slot in the arrays is removed by reorder
+			link& l = mLinks[n];
+			mNodes[l.index] = INVALID_NODE;
+			l = link{ INVALID_NODE, INVALID_NODE, INVALID_NODE, INVALID_NODE, UINT32_MAX };
+			mFreeNodes.push_back(n);
+		}
+		mOrderChanged = true;
+	}
+
+	bool scene_graph::is_valid(node aNode) const throw() {
+		return aNode < mLinks.size() && mLinks[aNode].index != UINT32_MAX;
+	}
+
+	size_t scene_graph::size() const throw() {
+		return mLinks.size() - mFreeNodes.size();
+	}
+
+	void scene_graph::set_parent(node aNode, node aParent) {
+		const link& l = get_link(aNode, "set_parent");
+		if(l.parent == aParent) return;
+		if(aParent != INVALID_NODE) {
+			get_link(aParent, "set_parent");
+			for(node i = aParent; i != INVALID_NODE; i = mLinks[i].parent) {
+				if(i == aNode) throw std::runtime_error("asmith::gl::scene_graph::set_parent : Node would become its own ancestor");
+			}
+		}
+
+		detach(aNode);
+		attach(aNode, aParent);
+		mark_dirty(mLinks[aNode].index);
+		mOrderChanged = true;
+	}
+
+	scene_graph::node scene_graph::get_parent(node aNode) const {
+		return get_link(aNode, "get_parent").parent;
+	}
+
+	scene_graph::node scene_graph::get_first_child(node aNode) const {
+		return get_link(aNode, "get_first_child").first_child;
+	}
+
+	scene_graph::node scene_graph::get_next_sibling(node aNode) const {
+		return get_link(aNode, "get_next_sibling").next_sibling;
+	}
+
+	void scene_graph::set_local(node aNode, const mat4& aMatrix) {
+		const uint32_t index = get_link(aNode, "set_local").index;
+		mLocal[index] = matrix::load(aMatrix);
+		mark_dirty(index);
+	}
+
+	const mat4& scene_graph::get_local(node aNode) const {
+		return mLocal[get_link(aNode, "get_local").index].as_gl();
+	}
+
+	const mat4& scene_graph::get_world(node aNode) const {
+		return mWorld[get_link(aNode, "get_world").index].as_gl();
+	}
+
+	void scene_graph::reorder() {
+		// A breadth first walk from every root at once visits the nodes in order of depth
+		std::vector<node> order;
+		order.reserve(size());
+		for(node n = mFirstRoot; n != INVALID_NODE; n = mLinks[n].next_sibling) order.push_back(n);
+		mLevels.clear();
+		mLevels.push_back(0);
+		size_t begin = 0;
+		while(begin < order.size()) {
+			const size_t end = order.size();
+			mLevels.push_back(end);
+			for(size_t i = begin; i < end; ++i) {
+				for(node c = mLinks[order[i]].first_child; c != INVALID_NODE; c = mLinks[c].next_sibling) order.push_back(c);
+			}
+			begin = end;
+		}
+
+		const size_t count = order.size();
+		std::vector<matrix> local(count);
+		std::vector<matrix> world(count);
+		std::vector<uint32_t> parents(count);
+		std::vector<uint8_t> dirty(count);
+		mDirtyCount = 0;
+		for(size_t i = 0; i < count; ++i) {
+			link& l = mLinks[order[i]];
+			local[i] = mLocal[l.index];
+			world[i] = mWorld[l.index];
+			dirty[i] = mDirty[l.index];
+			mDirtyCount += dirty[i];
+			// Parents come first, so their index has already been changed
+			parents[i] = l.parent == INVALID_NODE ? UINT32_MAX : mLinks[l.parent].index;
+			l.index = static_cast<uint32_t>(i);
+		}
+
+		mLocal.swap(local);
+		mWorld.swap(world);
+		mParents.swap(parents);
+		mDirty.swap(dirty);
+		mNodes.swap(order);
+		mOrderChanged = false;
+		++mStatistics.reorders;
+	}
+
+	void scene_graph::update_range(size_t aBegin, size_t aEnd) throw() {
+		// The flags of the previous depth already include their ancestors, so a change reaches the whole subtree
+		for(size_t i = aBegin; i < aEnd; ++i) {
+			const uint32_t p = mParents[i];
+			if(p == UINT32_MAX) {
+				if(mDirty[i]) mWorld[i] = mLocal[i];
+				continue;
+			}
+			if(mDirty[p]) mDirty[i] = 1;
+			if(mDirty[i]) multiply(mWorld[p], mLocal[i], mWorld[i]);
+		}
+	}
+
+	void scene_graph::update() {
+		++mStatistics.updates;
+		if(mOrderChanged) reorder();
+		if(mDirtyCount == 0) return;
+
+		for(size_t l = 0; l + 1 < mLevels.size(); ++l) {
+			const size_t begin = mLevels[l];
+			const size_t end = mLevels[l + 1];
+			if(end - begin < PARALLEL_GRAIN * 2) {
+				update_range(begin, end);
+			}else {
+				mPool.parallel_for(begin, end, PARALLEL_GRAIN, [this](size_t aBegin, size_t aEnd) {
+					update_range(aBegin, aEnd);
+				});
+			}
+		}
+
+		for(uint8_t& i : mDirty) {
+			mStatistics.nodes_updated += i;
+			i = 0;
+		}
+		mDirtyCount = 0;
+	}
+
+	scene_graph::statistics scene_graph::get_statistics() const throw() {
+		return mStatistics;
+	}
+
+	void scene_graph::reset_statistics() throw() {
+		mStatistics = statistics{ 0, 0, 0 };
+	}
+
+}}
\ No newline at end of file
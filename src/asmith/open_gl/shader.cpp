@@ -21,7 +21,8 @@ namespace asmith { namespace gl {
 	shader::shader(context& aContext, type aType):
 		object(aContext),
 		mType(aType),
-		mCompiled(false)
+		mCompiled(false),
+		mPending(false)
 	{
 		mID = glCreateShader(mType);
 		if (mID == object::INVALID_ID) throw std::runtime_error("asmith::gl::shader::create : glCreateShader returned 0");
@@ -39,10 +40,57 @@ namespace asmith { namespace gl {
 		return mType;
 	}
 	
+	void shader::set_source(const char* aSource) {
+		if(mPending) throw std::runtime_error("asmith::gl::shader::set_source : Shader is still compiling");
+		mSource = aSource;
+		mCompiled = false;
+	}
+
+	const std::string& shader::get_source() const throw() {
+		return mSource;
+	}
+
 	void shader::compile(const char* aSource) {
-		const GLint length = strlen(aSource);
-		glShaderSource(mID, 1, &aSource, &length);
+		set_source(aSource);
+		compile();
+	}
+
+	void shader::compile() {
+		compile_async();
+		finish_compile();
+	}
+
+	void shader::compile_async() {
+		if(mSource.empty()) throw std::runtime_error("asmith::gl::shader::compile_async : Shader has no source");
+		const GLchar* const source = mSource.c_str();
+		const GLint length = static_cast<GLint>(mSource.size());
+		glShaderSource(mID, 1, &source, &length);
 		glCompileShader(mID);
+		// Querying the status now would wait for the driver, so it is left until finish_compile
+		mCompiled = false;
+		mPending = true;
+	}
+
+	bool shader::is_compile_pending() const throw() {
+		return mPending;
+	}
+
+	bool shader::is_compile_complete() const throw() {
+		if(! mPending) return true;
+#ifdef GL_KHR_parallel_shader_compile
+		if(is_parallel_compile_supported()) {
+			GLint complete = GL_FALSE;
+			glGetShaderiv(mID, GL_COMPLETION_STATUS_KHR, &complete);
+			return complete != GL_FALSE;
+		}
+#endif
+		// Without the extension there is no way to ask without waiting
+		return true;
+	}
+
+	void shader::finish_compile() {
+		if(! mPending) return;
+		mPending = false;
          
 		GLint status = 0;
 		glGetShaderiv(mID, GL_COMPILE_STATUS, &status);
@@ -58,6 +106,21 @@ namespace asmith { namespace gl {
 		mCompiled = true;
 	}
 
+	bool shader::is_parallel_compile_supported() throw() {
+#ifdef GL_KHR_parallel_shader_compile
+		return GLEW_KHR_parallel_shader_compile ? true : false;
+#else
+		return false;
+#endif
+	}
+
+	void shader::set_max_compiler_threads(GLuint aThreads) {
+		if(! is_parallel_compile_supported()) throw std::runtime_error("asmith::gl::shader::set_max_compiler_threads : KHR_parallel_shader_compile is not supported");
+#ifdef GL_KHR_parallel_shader_compile
+		glMaxShaderCompilerThreadsKHR(aThreads);
+#endif
+	}
+
 	bool shader::is_compiled() const throw() {
 		return mCompiled;
 	}
@@ -0,0 +1,289 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+#include "asmith/open_gl/shader_preprocessor.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace asmith { namespace gl {
+
+	static bool parse_directive(const std::string& aLine, const char* aName, std::string& aArgument) {
+		// Lines are canonicalised, so there is at most one space between the # and the name
+		if(aLine.empty() || aLine[0] != '#') return false;
+		size_t i = 1;
+		if(i < aLine.size() && aLine[i] == ' ') ++i;
+		const size_t length = strlen(aName);
+		if(aLine.compare(i, length, aName) != 0) return false;
+		i += length;
+		if(i < aLine.size() && aLine[i] != ' ') return false;
+		aArgument = i < aLine.size() ? aLine.substr(i + 1) : std::string();
+		return true;
+	}
+
+	static bool is_identifier(const std::string& aName) throw() {
+		if(aName.empty() || (aName[0] >= '0' && aName[0] <= '9')) return false;
+		for(const char c : aName) {
+			if(! ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_')) return false;
+		}
+		return true;
+	}
+
+	// shader_preprocessor
+
+	shader_preprocessor::shader_preprocessor() :
+		mStatistics{ 0, 0, 0, 0 }
+	{}
+
+	shader_preprocessor::~shader_preprocessor() {
+
+	}
+
+	std::string shader_preprocessor::canonicalise(const std::string& aSource) {
+		std::string out;
+		out.reserve(aSource.size());
+		size_t lineBegin = 0;
+		bool space = false;
+		bool quote = false;
+		const size_t size = aSource.size();
+
+		for(size_t i = 0; i < size; ++i) {
+			const char c = aSource[i];
+			if(c == '\n') {
+				out += '\n';
+				lineBegin = out.size();
+				space = false;
+				quote = false;
+				continue;
+			}
+
+			if(! quote) {
+				if(c == '/' && i + 1 < size && aSource[i + 1] == '/') {
+					while(i + 1 < size && aSource[i + 1] != '\n') ++i;
+					continue;
+				}
+				if(c == '/' && i + 1 < size && aSource[i + 1] == '*') {
+					// Keep the line breaks inside the comment so that line numbers do not change
+					for(i += 2; i < size && ! (aSource[i] == '*' && i + 1 < size && aSource[i + 1] == '/'); ++i) {
+						if(aSource[i] == '\n') {
+							out += '\n';
+							lineBegin = out.size();
+						}
+					}
+					++i;
+					space = true;
+					continue;
+				}
+				if(c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v') {
+					space = true;
+					continue;
+				}
+			}
+
+			// Whitespace is only written between tokens, never at the start or end of a line
+			if(space && out.size() > lineBegin) out += ' ';
+			space = false;
+			if(c == '"') quote = ! quote;
+			out += c;
+		}
+		return out;
+	}
+
+	std::string shader_preprocessor::get_define_string(const define_set& aDefines) {
+		// define_set is ordered by name, so the same defines always give the same string
+		std::string defines;
+		for(const auto& i : aDefines) {
+			if(! is_identifier(i.first)) throw std::runtime_error("asmith::gl::shader_preprocessor::get_define_string : '" + i.first + "' is not a valid macro name");
+			if(i.second.find('\n') != std::string::npos) throw std::runtime_error("asmith::gl::shader_preprocessor::get_define_string : Value of '" + i.first + "' contains a line break");
+			defines += "#define ";
+			defines += i.first;
+			if(! i.second.empty()) {
+				defines += ' ';
+				defines += i.second;
+			}
+			defines += '\n';
+		}
+		return defines;
+	}
+
+	void shader_preprocessor::add_include_directory(const std::string& aDirectory) {
+		std::string directory = aDirectory;
+		if(! directory.empty() && directory.back() != '/' && directory.back() != '\\') directory += '/';
+		std::lock_guard<std::mutex> lock(mLock);
+		mIncludeDirectories.push_back(directory);
+	}
+
+	void shader_preprocessor::add_virtual_file(const std::string& aName, const std::string& aSource) {
+		std::shared_ptr<const std::string> text(new std::string(canonicalise(aSource)));
+		std::lock_guard<std::mutex> lock(mLock);
+		mVirtualFiles[aName] = text;
+		// Expansions that included the previous version are now out of date
+		mBodies.clear();
+		mSources.clear();
+	}
+
+	std::shared_ptr<const std::string> shader_preprocessor::load_file(const std::string& aPath) {
+		auto i = mVirtualFiles.find(aPath);
+		if(i != mVirtualFiles.end()) return i->second;
+		i = mFiles.find(aPath);
+		if(i != mFiles.end()) return i->second;
+
+		std::ifstream file(aPath, std::ios::binary);
+		if(! file) throw std::runtime_error("asmith::gl::shader_preprocessor::load_file : Could not open '" + aPath + "'");
+		std::stringstream ss;
+		ss << file.rdbuf();
+		std::shared_ptr<const std::string> text(new std::string(canonicalise(ss.str())));
+		mFiles.emplace(aPath, text);
+		++mStatistics.files_loaded;
+		return text;
+	}
+
+	std::string shader_preprocessor::resolve_include(const std::string& aFrom, const std::string& aPath, bool aRelative) {
+		std::vector<std::string> candidates;
+		if(aRelative) {
+			// Quoted includes are looked for next to the including file first
+			const size_t slash = aFrom.find_last_of("/\\");
+			candidates.push_back(slash == std::string::npos ? aPath : aFrom.substr(0, slash + 1) + aPath);
+		}
+		for(const std::string& i : mIncludeDirectories) candidates.push_back(i + aPath);
+		// Virtual files are usually named without a directory
+		candidates.push_back(aPath);
+
+		for(const std::string& i : candidates) {
+			if(mVirtualFiles.find(i) != mVirtualFiles.end() || mFiles.find(i) != mFiles.end()) return i;
+			std::ifstream file(i, std::ios::binary);
+			if(file) return i;
+		}
+		throw std::runtime_error("asmith::gl::shader_preprocessor::preprocess : Could not find '" + aPath + "' included from '" + aFrom + "'");
+	}
+
+	void shader_preprocessor::expand(const std::string& aName, const std::string& aText, std::vector<std::string>& aStack, std::vector<std::string>& aOnce, expanded_body& aBody) {
+		const size_t index = aBody.files.size();
+		aBody.files.push_back(aName);
+		aStack.push_back(aName);
+
+		std::string argument;
+		size_t line = 1;
+		size_t begin = 0;
+		while(begin < aText.size()) {
+			size_t end = aText.find('\n', begin);
+			if(end == std::string::npos) end = aText.size();
+			const std::string l = aText.substr(begin, end - begin);
+
+			if(parse_directive(l, "include", argument)) {
+				const bool quoted = argument.size() > 2 && argument.front() == '"' && argument.back() == '"';
+				const bool angled = argument.size() > 2 && argument.front() == '<' && argument.back() == '>';
+				if(! (quoted || angled)) throw std::runtime_error("asmith::gl::shader_preprocessor::preprocess : Malformed #include in '" + aName + "' at line " + std::to_string(line));
+				const std::string path = resolve_include(aName, argument.substr(1, argument.size() - 2), quoted);
+				if(std::find(aOnce.begin(), aOnce.end(), path) != aOnce.end()) {
+					// Also stops a cycle between files that use #pragma once
+					aBody.text += '\n';
+				}else {
+					if(std::find(aStack.begin(), aStack.end(), path) != aStack.end()) throw std::runtime_error("asmith::gl::shader_preprocessor::preprocess : '" + path + "' includes itself");
+					aBody.text += "#line 1 " + std::to_string(aBody.files.size()) + '\n';
+					expand(path, *load_file(path), aStack, aOnce, aBody);
+					aBody.text += "#line " + std::to_string(line + 1) + ' ' + std::to_string(index) + '\n';
+				}
+			}else if(parse_directive(l, "pragma", argument) && argument == "once") {
+				aOnce.push_back(aName);
+				aBody.text += '\n';
+			}else if(parse_directive(l, "version", argument)) {
+				// #version must be the first line of the output, it is added back in front of the defines
+				if(index == 0 && aBody.version.empty()) aBody.version = l;
+				aBody.text += '\n';
+			}else {
+				aBody.text += l;
+				aBody.text += '\n';
+			}
+
+			++line;
+			begin = end + 1;
+		}
+
+		aStack.pop_back();
+	}
+
+	std::shared_ptr<const shader_preprocessor::expanded_source> shader_preprocessor::expand_source(const std::string& aName, const std::string& aSource, bool aCanonical, const define_set& aDefines) {
+		uint64_t key = implementation::hash_fnv1a(aName.c_str(), aName.size() + 1);
+		key = implementation::hash_fnv1a(aSource.c_str(), aSource.size(), key);
+
+		std::shared_ptr<const expanded_body> body;
+		const auto b = mBodies.find(key);
+		if(b == mBodies.end()) {
+			std::shared_ptr<expanded_body> tmp(new expanded_body());
+			std::vector<std::string> stack;
+			std::vector<std::string> once;
+			expand(aName, aCanonical ? aSource : canonicalise(aSource), stack, once, *tmp);
+			body = tmp;
+			mBodies.emplace(key, body);
+			++mStatistics.expansions;
+		}else {
+			body = b->second;
+		}
+
+		const std::string defines = get_define_string(aDefines);
+		key = implementation::hash_fnv1a(defines.c_str(), defines.size(), key);
+		const auto s = mSources.find(key);
+		if(s != mSources.end()) {
+			++mStatistics.cache_hits;
+			return s->second;
+		}
+
+		std::shared_ptr<expanded_source> tmp(new expanded_source());
+		tmp->source.reserve(body->version.size() + defines.size() + body->text.size() + 16);
+		if(! body->version.empty()) {
+			tmp->source += body->version;
+			tmp->source += '\n';
+		}
+		tmp->source += defines;
+		tmp->source += "#line 1 0\n";
+		tmp->source += body->text;
+		tmp->defines = defines;
+		tmp->files = body->files;
+		tmp->hash = implementation::hash_fnv1a(tmp->source.c_str(), tmp->source.size());
+		mSources.emplace(key, tmp);
+		++mStatistics.permutations;
+		return tmp;
+	}
+
+	std::shared_ptr<const shader_preprocessor::expanded_source> shader_preprocessor::preprocess(const std::string& aSource, const define_set& aDefines, const std::string& aName) {
+		std::lock_guard<std::mutex> lock(mLock);
+		return expand_source(aName, aSource, false, aDefines);
+	}
+
+	std::shared_ptr<const shader_preprocessor::expanded_source> shader_preprocessor::preprocess_file(const std::string& aPath, const define_set& aDefines) {
+		std::lock_guard<std::mutex> lock(mLock);
+		const std::shared_ptr<const std::string> text = load_file(aPath);
+		return expand_source(aPath, *text, true, aDefines);
+	}
+
+	void shader_preprocessor::clear_cache() {
+		std::lock_guard<std::mutex> lock(mLock);
+		mFiles.clear();
+		mBodies.clear();
+		mSources.clear();
+	}
+
+	shader_preprocessor::statistics shader_preprocessor::get_statistics() const {
+		std::lock_guard<std::mutex> lock(mLock);
+		return mStatistics;
+	}
+
+	void shader_preprocessor::reset_statistics() {
+		std::lock_guard<std::mutex> lock(mLock);
+		mStatistics = statistics{ 0, 0, 0, 0 };
+	}
+
+}}
\ No newline at end of file
@@ -0,0 +1,234 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+#include "asmith/open_gl/static_batcher.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace asmith { namespace gl {
+
+	static void transform_vertices(const obj::vertex* aIn, obj::vertex* aOut, size_t aCount, const mat4& aTransform) throw() {
+		// mat4 is column major, m[column][row]
+		GLfloat m[3][3];
+		for(size_t r = 0; r < 3; ++r) for(size_t c = 0; c < 3; ++c) m[r][c] = aTransform[c][r];
+
+		// Normals are transformed by the cofactor matrix, which is the inverse transpose scaled by the determinant
+		GLfloat n[3][3];
+		n[0][0] = m[1][1] * m[2][2] - m[1][2] * m[2][1];
+		n[0][1] = m[1][2] * m[2][0] - m[1][0] * m[2][2];
+		n[0][2] = m[1][0] * m[2][1] - m[1][1] * m[2][0];
+		n[1][0] = m[0][2] * m[2][1] - m[0][1] * m[2][2];
+		n[1][1] = m[0][0] * m[2][2] - m[0][2] * m[2][0];
+		n[1][2] = m[0][1] * m[2][0] - m[0][0] * m[2][1];
+		n[2][0] = m[0][1] * m[1][2] - m[0][2] * m[1][1];
+		n[2][1] = m[0][2] * m[1][0] - m[0][0] * m[1][2];
+		n[2][2] = m[0][0] * m[1][1] - m[0][1] * m[1][0];
+		const GLfloat determinant = m[0][0] * n[0][0] + m[0][1] * n[0][1] + m[0][2] * n[0][2];
+		const GLfloat sign = determinant < 0.f ? -1.f : 1.f;
+
+		for(size_t i = 0; i < aCount; ++i) {
+			const obj::vertex& in = aIn[i];
+			obj::vertex& out = aOut[i];
+			GLfloat normal[3];
+			for(size_t r = 0; r < 3; ++r) {
+				out.v[r] = m[r][0] * in.v[0] + m[r][1] * in.v[1] + m[r][2] * in.v[2] + aTransform[3][r];
+				normal[r] = n[r][0] * in.n[0] + n[r][1] * in.n[1] + n[r][2] * in.n[2];
+			}
+			const GLfloat length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+			const GLfloat scale = length > 0.f ? sign / length : 0.f;
+			for(size_t r = 0; r < 3; ++r) out.n[r] = normal[r] * scale;
+			out.t[0] = in.t[0];
+			out.t[1] = in.t[1];
+		}
+	}
+
+	// static_batcher
+
+	static_batcher::static_batcher(context& aContext, size_t aThreshold) :
+		mContext(aContext),
+		mThreshold(aThreshold),
+		mStatistics{ 0, 0, 0, 0, 0 }
+	{}
+
+	static_batcher::~static_batcher() {
+
+	}
+
+	size_t static_batcher::get_vertex_threshold() const throw() {
+		return mThreshold;
+	}
+
+	bool static_batcher::can_batch(const render_queue::packet& aMaterial, size_t aVertices) const throw() {
+		return aVertices > 0 && aVertices <= mThreshold && ! aMaterial.translucent && aMaterial.prog != nullptr && aMaterial.texture_count <= render_queue::MAX_TEXTURES;
+	}
+
+	size_t static_batcher::get_batch(const render_queue::packet& aMaterial) {
+		const uint64_t hash = render_queue::hash_material(aMaterial);
+		const auto range = mBatchIndex.equal_range(hash);
+		for(auto i = range.first; i != range.second; ++i) if(render_queue::same_material(mBatches[i->second].material, aMaterial)) return i->second;
+
+		batch b;
+		b.material = aMaterial;
+		b.vbo.reset(new vertex_buffer(mContext));
+		b.vbo->set_usage(GL_DYNAMIC_DRAW);
+		b.vao.reset(new vertex_array(mContext));
+		obj::add_attributes(*b.vao, b.vbo);
+		b.capacity = 0;
+		b.rebuild = false;
+
+		mBatches.push_back(b);
+		mBatchIndex.emplace(hash, mBatches.size() - 1);
+		return mBatches.size() - 1;
+	}
+
+	static_batcher::member& static_batcher::get_member(handle aHandle, const char* aFunction) {
+		if(aHandle >= mMembers.size() || ! mMembers[aHandle].vertices) throw std::runtime_error(std::string("asmith::gl::static_batcher::") + aFunction + " : Invalid handle");
+		return mMembers[aHandle];
+	}
+
+	static_batcher::handle static_batcher::add(const render_queue::packet& aMaterial, mesh aMesh, const mat4& aTransform) {
+		if(! aMesh) throw std::runtime_error("asmith::gl::static_batcher::add : Mesh is null");
+		if(! can_batch(aMaterial, aMesh->size())) throw std::runtime_error("asmith::gl::static_batcher::add : Mesh cannot be batched");
+
+		handle h;
+		if(mFreeMembers.empty()) {
+			if(mMembers.size() >= INVALID_HANDLE) throw std::runtime_error("asmith::gl::static_batcher::add : Too many meshes");
+			h = static_cast<handle>(mMembers.size());
+			mMembers.push_back(member());
+		}else {
+			h = mFreeMembers.back();
+			mFreeMembers.pop_back();
+		}
+
+		const size_t b = get_batch(aMaterial);
+		member& m = mMembers[h];
+		m.vertices = aMesh;
+		std::memcpy(&m.transform, &aTransform, sizeof(mat4));
+		m.batch = b;
+		m.offset = 0;
+		m.dirty = true;
+
+		mBatches[b].members.push_back(h);
+		mBatches[b].rebuild = true;
+		return h;
+	}
+
+	void static_batcher::remove(handle aHandle) {
+		member& m = get_member(aHandle, "remove");
+		batch& b = mBatches[m.batch];
+		b.members.erase(std::find(b.members.begin(), b.members.end(), aHandle));
+		b.rebuild = true;
+		m.vertices.reset();
+		mFreeMembers.push_back(aHandle);
+	}
+
+	void static_batcher::set_transform(handle aHandle, const mat4& aTransform) {
+		member& m = get_member(aHandle, "set_transform");
+		std::memcpy(&m.transform, &aTransform, sizeof(mat4));
+		m.dirty = true;
+	}
+
+	size_t static_batcher::size() const throw() {
+		return mMembers.size() - mFreeMembers.size();
+	}
+
+	void static_batcher::rebuild(batch& aBatch) {
+		size_t count = 0;
+		for(const handle h : aBatch.members) {
+			member& m = mMembers[h];
+			m.offset = count;
+			count += m.vertices->size();
+		}
+
+		aBatch.vertices.resize(count);
+		for(const handle h : aBatch.members) {
+			member& m = mMembers[h];
+			transform_vertices(m.vertices->data(), aBatch.vertices.data() + m.offset, m.vertices->size(), m.transform);
+			m.dirty = false;
+		}
+
+		if(count > aBatch.capacity) {
+			// Grow geometrically so that adding meshes one at a time does not reallocate every frame
+			aBatch.capacity = std::max(count, aBatch.capacity * 2);
+			aBatch.vbo->buffer(nullptr, aBatch.capacity * sizeof(obj::vertex));
+		}
+		if(count > 0) aBatch.vbo->sub_buffer(0, aBatch.vertices.data(), count * sizeof(obj::vertex));
+
+		aBatch.rebuild = false;
+		++mStatistics.rebuilds;
+		mStatistics.vertices_transformed += count;
+		mStatistics.bytes_uploaded += count * sizeof(obj::vertex);
+	}
+
+	void static_batcher::update(batch& aBatch) {
+		// Members are stored in the order of their vertices, neighbouring meshes that moved are uploaded together
+		size_t begin = 0;
+		size_t end = 0;
+		for(const handle h : aBatch.members) {
+			member& m = mMembers[h];
+			if(! m.dirty) continue;
+			const size_t count = m.vertices->size();
+			transform_vertices(m.vertices->data(), aBatch.vertices.data() + m.offset, count, m.transform);
+			m.dirty = false;
+			mStatistics.vertices_transformed += count;
+
+			if(m.offset != end) {
+				if(end > begin) {
+					aBatch.vbo->sub_buffer(begin * sizeof(obj::vertex), aBatch.vertices.data() + begin, (end - begin) * sizeof(obj::vertex));
+					mStatistics.bytes_uploaded += (end - begin) * sizeof(obj::vertex);
+				}
+				begin = m.offset;
+			}
+			end = m.offset + count;
+		}
+		if(end > begin) {
+			aBatch.vbo->sub_buffer(begin * sizeof(obj::vertex), aBatch.vertices.data() + begin, (end - begin) * sizeof(obj::vertex));
+			mStatistics.bytes_uploaded += (end - begin) * sizeof(obj::vertex);
+			++mStatistics.updates;
+		}
+	}
+
+	void static_batcher::update() {
+		for(batch& i : mBatches) {
+			if(i.rebuild) rebuild(i);
+			else update(i);
+		}
+	}
+
+	void static_batcher::submit(render_queue& aQueue) {
+		update();
+		for(batch& i : mBatches) {
+			if(i.members.empty()) continue;
+			render_queue::packet p = i.material;
+			p.vao = i.vao.get();
+			p.first = 0;
+			p.count = static_cast<GLsizei>(i.vertices.size());
+			p.depth = 0.f;
+			p.instance_count = 0;
+			p.base_instance = 0;
+			aQueue.submit(p);
+			mStatistics.draws_saved += i.members.size() - 1;
+		}
+	}
+
+	static_batcher::statistics static_batcher::get_statistics() const throw() {
+		return mStatistics;
+	}
+
+	void static_batcher::reset_statistics() throw() {
+		mStatistics = statistics{ 0, 0, 0, 0, 0 };
+	}
+
+}}
\ No newline at end of file
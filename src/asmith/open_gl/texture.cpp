@@ -0,0 +1,235 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+#include "asmith/open_gl/texture.hpp"
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include "asmith/open_gl/texture_units.hpp"
+
+namespace asmith { namespace gl {
+	// texture
+
+	texture::texture(context& aContext) :
+		object(aContext),
+		mTarget(GL_INVALID_ENUM),
+		mWrap(GL_CLAMP_TO_BORDER),
+		mFilter(GL_LINEAR),
+		mUnit(-1),
+		mBindCount(0),
+		mHandle(0),
+		mResidentCount(0),
+		mDirtyParameters(DIRTY_ALL),
+		mMipmaps(false)
+	{
+		mBorderColour[0] = 0.f;
+		mBorderColour[1] = 0.f;
+		mBorderColour[2] = 0.f;
+		mBorderColour[3] = 1.f;
+		glGenTextures(1, &mID);
+		if(mID == 0) throw std::runtime_error("asmith::gl::texture::texture : glGenTextures returned 0");
+	}
+
+	bool texture::is_bindless_supported() throw() {
+#ifdef GL_ARB_bindless_texture
+		return GLEW_ARB_bindless_texture ? true : false;
+#else
+		return false;
+#endif
+	}
+
+	texture::~texture() {
+		if(mID == 0) return;
+#ifdef GL_ARB_bindless_texture
+		if(mResidentCount > 0) glMakeTextureHandleNonResidentARB(mHandle);
+#endif
+		glDeleteTextures(1, &mID);
+		mID = 0;
+	}
+
+	const vec4f& texture::get_border_colour() const throw() {
+		return mBorderColour;
+	}
+
+	GLenum texture::get_filter() const throw() {
+		return mFilter;
+	}
+
+	GLenum texture::get_wrap() const throw() {
+		return mWrap;
+	}
+
+	bool texture::has_mipmaps() const throw() {
+		return mMipmaps;
+	}
+
+	void texture::make_current() const throw() {
+		texture_units::activate(mContext, static_cast<GLuint>(mUnit));
+	}
+
+	void texture::flush_parameters() throw() {
+		// A texture that is not bound but still resident in its unit can be flushed too
+		if(mDirtyParameters == 0 || mUnit == -1) return;
+		make_current();
+		if(mDirtyParameters & DIRTY_WRAP) {
+			glTexParameteri(mTarget, GL_TEXTURE_WRAP_S, mWrap);
+			glTexParameteri(mTarget, GL_TEXTURE_WRAP_T, mWrap);
+			if(get_dimensions() >= 3) glTexParameteri(mTarget, GL_TEXTURE_WRAP_R, mWrap);
+		}
+		if(mDirtyParameters & DIRTY_FILTER) {
+			glTexParameteri(mTarget, GL_TEXTURE_MIN_FILTER, mFilter);
+			glTexParameteri(mTarget, GL_TEXTURE_MAG_FILTER, mFilter);
+		}
+		if(mDirtyParameters & DIRTY_BORDER) {
+			glTexParameterfv(mTarget, GL_TEXTURE_BORDER_COLOR, &mBorderColour[0]);
+		}
+		mDirtyParameters = 0;
+	}
+
+	void texture::check_parameters_mutable(const char* aFunction) const {
+		if(mHandle != 0) throw std::runtime_error(std::string("asmith::gl::texture::") + aFunction + " : Texture parameters cannot be changed after a bindless handle has been created");
+	}
+
+	void texture::set_border_colour(const vec4f& aValue) {
+		check_parameters_mutable("set_border_colour");
+		if(memcmp(&mBorderColour[0], &aValue[0], 4 * sizeof(GLfloat)) == 0 && (mDirtyParameters & DIRTY_BORDER) == 0) return;
+		memcpy(&mBorderColour[0], &aValue[0], 4 * sizeof(GLfloat));
+		mDirtyParameters |= DIRTY_BORDER;
+		flush_parameters();
+	}
+
+	void texture::set_filter(GLenum aValue) {
+		check_parameters_mutable("set_filter");
+		if(mFilter == aValue && (mDirtyParameters & DIRTY_FILTER) == 0) return;
+		mFilter = aValue;
+		mDirtyParameters |= DIRTY_FILTER;
+		flush_parameters();
+	}
+
+	void texture::set_wrap(GLenum aValue) {
+		check_parameters_mutable("set_wrap");
+		if(mWrap == aValue && (mDirtyParameters & DIRTY_WRAP) == 0) return;
+		mWrap = aValue;
+		mDirtyParameters |= DIRTY_WRAP;
+		flush_parameters();
+	}
+
+	void texture::generate_mipmaps() {
+		if(mBindCount == 0) throw std::runtime_error("asmith::gl::texture::generate_mipmaps : Texture is not bound");
+		make_current();
+		glGenerateMipmap(mTarget);
+		mMipmaps = true;
+	}
+
+	GLuint texture::bind() {
+		return bind(mBindCount > 0 ? mTarget : get_default_target());
+	}
+
+	GLuint texture::bind(GLenum aTarget) {
+		if(mBindCount > 0) {
+			if(aTarget != mTarget) throw std::runtime_error("asmith::gl::texture::bind : Texture is already bound to a different target");
+			make_current();
+		}else {
+			texture_units::bind(mContext, *this, aTarget);
+		}
+		++mBindCount;
+		flush_parameters();
+		return static_cast<GLuint>(mUnit);
+	}
+
+	void texture::unbind() {
+		if(mBindCount == 0) throw std::runtime_error("asmith::gl::texture::unbind : Texture is not bound");
+		// The texture stays resident in its unit until texture_units needs the unit for another texture
+		--mBindCount;
+	}
+
+	bool texture::is_bound() const throw() {
+		return mBindCount > 0;
+	}
+
+	bool texture::is_bound(GLenum aTarget) const throw() {
+		return mBindCount > 0 && mTarget == aTarget;
+	}
+
+	GLint texture::get_unit() const throw() {
+		return mUnit;
+	}
+
+	GLuint64 texture::get_handle() {
+		if(mHandle != 0) return mHandle;
+		if(! is_bindless_supported()) throw std::runtime_error("asmith::gl::texture::get_handle : ARB_bindless_texture is not supported");
+#ifdef GL_ARB_bindless_texture
+		// The handle captures the current parameters, so push any that are still pending
+		if(mDirtyParameters != 0 && mBindCount == 0) {
+			bind();
+			unbind();
+		}
+		mHandle = glGetTextureHandleARB(mID);
+		if(mHandle == 0) throw std::runtime_error("asmith::gl::texture::get_handle : glGetTextureHandleARB returned 0");
+#endif
+		return mHandle;
+	}
+
+	bool texture::has_handle() const throw() {
+		return mHandle != 0;
+	}
+
+	void texture::make_resident() {
+		const GLuint64 handle = get_handle();
+#ifdef GL_ARB_bindless_texture
+		if(mResidentCount == 0) glMakeTextureHandleResidentARB(handle);
+#endif
+		++mResidentCount;
+	}
+
+	void texture::make_non_resident() {
+		if(mResidentCount == 0) throw std::runtime_error("asmith::gl::texture::make_non_resident : Texture is not resident");
+		--mResidentCount;
+#ifdef GL_ARB_bindless_texture
+		if(mResidentCount == 0) glMakeTextureHandleNonResidentARB(mHandle);
+#endif
+	}
+
+	bool texture::is_resident() const throw() {
+		return mResidentCount > 0;
+	}
+
+	bool texture::is_image_load_store_supported() throw() {
+#ifdef GL_ARB_shader_image_load_store
+		return GLEW_VERSION_4_2 || GLEW_ARB_shader_image_load_store ? true : false;
+#else
+		return false;
+#endif
+	}
+
+	void texture::unbind_image(GLuint aUnit) {
+		if(! is_image_load_store_supported()) throw std::runtime_error("asmith::gl::texture::unbind_image : ARB_shader_image_load_store is not supported");
+#ifdef GL_ARB_shader_image_load_store
+		glBindImageTexture(aUnit, 0, 0, GL_FALSE, 0, GL_READ_ONLY, GL_R8);
+#endif
+	}
+
+	void texture::bind_image(GLuint aUnit, GLenum aAccess, GLenum aFormat, GLint aLevel, GLboolean aLayered, GLint aLayer) {
+		if(! is_image_load_store_supported()) throw std::runtime_error("asmith::gl::texture::bind_image : ARB_shader_image_load_store is not supported");
+		if(aAccess != GL_READ_ONLY && aAccess != GL_WRITE_ONLY && aAccess != GL_READ_WRITE) throw std::runtime_error("asmith::gl::texture::bind_image : Invalid access");
+#ifdef GL_ARB_shader_image_load_store
+		// Image units do not use the sampler parameters, but the texture must be complete
+		if(mDirtyParameters != 0 && mBindCount == 0) {
+			bind();
+			unbind();
+		}
+		glBindImageTexture(aUnit, mID, aLevel, aLayered, aLayer, aAccess, aFormat);
+#endif
+	}
+
+}}
\ No newline at end of file
@@ -12,28 +12,200 @@
 //	limitations under the License.
 
 #include "asmith/open_gl/texture_2d.hpp"
+#include <algorithm>
 #include <stdexcept>
 
 namespace asmith { namespace gl {
+
+	static size_t get_pixel_size(const GLenum aFormat, const GLenum aType) throw() {
+		switch(aType) {
+		case GL_UNSIGNED_BYTE_3_3_2:
+		case GL_UNSIGNED_BYTE_2_3_3_REV:
+			return 1;
+		case GL_UNSIGNED_SHORT_5_6_5:
+		case GL_UNSIGNED_SHORT_5_6_5_REV:
+		case GL_UNSIGNED_SHORT_4_4_4_4:
+		case GL_UNSIGNED_SHORT_4_4_4_4_REV:
+		case GL_UNSIGNED_SHORT_5_5_5_1:
+		case GL_UNSIGNED_SHORT_1_5_5_5_REV:
+			return 2;
+		case GL_UNSIGNED_INT_8_8_8_8:
+		case GL_UNSIGNED_INT_8_8_8_8_REV:
+		case GL_UNSIGNED_INT_10_10_10_2:
+		case GL_UNSIGNED_INT_2_10_10_10_REV:
+		case GL_UNSIGNED_INT_10F_11F_11F_REV:
+		case GL_UNSIGNED_INT_5_9_9_9_REV:
+			return 4;
+		default:
+			break;
+		}
+
+		size_t components;
+		switch(aFormat) {
+		case GL_RED:
+		case GL_GREEN:
+		case GL_BLUE:
+		case GL_ALPHA:
+		case GL_DEPTH_COMPONENT:
+			components = 1;
+			break;
+		case GL_RG:
+			components = 2;
+			break;
+		case GL_RGB:
+		case GL_BGR:
+			components = 3;
+			break;
+		default:
+			components = 4;
+			break;
+		}
+
+		switch(aType) {
+		case GL_UNSIGNED_BYTE:
+		case GL_BYTE:
+			return components;
+		case GL_UNSIGNED_SHORT:
+		case GL_SHORT:
+		case GL_HALF_FLOAT:
+			return components * 2;
+		default:
+			return components * 4;
+		}
+	}
+
+	// Bytes per texel that a driver stores for a sized internal format, 0 for unsized and compressed formats.
+	// Three component formats of 8 and 16 bits are counted as four because drivers pad them to keep texels aligned.
+	static size_t get_internal_format_size(const GLint aInternalFormat) throw() {
+		switch(aInternalFormat) {
+		case GL_R8:
+		case GL_R8_SNORM:
+		case GL_R8UI:
+		case GL_R8I:
+		case GL_R3_G3_B2:
+		case GL_STENCIL_INDEX8:
+			return 1;
+		case GL_R16:
+		case GL_R16_SNORM:
+		case GL_R16F:
+		case GL_R16UI:
+		case GL_R16I:
+		case GL_RG8:
+		case GL_RG8_SNORM:
+		case GL_RG8UI:
+		case GL_RG8I:
+		case GL_RGB565:
+		case GL_RGB5_A1:
+		case GL_RGBA4:
+		case GL_DEPTH_COMPONENT16:
+			return 2;
+		case GL_R32F:
+		case GL_R32UI:
+		case GL_R32I:
+		case GL_RG16:
+		case GL_RG16_SNORM:
+		case GL_RG16F:
+		case GL_RG16UI:
+		case GL_RG16I:
+		case GL_RGB8:
+		case GL_RGB8_SNORM:
+		case GL_RGB8UI:
+		case GL_RGB8I:
+		case GL_SRGB8:
+		case GL_RGBA8:
+		case GL_RGBA8_SNORM:
+		case GL_RGBA8UI:
+		case GL_RGBA8I:
+		case GL_SRGB8_ALPHA8:
+		case GL_RGB10_A2:
+		case GL_RGB10_A2UI:
+		case GL_R11F_G11F_B10F:
+		case GL_RGB9_E5:
+		case GL_DEPTH_COMPONENT24:
+		case GL_DEPTH_COMPONENT32:
+		case GL_DEPTH_COMPONENT32F:
+		case GL_DEPTH24_STENCIL8:
+			return 4;
+		case GL_RG32F:
+		case GL_RG32UI:
+		case GL_RG32I:
+		case GL_RGB16:
+		case GL_RGB16_SNORM:
+		case GL_RGB16F:
+		case GL_RGB16UI:
+		case GL_RGB16I:
+		case GL_RGBA16:
+		case GL_RGBA16_SNORM:
+		case GL_RGBA16F:
+		case GL_RGBA16UI:
+		case GL_RGBA16I:
+		case GL_DEPTH32F_STENCIL8:
+			return 8;
+		case GL_RGB32F:
+		case GL_RGB32UI:
+		case GL_RGB32I:
+			return 12;
+		case GL_RGBA32F:
+		case GL_RGBA32UI:
+		case GL_RGBA32I:
+			return 16;
+		default:
+			return 0;
+		}
+	}
+
+	// Bytes per 4x4 block of a compressed internal format with a fixed block size, 0 for other formats.
+	// The generic formats such as GL_COMPRESSED_RGBA leave the choice to the driver, so they are not listed.
+	static size_t get_compressed_block_size(const GLint aInternalFormat) throw() {
+		switch(aInternalFormat) {
+		case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+		case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+		case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+		case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+		case GL_COMPRESSED_RED_RGTC1:
+		case GL_COMPRESSED_SIGNED_RED_RGTC1:
+		case GL_COMPRESSED_RGB8_ETC2:
+		case GL_COMPRESSED_SRGB8_ETC2:
+		case GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+		case GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+		case GL_COMPRESSED_R11_EAC:
+		case GL_COMPRESSED_SIGNED_R11_EAC:
+			return 8;
+		case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+		case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+		case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT:
+		case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+		case GL_COMPRESSED_RG_RGTC2:
+		case GL_COMPRESSED_SIGNED_RG_RGTC2:
+		case GL_COMPRESSED_RGBA_BPTC_UNORM:
+		case GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM:
+		case GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT:
+		case GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT:
+		case GL_COMPRESSED_RGBA8_ETC2_EAC:
+		case GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC:
+		case GL_COMPRESSED_RG11_EAC:
+		case GL_COMPRESSED_SIGNED_RG11_EAC:
+			return 16;
+		default:
+			return 0;
+		}
+	}
+
 	//texture_2d
 
-	texture_2d::texture_2d(context& aContext) throw() :
-		object(aContext),
-		mBorderColour(0.f, 0.f, 0.f, 1.f),
-		mTarget(GL_INVALID_ENUM),
+	texture_2d::texture_2d(context& aContext) :
+		texture(aContext),
 		mWidth(0),
 		mHeight(0),
-		mWrap(GL_CLAMP_TO_BORDER),
-		mFilter(GL_LINEAR)
-	{
-		glGenTextures(1, &mID);
-		if(mID == 0) throw std::runtime_error("asmith::gl::texture_2d::texture_2d : glGenTextures returned 0");
-	}
+		mInternalFormat(GL_RGBA),
+		mFormat(GL_RGBA),
+		mType(GL_UNSIGNED_BYTE),
+		mLoadedLevels(0),
+		mBaseSizeKnown(false)
+	{}
+
+	texture_2d::~texture_2d() {
 
-	texture_2d::~texture_2d() throw() {
-		if(mID == 0) return;
-		glDeleteTextures(1, &mID);
-		mID = 0;
 	}
 
 	GLsizei texture_2d::get_width() const throw() {
@@ -44,66 +216,126 @@ namespace asmith { namespace gl {
 		return mHeight;
 	}
 
-	const vec4f& texture_2d::get_border_colour() const throw() {
-		return mBorderColour;
+	GLint texture_2d::get_internal_format() const throw() {
+		return mInternalFormat;
 	}
 
-	GLenum texture_2d::get_filter() const throw() {
-		return mFilter;
+	GLenum texture_2d::get_format() const throw() {
+		return mFormat;
 	}
 
-	GLenum texture_2d::get_wrap() const throw() {
-		return mWrap;
+	GLenum texture_2d::get_type() const throw() {
+		return mType;
 	}
 
-	void texture_2d::set_border_colour(const vec4f& aValue) throw() {
-		if(mTarget == GL_INVALID_ENUM) throw std::runtime_error("asmith::gl::texture_2d::set_border_colour : Texture is not bound");
-		memcpy(&mBorderColour[0], &aValue[0], 4 * sizeof(GLfloat));
-		glTexParameterfv(mTarget, GL_TEXTURE_BORDER_COLOR, &mBorderColour[0]);
+	GLint texture_2d::get_level_count() const throw() {
+		GLsizei size = mWidth > mHeight ? mWidth : mHeight;
+		GLint count = 0;
+		while(size > 0) {
+			++count;
+			size >>= 1;
+		}
+		return count;
 	}
 
-	void texture_2d::set_filter(GLenum aValue) throw() {
-		if(mTarget == GL_INVALID_ENUM) throw std::runtime_error("asmith::gl::texture_2d::set_filter : Texture is not bound");
-		mFilter = aValue;
-		glTexParameteri(mTarget, GL_TEXTURE_MIN_FILTER, mFilter);
-		glTexParameteri(mTarget, GL_TEXTURE_MAG_FILTER, mFilter);
+	bool texture_2d::is_level_loaded(GLint aLevel) const throw() {
+		if(aLevel < 0 || aLevel >= 32) return false;
+		if(mLoadedLevels & (1u << aLevel)) return true;
+		// glGenerateMipmap fills every level below the lowest level that was loaded
+		return mMipmaps && aLevel < get_level_count() && (mLoadedLevels & ((1u << aLevel) - 1u)) != 0;
 	}
 
-	void texture_2d::set_wrap(GLenum aValue) throw() {
-		if(mTarget == GL_INVALID_ENUM) throw std::runtime_error("asmith::gl::texture_2d::set_wrap : Texture is not bound");
-		mWrap = aValue;
-		glTexParameteri(mTarget, GL_TEXTURE_WRAP_S, mWrap);
-		glTexParameteri(mTarget, GL_TEXTURE_WRAP_T, mWrap);
+	size_t texture_2d::get_level_memory_usage(GLint aLevel) const throw() {
+		if(aLevel < 0 || aLevel >= 32) return 0;
+		const size_t w = static_cast<size_t>(std::max<GLsizei>(1, mWidth >> aLevel));
+		const size_t h = static_cast<size_t>(std::max<GLsizei>(1, mHeight >> aLevel));
+		const size_t block = get_compressed_block_size(mInternalFormat);
+		if(block != 0) return ((w + 3) / 4) * ((h + 3) / 4) * block;
+		const size_t texel = get_internal_format_size(mInternalFormat);
+		// Unsized formats are stored in whatever the driver chooses, the upload format is the best guess of it
+		return w * h * (texel != 0 ? texel : get_pixel_size(mFormat, mType));
 	}
 
-	void texture_2d::generate_mipmaps() throw() {
-		if(mTarget == GL_INVALID_ENUM) throw std::runtime_error("asmith::gl::texture_2d::generate_mipmaps : Texture is not bound");
-		glGenerateMipmap(mTarget);
+	size_t texture_2d::get_memory_usage() const throw() {
+		const GLint count = get_level_count();
+		size_t bytes = 0;
+		for(GLint i = 0; i < count; ++i) if(is_level_loaded(i)) bytes += get_level_memory_usage(i);
+		return bytes;
 	}
 
-	void texture_2d::bind(GLenum aTarget) {
-		if(mTarget != GL_INVALID_ENUM) throw std::runtime_error("asmith::gl::texture_2d::bind : Texture is already bound");
-		//! \todo Implement binding stack
-		mTarget = aTarget;
-		glBindTexture(mTarget, mID);
+	GLenum texture_2d::get_default_target() const throw() {
+		return GL_TEXTURE_2D;
 	}
 
-	void texture_2d::unbind() {
-		if(mTarget == GL_INVALID_ENUM) throw std::runtime_error("asmith::gl::texture_2d::unbind : Texture is not bound");
-		//! \todo Implement binding stack
-		glBindTexture(mTarget, 0);
-		mTarget = GL_INVALID_ENUM;
+	GLuint texture_2d::get_dimensions() const throw() {
+		return 2;
 	}
 
-	bool texture_2d::is_bound(GLenum aTarget) const throw() {
-		return mTarget == aTarget;
-	}
-
-	void texture_2d::load_raw(GLint aLevel, GLint aInternalFormat, GLsizei aWidth, GLsizei aHeight, GLenum aFormat, GLenum aType, const GLvoid* aValue) throw() {
-		if(mTarget == GL_INVALID_ENUM) throw std::runtime_error("asmith::gl::texture_2d::load_raw : Texture is not bound");
+	void texture_2d::set_base_size(GLsizei aWidth, GLsizei aHeight) {
+		if(aWidth <= 0 || aHeight <= 0) throw std::runtime_error("asmith::gl::texture_2d::set_base_size : Invalid texture size");
 		mWidth = aWidth;
 		mHeight = aHeight;
+		mBaseSizeKnown = true;
+	}
+
+	void texture_2d::load_raw(GLint aLevel, GLint aInternalFormat, GLsizei aWidth, GLsizei aHeight, GLenum aFormat, GLenum aType, const GLvoid* aValue) {
+		if(! is_bound()) throw std::runtime_error("asmith::gl::texture_2d::load_raw : Texture is not bound");
+		if(aLevel < 0 || aLevel >= 32) throw std::runtime_error("asmith::gl::texture_2d::load_raw : Invalid mip level");
+		make_current();
+		if(aLevel == 0) {
+			mWidth = aWidth;
+			mHeight = aHeight;
+			mBaseSizeKnown = true;
+		}else if(! mBaseSizeKnown) {
+			// Halving rounds down, so this is only exact for powers of two, see set_base_size
+			mWidth = aWidth << aLevel;
+			mHeight = aHeight << aLevel;
+		}
+		mInternalFormat = aInternalFormat;
+		mFormat = aFormat;
+		mType = aType;
+		mLoadedLevels |= 1u << aLevel;
 		glTexImage2D(mTarget, aLevel, aInternalFormat, aWidth, aHeight, 0, aFormat, aType, aValue);
 	}
 
+	void texture_2d::load_raw(GLint aLevel, GLint aInternalFormat, GLsizei aWidth, GLsizei aHeight, GLenum aFormat, GLenum aType, const GLvoid* aValue, GLint aRowLength) {
+		if(! is_bound()) throw std::runtime_error("asmith::gl::texture_2d::load_raw : Texture is not bound");
+		if(aRowLength < aWidth) throw std::runtime_error("asmith::gl::texture_2d::load_raw : Row length is less than the width");
+		make_current();
+
+		// Rows of a view are not padded to 4 bytes, so the alignment is also changed
+		GLint rowLength = 0;
+		GLint alignment = 4;
+		glGetIntegerv(GL_UNPACK_ROW_LENGTH, &rowLength);
+		glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, aRowLength == aWidth ? 0 : aRowLength);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		try {
+			load_raw(aLevel, aInternalFormat, aWidth, aHeight, aFormat, aType, aValue);
+		}catch(...) {
+			glPixelStorei(GL_UNPACK_ROW_LENGTH, rowLength);
+			glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+			throw;
+		}
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, rowLength);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+	}
+
+	void texture_2d::unload_level(GLint aLevel) {
+		if(! is_bound()) throw std::runtime_error("asmith::gl::texture_2d::unload_level : Texture is not bound");
+		if(aLevel < 0 || aLevel >= 32) throw std::runtime_error("asmith::gl::texture_2d::unload_level : Invalid mip level");
+		make_current();
+		// Respecifying a level as 0x0 releases its storage, set_level_range should exclude it from sampling
+		glTexImage2D(mTarget, aLevel, mInternalFormat, 0, 0, 0, mFormat, mType, nullptr);
+		mLoadedLevels &= ~(1u << aLevel);
+	}
+
+	void texture_2d::set_level_range(GLint aBase, GLint aMax) {
+		if(! is_bound()) throw std::runtime_error("asmith::gl::texture_2d::set_level_range : Texture is not bound");
+		check_parameters_mutable("set_level_range");
+		make_current();
+		glTexParameteri(mTarget, GL_TEXTURE_BASE_LEVEL, aBase);
+		glTexParameteri(mTarget, GL_TEXTURE_MAX_LEVEL, aMax);
+	}
+
 }}
\ No newline at end of file
@@ -0,0 +1,76 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+#include "asmith/open_gl/texture_2d_array.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+#if ASMITH_GL_VERSION_GE(3,0)
+namespace asmith { namespace gl {
+	//texture_2d_array
+
+	texture_2d_array::texture_2d_array(context& aContext) :
+		texture(aContext),
+		mWidth(0),
+		mHeight(0),
+		mLayers(0)
+	{}
+
+	texture_2d_array::~texture_2d_array() {
+
+	}
+
+	GLsizei texture_2d_array::get_width() const throw() {
+		return mWidth;
+	}
+
+	GLsizei texture_2d_array::get_height() const throw() {
+		return mHeight;
+	}
+
+	GLsizei texture_2d_array::get_layers() const throw() {
+		return mLayers;
+	}
+
+	GLenum texture_2d_array::get_default_target() const throw() {
+		return GL_TEXTURE_2D_ARRAY;
+	}
+
+	GLuint texture_2d_array::get_dimensions() const throw() {
+		return 2;
+	}
+
+	void texture_2d_array::load_raw(GLint aLevel, GLint aInternalFormat, GLsizei aWidth, GLsizei aHeight, GLsizei aLayers, GLenum aFormat, GLenum aType, const GLvoid* aValue) {
+		if(! is_bound()) throw std::runtime_error("asmith::gl::texture_2d_array::load_raw : Texture is not bound");
+		if(aLevel < 0 || aLevel >= 32) throw std::runtime_error("asmith::gl::texture_2d_array::load_raw : Invalid mip level");
+		make_current();
+		if(aLevel == 0) {
+			mWidth = aWidth;
+			mHeight = aHeight;
+			mLayers = aLayers;
+		}
+		glTexImage3D(mTarget, aLevel, aInternalFormat, aWidth, aHeight, aLayers, 0, aFormat, aType, aValue);
+	}
+
+	void texture_2d_array::load_layer_raw(GLint aLevel, GLsizei aLayer, GLenum aFormat, GLenum aType, const GLvoid* aValue) {
+		if(! is_bound()) throw std::runtime_error("asmith::gl::texture_2d_array::load_layer_raw : Texture is not bound");
+		if(aLevel < 0 || aLevel >= 32) throw std::runtime_error("asmith::gl::texture_2d_array::load_layer_raw : Invalid mip level");
+		make_current();
+		if(aLayer < 0 || aLayer >= mLayers) throw std::runtime_error("asmith::gl::texture_2d_array::load_layer_raw : Layer index out of bounds");
+		const GLsizei w = std::max<GLsizei>(1, mWidth >> aLevel);
+		const GLsizei h = std::max<GLsizei>(1, mHeight >> aLevel);
+		glTexSubImage3D(mTarget, aLevel, 0, 0, aLayer, w, h, 1, aFormat, aType, aValue);
+	}
+
+}}
+#endif
\ No newline at end of file
@@ -0,0 +1,75 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+#include "asmith/open_gl/texture_3d.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace asmith { namespace gl {
+	//texture_3d
+
+	texture_3d::texture_3d(context& aContext) :
+		texture(aContext),
+		mWidth(0),
+		mHeight(0),
+		mDepth(0)
+	{}
+
+	texture_3d::~texture_3d() {
+
+	}
+
+	GLsizei texture_3d::get_width() const throw() {
+		return mWidth;
+	}
+
+	GLsizei texture_3d::get_height() const throw() {
+		return mHeight;
+	}
+
+	GLsizei texture_3d::get_depth() const throw() {
+		return mDepth;
+	}
+
+	GLenum texture_3d::get_default_target() const throw() {
+		return GL_TEXTURE_3D;
+	}
+
+	GLuint texture_3d::get_dimensions() const throw() {
+		return 3;
+	}
+
+	void texture_3d::load_raw(GLint aLevel, GLint aInternalFormat, GLsizei aWidth, GLsizei aHeight, GLsizei aDepth, GLenum aFormat, GLenum aType, const GLvoid* aValue) {
+		if(! is_bound()) throw std::runtime_error("asmith::gl::texture_3d::load_raw : Texture is not bound");
+		if(aLevel < 0 || aLevel >= 32) throw std::runtime_error("asmith::gl::texture_3d::load_raw : Invalid mip level");
+		make_current();
+		if(aLevel == 0) {
+			mWidth = aWidth;
+			mHeight = aHeight;
+			mDepth = aDepth;
+		}
+		glTexImage3D(mTarget, aLevel, aInternalFormat, aWidth, aHeight, aDepth, 0, aFormat, aType, aValue);
+	}
+
+	void texture_3d::load_slice_raw(GLint aLevel, GLsizei aSlice, GLenum aFormat, GLenum aType, const GLvoid* aValue) {
+		if(! is_bound()) throw std::runtime_error("asmith::gl::texture_3d::load_slice_raw : Texture is not bound");
+		if(aLevel < 0 || aLevel >= 32) throw std::runtime_error("asmith::gl::texture_3d::load_slice_raw : Invalid mip level");
+		make_current();
+		const GLsizei d = std::max<GLsizei>(1, mDepth >> aLevel);
+		if(aSlice < 0 || aSlice >= d) throw std::runtime_error("asmith::gl::texture_3d::load_slice_raw : Slice index out of bounds");
+		const GLsizei w = std::max<GLsizei>(1, mWidth >> aLevel);
+		const GLsizei h = std::max<GLsizei>(1, mHeight >> aLevel);
+		glTexSubImage3D(mTarget, aLevel, 0, 0, aSlice, w, h, 1, aFormat, aType, aValue);
+	}
+
+}}
\ No newline at end of file
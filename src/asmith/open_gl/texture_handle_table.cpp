@@ -0,0 +1,149 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+#include "asmith/open_gl/texture_handle_table.hpp"
+#include <stdexcept>
+
+namespace asmith { namespace gl {
+
+	// texture_handle_table
+
+	texture_handle_table::texture_handle_table(context& aContext) :
+		texture_handle_table(aContext, texture::is_bindless_supported())
+	{}
+
+	texture_handle_table::texture_handle_table(context& aContext, bool aBindless) :
+		mContext(aContext),
+		mDirtyBegin(0),
+		mDirtyEnd(0),
+#if ASMITH_GL_VERSION_GE(4,3)
+		mBindless(aBindless)
+#else
+		mBindless(false)
+#endif
+	{
+#if ! ASMITH_GL_VERSION_GE(4,3)
+		if(aBindless) throw std::runtime_error("asmith::gl::texture_handle_table::texture_handle_table : Bindless tables require OpenGL 4.3");
+#endif
+		if(mBindless) {
+			if(! texture::is_bindless_supported()) throw std::runtime_error("asmith::gl::texture_handle_table::texture_handle_table : ARB_bindless_texture is not supported");
+			mBuffer.reset(new vertex_buffer(aContext));
+			mBuffer->set_usage(GL_DYNAMIC_DRAW);
+		}
+	}
+
+	texture_handle_table::~texture_handle_table() {
+		if(! mBindless) return;
+		for(const std::shared_ptr<texture>& i : mTextures) if(i) i->make_non_resident();
+	}
+
+	void texture_handle_table::mark_dirty(size_t aIndex) throw() {
+		if(mDirtyBegin == mDirtyEnd) {
+			mDirtyBegin = aIndex;
+			mDirtyEnd = aIndex + 1;
+		}else {
+			if(aIndex < mDirtyBegin) mDirtyBegin = aIndex;
+			if(aIndex >= mDirtyEnd) mDirtyEnd = aIndex + 1;
+		}
+	}
+
+	GLuint texture_handle_table::add(std::shared_ptr<texture> aTexture) {
+		GLuint index;
+		if(mFreeIndices.empty()) {
+			index = static_cast<GLuint>(mTextures.size());
+			mTextures.push_back(std::shared_ptr<texture>());
+			mHandles.push_back(0);
+		}else {
+			index = mFreeIndices.back();
+			mFreeIndices.pop_back();
+		}
+		set(index, aTexture);
+		return index;
+	}
+
+	void texture_handle_table::set(GLuint aIndex, std::shared_ptr<texture> aTexture) {
+		if(aIndex >= mTextures.size()) throw std::runtime_error("asmith::gl::texture_handle_table::set : Index out of bounds");
+		std::shared_ptr<texture>& slot = mTextures[aIndex];
+		if(slot == aTexture) return;
+
+		if(mBindless) {
+			if(aTexture) aTexture->make_resident();
+			if(slot) slot->make_non_resident();
+			mHandles[aIndex] = aTexture ? aTexture->get_handle() : 0;
+			mark_dirty(aIndex);
+		}
+		slot = aTexture;
+	}
+
+	void texture_handle_table::remove(GLuint aIndex) {
+		if(aIndex >= mTextures.size() || ! mTextures[aIndex]) throw std::runtime_error("asmith::gl::texture_handle_table::remove : No texture at index");
+		set(aIndex, std::shared_ptr<texture>());
+		mFreeIndices.push_back(aIndex);
+	}
+
+	std::shared_ptr<texture> texture_handle_table::get(GLuint aIndex) const throw() {
+		return aIndex < mTextures.size() ? mTextures[aIndex] : std::shared_ptr<texture>();
+	}
+
+	size_t texture_handle_table::size() const throw() {
+		return mTextures.size();
+	}
+
+	bool texture_handle_table::is_bindless() const throw() {
+		return mBindless;
+	}
+
+	void texture_handle_table::upload() {
+		if(! mBindless) return;
+		const GLsizeiptr bytes = static_cast<GLsizeiptr>(mHandles.size() * sizeof(GLuint64));
+		if(bytes == 0) return;
+
+		if(mBuffer->size() < bytes) {
+			// Grow geometrically so that adding materials does not reallocate the buffer every frame
+			GLsizeiptr capacity = mBuffer->size() > 0 ? mBuffer->size() : static_cast<GLsizeiptr>(sizeof(GLuint64) * 64);
+			while(capacity < bytes) capacity *= 2;
+			mBuffer->buffer(nullptr, capacity);
+			mDirtyBegin = 0;
+			mDirtyEnd = mHandles.size();
+		}
+
+		if(mDirtyBegin == mDirtyEnd) return;
+		mBuffer->sub_buffer(mDirtyBegin * sizeof(GLuint64), &mHandles[mDirtyBegin], (mDirtyEnd - mDirtyBegin) * sizeof(GLuint64));
+		mDirtyBegin = 0;
+		mDirtyEnd = 0;
+	}
+
+	void texture_handle_table::bind(GLuint aBinding) {
+		if(! mBindless) throw std::runtime_error("asmith::gl::texture_handle_table::bind : Table is not using bindless textures, use bind_fallback");
+#if ASMITH_GL_VERSION_GE(4,3)
+		upload();
+		mBuffer->bind_base(GL_SHADER_STORAGE_BUFFER, aBinding);
+#else
+		(void) aBinding;
+		throw std::runtime_error("asmith::gl::texture_handle_table::bind : Shader storage buffers require OpenGL 4.3");
+#endif
+	}
+
+	GLuint texture_handle_table::bind_fallback(GLuint aIndex) {
+		const std::shared_ptr<texture> t = get(aIndex);
+		if(! t) throw std::runtime_error("asmith::gl::texture_handle_table::bind_fallback : No texture at index");
+		return t->bind();
+	}
+
+	void texture_handle_table::unbind_fallback(GLuint aIndex) {
+		const std::shared_ptr<texture> t = get(aIndex);
+		if(! t) throw std::runtime_error("asmith::gl::texture_handle_table::unbind_fallback : No texture at index");
+		t->unbind();
+	}
+
+}}
\ No newline at end of file
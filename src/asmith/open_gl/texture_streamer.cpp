@@ -0,0 +1,240 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+#include "asmith/open_gl/texture_streamer.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace asmith { namespace gl {
+
+	// texture_streamer
+
+	texture_streamer::texture_streamer(context& aContext, size_t aBudget) :
+		mContext(aContext),
+		mStatistics{ 0, 0, 0, 0, 0, 0 },
+		mBudget(aBudget),
+		mUsage(0),
+		mFrame(1),
+		mUploadLimit(UINT32_MAX)
+	{}
+
+	texture_streamer::~texture_streamer() {
+
+	}
+
+	GLuint texture_streamer::add(std::shared_ptr<texture_2d> aTexture, GLsizei aWidth, GLsizei aHeight, loader aLoader, float aPriority) {
+		if(! aTexture) throw std::runtime_error("asmith::gl::texture_streamer::add : Texture is null");
+		if(aWidth <= 0 || aHeight <= 0) throw std::runtime_error("asmith::gl::texture_streamer::add : Invalid texture size");
+		// Levels are streamed in from the smallest, so the texture cannot work out the size of level 0 itself
+		aTexture->set_base_size(aWidth, aHeight);
+
+		GLint levels = 0;
+		for(GLsizei size = std::max(aWidth, aHeight); size > 0 && levels < 32; size >>= 1) ++levels;
+
+		entry e;
+		e.texture = aTexture;
+		e.load = aLoader;
+		e.width = aWidth;
+		e.height = aHeight;
+		e.level_count = levels;
+		e.requested_level = levels - 1;
+		e.resident_level = levels;
+		e.bytes = 0;
+		e.priority = aPriority;
+		e.last_requested = 0;
+
+		if(mFreeIndices.empty()) {
+			mEntries.push_back(e);
+			return static_cast<GLuint>(mEntries.size() - 1);
+		}
+		const GLuint index = mFreeIndices.back();
+		mFreeIndices.pop_back();
+		mEntries[index] = e;
+		return index;
+	}
+
+	void texture_streamer::remove(GLuint aIndex) {
+		if(aIndex >= mEntries.size() || ! mEntries[aIndex].texture) throw std::runtime_error("asmith::gl::texture_streamer::remove : Invalid texture index");
+		entry& e = mEntries[aIndex];
+		// The texture keeps its levels, it is only no longer counted against the budget
+		mUsage -= e.bytes;
+		e.texture.reset();
+		e.load = loader();
+		e.bytes = 0;
+		mFreeIndices.push_back(aIndex);
+	}
+
+	std::shared_ptr<texture_2d> texture_streamer::get(GLuint aIndex) const throw() {
+		return aIndex < mEntries.size() ? mEntries[aIndex].texture : std::shared_ptr<texture_2d>();
+	}
+
+	void texture_streamer::set_priority(GLuint aIndex, float aPriority) {
+		if(aIndex >= mEntries.size() || ! mEntries[aIndex].texture) throw std::runtime_error("asmith::gl::texture_streamer::set_priority : Invalid texture index");
+		mEntries[aIndex].priority = aPriority;
+	}
+
+	void texture_streamer::request(GLuint aIndex, GLsizei aScreenWidth, GLsizei aScreenHeight) {
+		if(aIndex >= mEntries.size() || ! mEntries[aIndex].texture) throw std::runtime_error("asmith::gl::texture_streamer::request : Invalid texture index");
+		entry& e = mEntries[aIndex];
+
+		// Choose the coarsest level that still has at least one texel per pixel
+		GLint level = 0;
+		if(aScreenWidth > 0 && aScreenHeight > 0) {
+			while(level + 1 < e.level_count && (e.width >> (level + 1)) >= aScreenWidth && (e.height >> (level + 1)) >= aScreenHeight) ++level;
+		}else {
+			level = e.level_count - 1;
+		}
+
+		// A texture drawn several times in a frame uses the most detailed request
+		if(e.last_requested != mFrame || level < e.requested_level) e.requested_level = level;
+		e.last_requested = mFrame;
+	}
+
+	size_t texture_streamer::estimate_level_size(const entry& aEntry, GLint aLevel) const throw() {
+		if(aEntry.resident_level < aEntry.level_count) return aEntry.texture->get_level_memory_usage(aLevel);
+		// Nothing has been loaded yet so the format is unknown, assume 4 bytes per texel
+		const GLsizei w = aEntry.width >> aLevel;
+		const GLsizei h = aEntry.height >> aLevel;
+		return static_cast<size_t>(w > 0 ? w : 1) * static_cast<size_t>(h > 0 ? h : 1) * 4;
+	}
+
+	void texture_streamer::update_usage(entry& aEntry) throw() {
+		const size_t bytes = aEntry.texture->get_memory_usage();
+		mUsage = mUsage - aEntry.bytes + bytes;
+		aEntry.bytes = bytes;
+	}
+
+	void texture_streamer::stream_in(entry& aEntry) {
+		const GLint level = aEntry.resident_level - 1;
+		texture_2d& t = *aEntry.texture;
+		t.bind();
+		aEntry.load(t, level);
+		if(! t.is_level_loaded(level)) {
+			t.unbind();
+			throw std::runtime_error("asmith::gl::texture_streamer::stream_in : Loader did not load the requested level");
+		}
+		t.set_level_range(level, aEntry.level_count - 1);
+		t.unbind();
+		aEntry.resident_level = level;
+		update_usage(aEntry);
+		++mStatistics.levels_streamed_in;
+	}
+
+	void texture_streamer::stream_out(entry& aEntry) {
+		const GLint level = aEntry.resident_level;
+		texture_2d& t = *aEntry.texture;
+		t.bind();
+		t.set_level_range(level + 1, aEntry.level_count - 1);
+		t.unload_level(level);
+		t.unbind();
+		aEntry.resident_level = level + 1;
+		update_usage(aEntry);
+		++mStatistics.levels_streamed_out;
+	}
+
+	bool texture_streamer::make_room(size_t aBytes, size_t aExclude) {
+		while(mUsage + aBytes > mBudget) {
+			// Prefer levels finer than what was last requested, then the least recently requested textures
+			entry* victim = nullptr;
+			for(size_t i = 0; i < mEntries.size(); ++i) {
+				entry& e = mEntries[i];
+				if(i == aExclude || ! e.texture || e.resident_level >= e.level_count - 1) continue;
+				const bool excess = e.resident_level < e.requested_level;
+				if(! excess && e.last_requested == mFrame) continue;
+				if(victim == nullptr) {
+					victim = &e;
+					continue;
+				}
+				const bool victimExcess = victim->resident_level < victim->requested_level;
+				if(excess != victimExcess) {
+					if(excess) victim = &e;
+				}else if(e.last_requested != victim->last_requested) {
+					if(e.last_requested < victim->last_requested) victim = &e;
+				}else if(e.priority < victim->priority) {
+					victim = &e;
+				}
+			}
+
+			if(victim == nullptr) return false;
+			stream_out(*victim);
+			++mStatistics.evictions;
+		}
+		return true;
+	}
+
+	void texture_streamer::update() {
+		// The budget may have been lowered since the last update
+		make_room(0, SIZE_MAX);
+
+		std::vector<size_t> order;
+		for(size_t i = 0; i < mEntries.size(); ++i) {
+			const entry& e = mEntries[i];
+			if(e.texture && e.last_requested == mFrame && e.resident_level > e.requested_level) order.push_back(i);
+		}
+		std::sort(order.begin(), order.end(), [this](size_t a, size_t b)->bool {
+			const entry& x = mEntries[a];
+			const entry& y = mEntries[b];
+			if(x.priority != y.priority) return x.priority > y.priority;
+			return (x.resident_level - x.requested_level) > (y.resident_level - y.requested_level);
+		});
+
+		GLuint uploads = 0;
+		for(size_t i : order) {
+			entry& e = mEntries[i];
+			while(e.resident_level > e.requested_level && uploads < mUploadLimit) {
+				if(! make_room(estimate_level_size(e, e.resident_level - 1), i)) {
+					++mStatistics.budget_misses;
+					break;
+				}
+				stream_in(e);
+				++uploads;
+			}
+			if(uploads >= mUploadLimit) break;
+		}
+
+		++mFrame;
+	}
+
+	void texture_streamer::set_budget(size_t aBytes) throw() {
+		mBudget = aBytes;
+	}
+
+	size_t texture_streamer::get_budget() const throw() {
+		return mBudget;
+	}
+
+	size_t texture_streamer::get_memory_usage() const throw() {
+		return mUsage;
+	}
+
+	void texture_streamer::set_upload_limit(GLuint aLevels) throw() {
+		mUploadLimit = aLevels;
+	}
+
+	GLuint texture_streamer::get_upload_limit() const throw() {
+		return mUploadLimit;
+	}
+
+	texture_streamer::statistics texture_streamer::get_statistics() const throw() {
+		statistics s = mStatistics;
+		s.resident_bytes = mUsage;
+		s.resident_textures = 0;
+		for(const entry& e : mEntries) if(e.texture && e.resident_level < e.level_count) ++s.resident_textures;
+		return s;
+	}
+
+	void texture_streamer::reset_statistics() throw() {
+		mStatistics = statistics{ 0, 0, 0, 0, 0, 0 };
+	}
+
+}}
\ No newline at end of file
@@ -0,0 +1,200 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+#include "asmith/open_gl/texture_units.hpp"
+#include <stdexcept>
+#include <vector>
+#include "asmith/open_gl/context_state.hpp"
+
+namespace asmith { namespace gl {
+
+	// texture_units
+
+	GLuint texture_units::get_unit_count(context& aContext) throw() {
+		std::vector<implementation::texture_unit>& units = aContext.state->texture_units;
+		if(units.empty()) {
+			GLint count = 0;
+			glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &count);
+			units.resize(count > 0 ? count : 1, implementation::texture_unit{ std::weak_ptr<texture>(), GL_INVALID_ENUM, 0 });
+		}
+		return static_cast<GLuint>(units.size());
+	}
+
+	void texture_units::activate(context& aContext, GLuint aUnit) throw() {
+		if(aContext.state->active_texture_unit == aUnit) return;
+		glActiveTexture(GL_TEXTURE0 + aUnit);
+		aContext.state->active_texture_unit = aUnit;
+	}
+
+	GLuint texture_units::find_unit(context& aContext, uint64_t aClock) {
+		std::vector<implementation::texture_unit>& units = aContext.state->texture_units;
+		const GLuint count = get_unit_count(aContext);
+
+		GLuint lru = count;
+		uint64_t lruTime = UINT64_MAX;
+		for(GLuint i = 0; i < count; ++i) {
+			const std::shared_ptr<texture> t = units[i].bound_texture.lock();
+			if(! t) return i;
+			// Skip textures that are pinned by texture::bind or used earlier in the current call
+			if(t->mBindCount > 0 || units[i].last_used == aClock) continue;
+			if(units[i].last_used < lruTime) {
+				lru = i;
+				lruTime = units[i].last_used;
+			}
+		}
+
+		if(lru == count) throw std::runtime_error("asmith::gl::texture_units::find_unit : All texture units are in use");
+		return lru;
+	}
+
+	void texture_units::assign(context& aContext, texture& aTexture, GLuint aUnit, GLenum aTarget, uint64_t aClock) throw() {
+		implementation::context_state& state = *aContext.state;
+		implementation::texture_unit& unit = state.texture_units[aUnit];
+
+		const std::shared_ptr<texture> previous = unit.bound_texture.lock();
+		if(previous && previous.get() != &aTexture) {
+			previous->mUnit = -1;
+			++state.texture_unit_statistics.evictions;
+		}
+		if(aTexture.mUnit != -1 && aTexture.mUnit != static_cast<GLint>(aUnit)) {
+			state.texture_units[aTexture.mUnit].bound_texture.reset();
+		}
+
+		unit.bound_texture = std::static_pointer_cast<texture>(aTexture.shared_from_this());
+		unit.target = aTarget;
+		unit.last_used = aClock;
+		aTexture.mUnit = aUnit;
+		aTexture.mTarget = aTarget;
+		++state.texture_unit_statistics.binds;
+	}
+
+	GLuint texture_units::bind(context& aContext, texture& aTexture, GLenum aTarget) {
+		implementation::context_state& state = *aContext.state;
+		const uint64_t clock = ++state.texture_unit_clock;
+		get_unit_count(aContext);
+
+		if(aTexture.mUnit != -1) {
+			implementation::texture_unit& unit = state.texture_units[aTexture.mUnit];
+			if(unit.target == aTarget && unit.bound_texture.lock().get() == &aTexture) {
+				unit.last_used = clock;
+				++state.texture_unit_statistics.hits;
+				activate(aContext, aTexture.mUnit);
+				return aTexture.mUnit;
+			}
+		}
+
+		const GLuint u = find_unit(aContext, clock);
+		activate(aContext, u);
+		glBindTexture(aTarget, aTexture.get_id());
+		assign(aContext, aTexture, u, aTarget, clock);
+		return u;
+	}
+
+	void texture_units::bind(context& aContext, texture* const* aTextures, size_t aCount, GLuint* aUnits) {
+		implementation::context_state& state = *aContext.state;
+		const uint64_t clock = ++state.texture_unit_clock;
+		get_unit_count(aContext);
+
+		// Mark resident textures first so that they cannot be evicted by the textures that follow them
+		std::vector<size_t> misses;
+		for(size_t i = 0; i < aCount; ++i) {
+			texture& t = *aTextures[i];
+			const GLenum target = t.mBindCount > 0 ? t.mTarget : t.get_default_target();
+			if(t.mUnit != -1) {
+				implementation::texture_unit& unit = state.texture_units[t.mUnit];
+				if(unit.target == target && unit.bound_texture.lock().get() == &t) {
+					unit.last_used = clock;
+					aUnits[i] = t.mUnit;
+					++state.texture_unit_statistics.hits;
+					continue;
+				}
+			}
+			misses.push_back(i);
+		}
+		if(misses.empty()) return;
+
+		GLuint first = UINT32_MAX;
+		GLuint last = 0;
+		std::vector<size_t> changed;
+		std::vector<size_t> created;
+		for(size_t i : misses) {
+			texture& t = *aTextures[i];
+			if(t.mUnit != -1 && state.texture_units[t.mUnit].last_used == clock && state.texture_units[t.mUnit].bound_texture.lock().get() == &t) {
+				// The same texture appears more than once in the list
+				aUnits[i] = t.mUnit;
+				continue;
+			}
+			const GLenum target = t.mBindCount > 0 ? t.mTarget : t.get_default_target();
+			// A name from glGenTextures has no object until it is first bound to a target
+			if(t.mTarget == GL_INVALID_ENUM) created.push_back(i);
+			const GLuint u = find_unit(aContext, clock);
+			assign(aContext, t, u, target, clock);
+			aUnits[i] = u;
+			changed.push_back(i);
+			if(u < first) first = u;
+			if(u > last) last = u;
+		}
+
+#if ASMITH_GL_VERSION_GE(4,4)
+		if(state.texture_multi_bind && changed.size() > 1) {
+			// Units inside the range that are not being changed are rebound to their current texture
+			std::vector<GLuint> ids(last - first + 1, 0);
+			for(GLuint u = first; u <= last; ++u) {
+				const std::shared_ptr<texture> t = state.texture_units[u].bound_texture.lock();
+				if(t) ids[u - first] = t->get_id();
+			}
+			for(size_t i : created) {
+				activate(aContext, aUnits[i]);
+				glBindTexture(aTextures[i]->mTarget, aTextures[i]->get_id());
+			}
+			glBindTextures(first, static_cast<GLsizei>(ids.size()), &ids[0]);
+			++state.texture_unit_statistics.multi_bind_calls;
+			for(size_t i : changed) aTextures[i]->flush_parameters();
+			return;
+		}
+#endif
+		for(size_t i : changed) {
+			texture& t = *aTextures[i];
+			activate(aContext, aUnits[i]);
+			glBindTexture(t.mTarget, t.get_id());
+			t.flush_parameters();
+		}
+	}
+
+	GLint texture_units::get_unit(context& aContext, const texture& aTexture) throw() {
+		if(aTexture.mUnit == -1) return -1;
+		return aContext.state->texture_units[aTexture.mUnit].bound_texture.lock().get() == &aTexture ? aTexture.mUnit : -1;
+	}
+
+	std::shared_ptr<texture> texture_units::get_texture_bound_to(context& aContext, GLuint aUnit) throw() {
+		const std::vector<implementation::texture_unit>& units = aContext.state->texture_units;
+		return aUnit < units.size() ? units[aUnit].bound_texture.lock() : std::shared_ptr<texture>();
+	}
+
+	void texture_units::set_multi_bind(context& aContext, bool aValue) throw() {
+		aContext.state->texture_multi_bind = aValue;
+	}
+
+	bool texture_units::is_multi_bind_enabled(context& aContext) throw() {
+		return aContext.state->texture_multi_bind;
+	}
+
+	const texture_units::statistics& texture_units::get_statistics(context& aContext) throw() {
+		return aContext.state->texture_unit_statistics;
+	}
+
+	void texture_units::reset_statistics(context& aContext) throw() {
+		aContext.state->texture_unit_statistics = statistics{ 0, 0, 0, 0 };
+	}
+
+}}
\ No newline at end of file
@@ -0,0 +1,137 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+#include "asmith/open_gl/thread_pool.hpp"
+#include <exception>
+#include <memory>
+
+namespace asmith { namespace gl {
+
+	// thread_pool
+
+	thread_pool::thread_pool() :
+		thread_pool(std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 0)
+	{}
+
+	thread_pool::thread_pool(size_t aThreads) :
+		mExit(false)
+	{
+		mThreads.reserve(aThreads);
+		for(size_t i = 0; i < aThreads; ++i) mThreads.push_back(std::thread(&thread_pool::worker, this));
+	}
+
+	thread_pool::~thread_pool() {
+		{
+			std::lock_guard<std::mutex> lock(mLock);
+			mExit = true;
+		}
+		mCondition.notify_all();
+		for(std::thread& i : mThreads) i.join();
+	}
+
+	void thread_pool::worker() {
+		for(;;) {
+			std::function<void()> task;
+			{
+				std::unique_lock<std::mutex> lock(mLock);
+				mCondition.wait(lock, [this]()->bool { return mExit || ! mTasks.empty(); });
+				if(mTasks.empty()) return;
+				task = std::move(mTasks.front());
+				mTasks.pop_front();
+			}
+			task();
+		}
+	}
+
+	bool thread_pool::run_one() {
+		std::function<void()> task;
+		{
+			std::lock_guard<std::mutex> lock(mLock);
+			if(mTasks.empty()) return false;
+			task = std::move(mTasks.front());
+			mTasks.pop_front();
+		}
+		task();
+		return true;
+	}
+
+	size_t thread_pool::get_thread_count() const throw() {
+		return mThreads.size();
+	}
+
+	void thread_pool::parallel_for(size_t aBegin, size_t aEnd, size_t aGrain, const range_function& aFunction) {
+		if(aEnd <= aBegin) return;
+		const size_t count = aEnd - aBegin;
+		if(aGrain == 0) aGrain = 1;
+
+		// A few more ranges than threads balances uneven work without making the ranges too small
+		size_t ranges = (mThreads.size() + 1) * 4;
+		if(ranges > count / aGrain) ranges = count / aGrain;
+		if(ranges <= 1) {
+			aFunction(aBegin, aEnd);
+			return;
+		}
+
+		struct shared_state {
+			std::mutex lock;
+			std::condition_variable condition;
+			std::exception_ptr error;
+			size_t remaining;
+		};
+		std::shared_ptr<shared_state> state = std::make_shared<shared_state>();
+		state->remaining = ranges;
+
+		const size_t size = count / ranges;
+		const size_t extra = count % ranges;
+		{
+			std::lock_guard<std::mutex> lock(mLock);
+			size_t begin = aBegin;
+			for(size_t i = 0; i < ranges; ++i) {
+				const size_t end = begin + size + (i < extra ? 1 : 0);
+				mTasks.push_back([state, &aFunction, begin, end]() {
+					try {
+						aFunction(begin, end);
+					}catch(...) {
+						std::lock_guard<std::mutex> lock(state->lock);
+						if(! state->error) state->error = std::current_exception();
+					}
+					std::lock_guard<std::mutex> lock(state->lock);
+					if(--state->remaining == 0) state->condition.notify_all();
+				});
+				begin = end;
+			}
+		}
+		mCondition.notify_all();
+
+		// Help with the queue instead of blocking, which also allows nested calls
+		for(;;) {
+			{
+				std::lock_guard<std::mutex> lock(state->lock);
+				if(state->remaining == 0) break;
+			}
+			if(! run_one()) {
+				std::unique_lock<std::mutex> lock(state->lock);
+				state->condition.wait(lock, [&state]()->bool { return state->remaining == 0; });
+				break;
+			}
+		}
+
+		if(state->error) std::rethrow_exception(state->error);
+	}
+
+	thread_pool& thread_pool::get_default() {
+		static thread_pool POOL;
+		return POOL;
+	}
+
+}}
\ No newline at end of file
@@ -0,0 +1,145 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+#include "asmith/open_gl/uniform_block.hpp"
+#include <stdexcept>
+
+namespace asmith { namespace gl {
+
+	static size_t get_matrix_columns(GLenum aType) throw() {
+		switch(aType) {
+		case GL_FLOAT_MAT2: return 2;
+		case GL_FLOAT_MAT3: return 3;
+		case GL_FLOAT_MAT4: return 4;
+		default:			return 0;
+		}
+	}
+
+	static std::string strip_block_name(const std::string& aName, const std::string& aBlock) {
+		// Members of a block declared with an instance name are prefixed with the name of the block
+		std::string name = aName;
+		if(name.size() > aBlock.size() && name.compare(0, aBlock.size(), aBlock) == 0 && name[aBlock.size()] == '.') name.erase(0, aBlock.size() + 1);
+		if(name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0) name.erase(name.size() - 3);
+		return name;
+	}
+
+	// buffer_block
+
+	buffer_block::buffer_block(context& aContext, GLenum aTarget, GLuint aBinding, size_t aSize) :
+		mContext(aContext),
+		mSize(aSize),
+		mTarget(aTarget),
+		mBinding(aBinding),
+		mDirty(true)
+	{
+#if ASMITH_GL_VERSION_GE(4,3)
+		if(aTarget != GL_UNIFORM_BUFFER && aTarget != GL_SHADER_STORAGE_BUFFER) throw std::runtime_error("asmith::gl::buffer_block::buffer_block : Target must be GL_UNIFORM_BUFFER or GL_SHADER_STORAGE_BUFFER");
+#else
+		if(aTarget != GL_UNIFORM_BUFFER) throw std::runtime_error("asmith::gl::buffer_block::buffer_block : Target must be GL_UNIFORM_BUFFER");
+#endif
+		mBuffer.reset(new vertex_buffer(aContext));
+		mBuffer->set_usage(GL_DYNAMIC_DRAW);
+		mBuffer->buffer(nullptr, static_cast<GLsizeiptr>(aSize));
+	}
+
+	buffer_block::~buffer_block() {
+
+	}
+
+	void buffer_block::add_member(const GLchar* aName, size_t aOffset, GLenum aType, GLint aArraySize, size_t aElementSize) {
+		for(const member& m : mMembers) if(m.name == aName) throw std::runtime_error("asmith::gl::buffer_block::add_member : Member has already been added");
+		member m;
+		m.name = aName;
+		m.offset = aOffset;
+		m.element_size = aElementSize;
+		m.type = aType;
+		m.array_size = aArraySize;
+		mMembers.push_back(m);
+	}
+
+	void buffer_block::validate(const program& aProgram, const program::block_info& aBlock) const {
+		const bool storage = mTarget != GL_UNIFORM_BUFFER;
+		if(! storage && static_cast<size_t>(aBlock.data_size) > mSize) {
+			throw std::runtime_error("asmith::gl::buffer_block::attach : Block '" + aBlock.name + "' is " + std::to_string(aBlock.data_size) + " bytes but the struct is " + std::to_string(mSize));
+		}
+
+		const std::vector<program::uniform_info>& variables = storage ? aProgram.get_buffer_variables() : aProgram.get_uniforms();
+		for(const member& m : mMembers) {
+			const program::uniform_info* v = nullptr;
+			for(const program::uniform_info& i : variables) {
+				if(i.block_index == static_cast<GLint>(aBlock.index) && strip_block_name(i.name, aBlock.name) == m.name) {
+					v = &i;
+					break;
+				}
+			}
+
+			const std::string prefix = "asmith::gl::buffer_block::attach : Member '" + m.name + "' of block '" + aBlock.name + "'";
+			if(v == nullptr) throw std::runtime_error(prefix + " is not an active member");
+			if(! implementation::is_uniform_type_compatible(m.type, v->type)) throw std::runtime_error(prefix + " has a different type");
+			if(static_cast<size_t>(v->offset) != m.offset) {
+				throw std::runtime_error(prefix + " is at offset " + std::to_string(v->offset) + " but the struct member is at " + std::to_string(m.offset));
+			}
+			// Unsized arrays at the end of a storage block have a size of 0
+			if(m.array_size > 1 || v->size != 1) {
+				if(v->size != 0 && v->size != m.array_size) {
+					throw std::runtime_error(prefix + " has " + std::to_string(v->size) + " elements but the struct member has " + std::to_string(m.array_size));
+				}
+				if(static_cast<size_t>(v->array_stride) != m.element_size) {
+					throw std::runtime_error(prefix + " has an array stride of " + std::to_string(v->array_stride) + " but the struct member has " + std::to_string(m.element_size));
+				}
+			}
+			const size_t columns = get_matrix_columns(v->type);
+			if(columns > 0 && static_cast<size_t>(v->matrix_stride) * columns != m.element_size) {
+				throw std::runtime_error(prefix + " has a matrix stride of " + std::to_string(v->matrix_stride) + " but the struct member has " + std::to_string(m.element_size / columns));
+			}
+		}
+	}
+
+	void buffer_block::attach(program& aProgram, const GLchar* aName) {
+		if(! aProgram.is_linked()) throw std::runtime_error("asmith::gl::buffer_block::attach : Program has not been linked");
+		if(mTarget == GL_UNIFORM_BUFFER) {
+			const program::block_info* const b = aProgram.find_uniform_block(aName);
+			if(b == nullptr) throw std::runtime_error(std::string("asmith::gl::buffer_block::attach : Program has no uniform block named '") + aName + "'");
+			validate(aProgram, *b);
+			aProgram.set_uniform_block_binding(b->index, mBinding);
+		}else {
+			const program::block_info* const b = aProgram.find_storage_block(aName);
+			if(b == nullptr) throw std::runtime_error(std::string("asmith::gl::buffer_block::attach : Program has no storage block named '") + aName + "'");
+			validate(aProgram, *b);
+			aProgram.set_storage_block_binding(b->index, mBinding);
+		}
+	}
+
+	void buffer_block::upload(const void* aData) {
+		if(! mDirty) return;
+		mBuffer->sub_buffer(0, aData, static_cast<GLsizeiptr>(mSize));
+		mDirty = false;
+	}
+
+	void buffer_block::bind() {
+		mBuffer->bind_base(mTarget, mBinding);
+	}
+
+	GLenum buffer_block::get_target() const throw() {
+		return mTarget;
+	}
+
+	GLuint buffer_block::get_binding() const throw() {
+		return mBinding;
+	}
+
+	std::shared_ptr<vertex_buffer> buffer_block::get_buffer() const throw() {
+		return mBuffer;
+	}
+
+}}
\ No newline at end of file
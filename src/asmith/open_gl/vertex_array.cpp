@@ -12,13 +12,50 @@
 //	limitations under the License.
 
 #include "asmith/open_gl/vertex_array.hpp"
+#include "asmith/open_gl/context_state.hpp"
+#include "asmith/open_gl/program.hpp"
 
 namespace asmith { namespace gl {
 	
+#if ASMITH_GL_VERSION_GE(3,3)
+	static GLsizei get_attribute_stride(const vertex_array::vertex_attribute& aAttribute) throw() {
+		if(aAttribute.stride != 0) return aAttribute.stride;
+		// A stride of 0 means that the attribute is tightly packed
+		switch(aAttribute.type) {
+		case GL_BYTE:
+		case GL_UNSIGNED_BYTE:
+			return aAttribute.size;
+		case GL_SHORT:
+		case GL_UNSIGNED_SHORT:
+		case GL_HALF_FLOAT:
+			return aAttribute.size * 2;
+		case GL_DOUBLE:
+			return aAttribute.size * 8;
+		default:
+			return aAttribute.size * 4;
+		}
+	}
+#endif
+
 	// class vertex_array
+
+	bool vertex_array::is_instancing_supported() throw() {
+		return ASMITH_GL_VERSION_GE(3,3);
+	}
+
+	bool vertex_array::is_base_instance_supported() throw() {
+#ifdef GL_ARB_base_instance
+		return GLEW_VERSION_4_2 || GLEW_ARB_base_instance ? true : false;
+#else
+		return false;
+#endif
+	}
 	
 	vertex_array::vertex_array(context& aContext) :
 		object(aContext)
+#if ASMITH_GL_VERSION_GE(3,3)
+		, mBaseInstance(0)
+#endif
 	{
 		glGenVertexArrays(1, &mID);
 		if (mID == object::INVALID_ID) throw std::runtime_error("asmith::gl::vertex_array::create : glGenVertexArrays returned 0");
@@ -26,11 +63,19 @@ namespace asmith { namespace gl {
 
 	vertex_array::~vertex_array() {
 		if(mID == 0) return;
+		// Deleting a bound VAO reverts the binding to 0
+		if(is_currently_bound()) mContext.state->currently_bound_vertex_array = 0;
 		glDeleteVertexArrays(1, &mID);
 		mID = 0;
 	}
 
 	GLuint vertex_array::add_attribute(std::shared_ptr<vertex_buffer> aBuffer, const vertex_attribute& aAttribute) {
+#if ASMITH_GL_VERSION_GE(3,3)
+		// The other instanced attributes may have been moved, the next instanced draw points them all at the same instance
+		if(aAttribute.divisor != 0 && mBaseInstance != 0) mBaseInstance = UINT32_MAX;
+#else
+		if(aAttribute.divisor != 0) throw std::runtime_error("asmith::gl::vertex_array::add_attribute : Instancing is not supported");
+#endif
 		mAttributes.push_back(aAttribute);
 		mBuffers.push_back(aBuffer);
 
@@ -43,20 +88,89 @@ namespace asmith { namespace gl {
 		const vertex_attribute& a = mAttributes[attrib];
 		glBindBuffer(GL_ARRAY_BUFFER, mBuffers[attrib]->get_id());
 		glVertexAttribPointer(attrib, a.size, a.type, a.normalised, a.stride, a.pointer);
+		glEnableVertexAttribArray(attrib);
+#if ASMITH_GL_VERSION_GE(3,3)
+		if(a.divisor != 0) glVertexAttribDivisor(attrib, a.divisor);
+#endif
 		glBindBuffer(GL_ARRAY_BUFFER, previous ? previous->get_id() : 0);
-		glBindVertexArray(0);
+		glBindVertexArray(mContext.state->currently_bound_vertex_array);
 
 		return attrib;
 	}
 
+	GLuint vertex_array::get_attribute_count() const throw() {
+		return static_cast<GLuint>(mAttributes.size());
+	}
+
 	void vertex_array::draw_arrays(GLenum aMode, GLint aFirst, GLsizei aCount) const throw() {
 		if(mID == 0) return;
+		// Uniforms set since the program was bound are uploaded just before they are used
+		const std::shared_ptr<program>& p = mContext.state->currently_bound_program;
+		if(p) p->flush_uniforms();
+#ifdef GL_ARB_separate_shader_objects
+		else if(mContext.state->currently_bound_pipeline) mContext.state->currently_bound_pipeline->flush_uniforms();
+#endif
+		if(is_currently_bound()) {
+			glDrawArrays(aMode, aFirst, aCount);
+		}else {
+			glBindVertexArray(mID);
+			glDrawArrays(aMode, aFirst, aCount);
+			glBindVertexArray(mContext.state->currently_bound_vertex_array);
+		}
+	}
+
+#if ASMITH_GL_VERSION_GE(3,3)
+	void vertex_array::draw_arrays_instanced(GLenum aMode, GLint aFirst, GLsizei aCount, GLsizei aInstances, GLuint aBaseInstance) const throw() {
+		if(mID == 0) return;
+		const std::shared_ptr<program>& p = mContext.state->currently_bound_program;
+		if(p) p->flush_uniforms();
+#ifdef GL_ARB_separate_shader_objects
+		else if(mContext.state->currently_bound_pipeline) mContext.state->currently_bound_pipeline->flush_uniforms();
+#endif
+		const bool bound = is_currently_bound();
+		if(! bound) glBindVertexArray(mID);
+
+#ifdef GL_ARB_base_instance
+		if(is_base_instance_supported()) {
+			glDrawArraysInstancedBaseInstance(aMode, aFirst, aCount, aInstances, aBaseInstance);
+		}else
+#endif
+		{
+			if(aBaseInstance != mBaseInstance) {
+				// Point the instanced attributes at the first instance of the draw
+				const std::shared_ptr<vertex_buffer> previous = vertex_buffer::get_buffer_bound_to(mContext, GL_ARRAY_BUFFER);
+				const GLuint s = mAttributes.size();
+				for(GLuint i = 0; i < s; ++i) {
+					const vertex_attribute& a = mAttributes[i];
+					if(a.divisor == 0) continue;
+					const GLsizeiptr offset = static_cast<GLsizeiptr>(aBaseInstance / a.divisor) * get_attribute_stride(a);
+					glBindBuffer(GL_ARRAY_BUFFER, mBuffers[i]->get_id());
+					glVertexAttribPointer(i, a.size, a.type, a.normalised, a.stride, static_cast<const GLubyte*>(a.pointer) + offset);
+				}
+				glBindBuffer(GL_ARRAY_BUFFER, previous ? static_cast<GLuint>(previous->get_id()) : 0);
+				mBaseInstance = aBaseInstance;
+			}
+			glDrawArraysInstanced(aMode, aFirst, aCount, aInstances);
+		}
+
+		if(! bound) glBindVertexArray(mContext.state->currently_bound_vertex_array);
+	}
+#endif
+
+	void vertex_array::bind() throw() {
+		if(mID == 0 || is_currently_bound()) return;
 		glBindVertexArray(mID);
-		const GLuint  s = mAttributes.size();
-		for(GLuint  i = 0; i < s; ++i) glEnableVertexAttribArray(i);
-		glDrawArrays(aMode, aFirst, aCount);
-		for(GLuint  i = 0; i < s; ++i) glDisableVertexAttribArray(i);
+		mContext.state->currently_bound_vertex_array = mID;
+	}
+
+	void vertex_array::unbind() throw() {
+		if(! is_currently_bound()) return;
 		glBindVertexArray(0);
+		mContext.state->currently_bound_vertex_array = 0;
+	}
+
+	bool vertex_array::is_currently_bound() const throw() {
+		return mID != 0 && mContext.state->currently_bound_vertex_array == mID;
 	}
 
 }}
\ No newline at end of file
@@ -179,7 +179,6 @@ namespace asmith { namespace gl {
 			autoBind = true;
 		}
 
-		mSize = aSize;
 		glBufferSubData(mTarget, aOffset, aSize, aData);
 		if(autoBind) unbind();
 	}
@@ -193,7 +192,6 @@ namespace asmith { namespace gl {
 			autoBind = true;
 		}
 
-		mSize = aSize;
 		glGetBufferSubData(mTarget, aOffset, aSize, aData);
 		if(autoBind) unbind();
 	}
@@ -243,6 +241,68 @@ namespace asmith { namespace gl {
 		return mTarget;
 	}
 
+	static bool is_indexed_buffer_target(GLenum aTarget) throw() {
+		switch(aTarget) {
+		case GL_TRANSFORM_FEEDBACK_BUFFER:
+#if ASMITH_GL_VERSION_GE(3,1)
+		case GL_UNIFORM_BUFFER:
+#endif
+#if ASMITH_GL_VERSION_GE(4,2)
+		case GL_ATOMIC_COUNTER_BUFFER:
+#endif
+#if ASMITH_GL_VERSION_GE(4,3)
+		case GL_SHADER_STORAGE_BUFFER:
+#endif
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	static GLint get_offset_alignment(GLenum aTarget) throw() {
+		GLint alignment = 1;
+		switch(aTarget) {
+#if ASMITH_GL_VERSION_GE(3,1)
+		case GL_UNIFORM_BUFFER:
+			glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+			break;
+#endif
+#if ASMITH_GL_VERSION_GE(4,3)
+		case GL_SHADER_STORAGE_BUFFER:
+			glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+			break;
+#endif
+		case GL_TRANSFORM_FEEDBACK_BUFFER:
+#if ASMITH_GL_VERSION_GE(4,2)
+		case GL_ATOMIC_COUNTER_BUFFER:
+#endif
+			alignment = 4;
+			break;
+		default:
+			break;
+		}
+		return alignment > 0 ? alignment : 1;
+	}
+
+	bool vertex_buffer::bind_base(GLenum aTarget, GLuint aIndex) throw() {
+		if(mID == 0 || ! is_indexed_buffer_target(aTarget)) return false;
+		glBindBufferBase(aTarget, aIndex, mID);
+		// glBindBufferBase also changes the generic binding point, restore it
+		const std::shared_ptr<vertex_buffer> prev = get_buffer_bound_to(mContext, aTarget);
+		glBindBuffer(aTarget, prev ? prev->get_id() : 0);
+		return true;
+	}
+
+	bool vertex_buffer::bind_range(GLenum aTarget, GLuint aIndex, GLintptr aOffset, GLsizeiptr aSize) throw() {
+		if(mID == 0 || ! is_indexed_buffer_target(aTarget)) return false;
+		if(aOffset < 0 || aSize <= 0 || aOffset + aSize > mSize) return false;
+		if(aOffset % get_offset_alignment(aTarget) != 0) return false;
+		glBindBufferRange(aTarget, aIndex, mID, aOffset, aSize);
+		const std::shared_ptr<vertex_buffer> prev = get_buffer_bound_to(mContext, aTarget);
+		glBindBuffer(aTarget, prev ? prev->get_id() : 0);
+		return true;
+	}
+
 #if ASMITH_GL_VERSION_GE(3, 0)	
 	void* vertex_buffer::map(GLenum aAccess) throw() {
 		if(is_mapped() || ! is_currently_bound()) return nullptr;
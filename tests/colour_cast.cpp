@@ -0,0 +1,183 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+// Checks colour_cast between every pair of colour typedefs, and checks the integer path exactly.
+// No OpenGL context is needed :
+// g++ -std=c++14 -O2 -Iinclude tests/colour_cast.cpp -o colour_cast
+
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include "asmith/open_gl/colour.hpp"
+
+using namespace asmith::gl;
+
+static size_t gChecks = 0;
+static size_t gFailures = 0;
+
+template<class... T>
+struct type_list {};
+
+typedef type_list<
+	colour_r_8u, colour_rg_8u, colour_rgb_8u, colour_rgba_8u, colour_bgr_8u, colour_bgra_8u,
+	colour_r_8i, colour_rg_8i, colour_rgb_8i, colour_rgba_8i, colour_bgr_8i, colour_bgra_8i,
+	colour_r_f, colour_rg_f, colour_rgb_f, colour_rgba_f, colour_bgr_f, colour_bgra_f,
+	colour_rgb_8u_srgb, colour_rgba_8u_srgb, colour_bgr_8u_srgb, colour_bgra_8u_srgb,
+	colour_r_h, colour_rg_h, colour_rgb_h, colour_rgba_h,
+	colour_rgb_565, colour_rgba_4444, colour_rgba_5551, colour_rgba_1010102, colour_rgba_2101010_rev,
+	colour_rgb_11f_11f_10f
+> colour_types;
+
+static int get_channel_count(const GLenum aFormat) {
+	switch(aFormat) {
+	case GL_RED:	return 1;
+	case GL_RG:		return 2;
+	case GL_RGB:
+	case GL_BGR:	return 3;
+	default:		return 4;
+	}
+}
+
+template<class C>
+static bool is_signed_colour() {
+	if(is_srgb_colour<C>::value) return false;
+	return C::TYPE == GL_BYTE || C::TYPE == GL_SHORT || C::TYPE == GL_INT || C::TYPE == GL_FLOAT || C::TYPE == GL_HALF_FLOAT;
+}
+
+// The largest error that storing a normalised value in channel aChannel of C can add
+template<class C>
+static double get_step(const int aChannel) {
+	if(is_srgb_colour<C>::value) return aChannel == 3 ? 1.0 / 255.0 : 3.0 / 255.0;
+	switch(static_cast<GLenum>(C::TYPE)) {
+	case GL_FLOAT:							return 1e-6;
+	case GL_HALF_FLOAT:						return 1.0 / 1024.0;
+	case GL_UNSIGNED_INT_10F_11F_11F_REV:	return 1.0 / 32.0;
+	default:
+		break;
+	}
+	const int64_t max = aChannel == 0 ? C::MAX_RED : aChannel == 1 ? C::MAX_GREEN : aChannel == 2 ? C::MAX_BLUE : C::MAX_ALPHA;
+	return max <= 0 ? 1.0 : 1.0 / static_cast<double>(max);
+}
+
+template<class A, class B>
+static void check_pair(const char* aName) {
+	const int srcChannels = get_channel_count(B::FORMAT);
+	const int dstChannels = get_channel_count(A::FORMAT);
+	const bool negative = is_signed_colour<A>() && is_signed_colour<B>();
+
+	for(int i = negative ? -255 : 0; i <= 255; ++i) {
+		const GLfloat v = static_cast<GLfloat>(i) / 255.f;
+		const GLfloat w = i < 0 ? -1.f - v : 1.f - v;
+		vec4f input;
+		input[0] = v;
+		input[1] = w;
+		input[2] = v * 0.5f;
+		input[3] = i < 0 ? -v : v;
+
+		B b;
+		b.set_rgba(input);
+		vec4f src;
+		b.get_rgba(src);
+		const A a = colour_cast<A>(b);
+		vec4f dst;
+		a.get_rgba(dst);
+
+		for(int c = 0; c < 4; ++c) {
+			const bool inSrc = c == 3 ? srcChannels == 4 : c < srcChannels;
+			const bool inDst = c == 3 ? dstChannels == 4 : c < dstChannels;
+			if(! inDst) continue;
+			// Alpha that the source does not have is opaque, missing colour channels are not checked
+			if(! inSrc && c != 3) continue;
+			const double expected = inSrc ? src[c] : 1.0;
+			const double tolerance = get_step<A>(c) * 1.001 + 1e-6;
+			++gChecks;
+			if(std::fabs(dst[c] - expected) > tolerance) {
+				if(++gFailures <= 20) std::printf("FAIL %s channel %d : %f became %f\n", aName, c, expected, static_cast<double>(dst[c]));
+			}
+		}
+	}
+}
+
+template<class A>
+static void check_from(type_list<>) {}
+
+template<class A, class B, class... T>
+static void check_from(type_list<B, T...>) {
+	char name[128];
+	std::snprintf(name, sizeof(name), "%#x/%#x -> %#x/%#x%s", B::FORMAT, B::TYPE, A::FORMAT, A::TYPE, is_srgb_colour<A>::value || is_srgb_colour<B>::value ? " (sRGB)" : "");
+	check_pair<A, B>(name);
+	check_from<A>(type_list<T...>());
+}
+
+static void check_all(type_list<>) {}
+
+template<class A, class... T>
+static void check_all(type_list<A, T...>) {
+	check_from<A>(colour_types());
+	check_all(type_list<T...>());
+}
+
+// The integer path must match exact truncation towards zero, clamped to the range of the destination
+template<GLenum DST, GLenum SRC>
+static void check_integer(const int64_t aValue) {
+	typedef colour_r<DST> A;
+	typedef colour_r<SRC> B;
+	static_assert(implementation::select_colour_cast<A, B>() == implementation::COLOUR_CAST_INTEGER || DST == SRC, "Expected the integer path");
+
+	const long double exact = static_cast<long double>(aValue) * static_cast<long double>(colour_max(DST)) / static_cast<long double>(colour_max(SRC));
+	int64_t expected = static_cast<int64_t>(std::trunc(exact));
+	if(expected < colour_min(DST)) expected = colour_min(DST);
+
+	const B b(static_cast<typename B::type>(aValue));
+	const A a = colour_cast<A>(b);
+	++gChecks;
+	if(static_cast<int64_t>(a.r) != expected) {
+		if(++gFailures <= 20) std::printf("FAIL integer %#x -> %#x : %lld became %lld, expected %lld\n", SRC, DST,
+			static_cast<long long>(aValue), static_cast<long long>(a.r), static_cast<long long>(expected));
+	}
+}
+
+template<GLenum DST, GLenum SRC>
+static void check_integer_range() {
+	const int64_t min = colour_min(SRC);
+	const int64_t max = static_cast<int64_t>(colour_max(SRC));
+	if(max <= UINT16_MAX) {
+		for(int64_t v = min; v <= max; ++v) check_integer<DST, SRC>(v);
+	}else {
+		const int64_t edges[] = { min, min + 1, -max, -1, 0, 1, max - 1, max };
+		for(int64_t v : edges) if(v >= min) check_integer<DST, SRC>(v);
+		const int64_t stride = (max - min) / 65521;
+		for(int64_t v = min; v <= max - stride; v += stride) check_integer<DST, SRC>(v);
+	}
+}
+
+template<GLenum SRC, GLenum A, GLenum B, GLenum C>
+static void check_integer_from() {
+	check_integer_range<A, SRC>();
+	check_integer_range<B, SRC>();
+	check_integer_range<C, SRC>();
+}
+
+int main() {
+	check_all(colour_types());
+
+	check_integer_from<GL_UNSIGNED_BYTE, GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, GL_UNSIGNED_INT>();
+	check_integer_from<GL_UNSIGNED_SHORT, GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, GL_UNSIGNED_INT>();
+	check_integer_from<GL_UNSIGNED_INT, GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, GL_UNSIGNED_INT>();
+	check_integer_from<GL_BYTE, GL_BYTE, GL_SHORT, GL_INT>();
+	check_integer_from<GL_SHORT, GL_BYTE, GL_SHORT, GL_INT>();
+	check_integer_from<GL_INT, GL_BYTE, GL_SHORT, GL_INT>();
+
+	std::printf("%zu checks, %zu failures\n", gChecks, gFailures);
+	return gFailures == 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,138 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+
+// Checks that convert_pixels writes the same bytes as colour_cast for every pair of colour typedefs, for array
+// lengths that end part way through a vector, and that nothing after the destination array is written.
+// Build it with and without SIMD to cover each kernel. No OpenGL context is needed :
+// g++ -std=c++14 -O2 -Iinclude tests/colour_conversion.cpp -o colour_conversion
+// g++ -std=c++14 -O2 -march=native -Iinclude tests/colour_conversion.cpp -o colour_conversion
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "asmith/open_gl/colour_conversion.hpp"
+
+using namespace asmith::gl;
+
+static size_t gChecks = 0;
+static size_t gFailures = 0;
+
+template<class... T>
+struct type_list {};
+
+typedef type_list<
+	colour_r_8u, colour_rg_8u, colour_rgb_8u, colour_rgba_8u, colour_bgr_8u, colour_bgra_8u,
+	colour_r_8i, colour_rg_8i, colour_rgb_8i, colour_rgba_8i, colour_bgr_8i, colour_bgra_8i,
+	colour_r_f, colour_rg_f, colour_rgb_f, colour_rgba_f, colour_bgr_f, colour_bgra_f,
+	colour_rgb_8u_srgb, colour_rgba_8u_srgb, colour_bgr_8u_srgb, colour_bgra_8u_srgb,
+	colour_r_h, colour_rg_h, colour_rgb_h, colour_rgba_h,
+	colour_rgb_565, colour_rgba_4444, colour_rgba_5551, colour_rgba_1010102, colour_rgba_2101010_rev,
+	colour_rgb_11f_11f_10f
+> colour_types;
+
+enum : size_t {
+	PIXELS = 1031,
+	GUARD = 0xA5
+};
+
+// 8 bit sources are filled with raw bytes so that every value appears in every channel, other sources are set
+// from a grid of normalised values. Floats converted to a signed type may be negative, other conversions from
+// float expect the range [0, 1]
+template<class A, class B>
+static void fill(std::vector<B>& aPixels) {
+	const bool bytes = sizeof(typename B::type) == 1 && ! is_srgb_colour<B>::value;
+	const bool negative = A::TYPE == GL_BYTE && ! is_srgb_colour<A>::value;
+	for(size_t i = 0; i < aPixels.size(); ++i) {
+		if(bytes) {
+			uint8_t* const p = reinterpret_cast<uint8_t*>(&aPixels[i]);
+			for(size_t c = 0; c < sizeof(B); ++c) p[c] = static_cast<uint8_t>(i * (c * 2 + 1) + c * 37);
+		}else {
+			vec4f v;
+			for(int c = 0; c < 4; ++c) {
+				const GLfloat t = static_cast<GLfloat>((i * (c * 2 + 1) + c * 97) % aPixels.size()) / static_cast<GLfloat>(aPixels.size() - 1);
+				v[c] = negative ? t * 2.f - 1.f : t;
+			}
+			aPixels[i].set_rgba(v);
+		}
+	}
+}
+
+template<class A, class B>
+static void check_pixels(const char* aName, const std::vector<B>& aSrc, const size_t aCount) {
+	std::vector<A> dst(aCount + 1);
+	memset(static_cast<void*>(dst.data()), GUARD, sizeof(A) * dst.size());
+	convert_pixels<A, B>(aSrc.data(), dst.data(), aCount);
+
+	for(size_t i = 0; i < aCount; ++i) {
+		const A expected = colour_cast<A>(aSrc[i]);
+		++gChecks;
+		if(memcmp(&dst[i], &expected, sizeof(A)) != 0) {
+			if(++gFailures <= 20) std::printf("FAIL %s : pixel %zu of %zu differs from colour_cast\n", aName, i, aCount);
+		}
+	}
+
+	const uint8_t* const guard = reinterpret_cast<const uint8_t*>(&dst[aCount]);
+	for(size_t c = 0; c < sizeof(A); ++c) {
+		++gChecks;
+		if(guard[c] != GUARD) {
+			if(++gFailures <= 20) std::printf("FAIL %s : wrote past the end of %zu pixels\n", aName, aCount);
+			break;
+		}
+	}
+}
+
+template<class A, class B>
+static void check_pair(const char* aName) {
+	std::vector<B> src(PIXELS);
+	fill<A, B>(src);
+	check_pixels<A, B>(aName, src, PIXELS);
+	for(size_t count = 0; count <= 17; ++count) check_pixels<A, B>(aName, src, count);
+}
+
+template<class A>
+static void check_from(type_list<>) {}
+
+template<class A, class B, class... T>
+static void check_from(type_list<B, T...>) {
+	char name[128];
+	std::snprintf(name, sizeof(name), "%#x/%#x -> %#x/%#x%s", B::FORMAT, B::TYPE, A::FORMAT, A::TYPE, is_srgb_colour<A>::value || is_srgb_colour<B>::value ? " (sRGB)" : "");
+	check_pair<A, B>(name);
+	check_from<A>(type_list<T...>());
+}
+
+static void check_all(type_list<>) {}
+
+template<class A, class... T>
+static void check_all(type_list<A, T...>) {
+	check_from<A>(colour_types());
+	check_all(type_list<T...>());
+}
+
+// sRGB encoding evaluates a curve rather than a table, so check it at every 2^-20 step of [0, 1]
+static void check_srgb_encode() {
+	const size_t steps = 1 << 20;
+	std::vector<colour_rgba_f> src((steps + 4) / 4);
+	GLfloat* const values = reinterpret_cast<GLfloat*>(src.data());
+	for(size_t i = 0; i < src.size() * 4; ++i) values[i] = static_cast<GLfloat>(i < steps ? i : steps) / static_cast<GLfloat>(steps);
+	check_pixels<colour_rgba_8u_srgb, colour_rgba_f>("sRGB encode", src, src.size());
+	check_pixels<colour_bgr_8u_srgb, colour_rgba_f>("sRGB encode", src, src.size());
+}
+
+int main() {
+	check_all(colour_types());
+	check_srgb_encode();
+
+	std::printf("%zu checks, %zu failures\n", gChecks, gFailures);
+	return gFailures == 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,194 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+// Checks that light_set merges the changed lights into the expected ranges, keeps the lights packed when they
+// are removed, and that the buffer it binds holds the same lights as the set. The buffer is read back, which
+// needs an OpenGL 4.3 context, created with a hidden GLUT window :
+// g++ -std=c++14 -O2 -DASMITH_GL_VERSION_MAJOR=4 -DASMITH_GL_VERSION_MINOR=3 -Iinclude tests/light_set.cpp <library sources> -lglut -lGLEW -lGL -o light_set
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#include <GL/glew.h>
+#include <GL/freeglut.h>
+#include "asmith/open_gl/light_set.hpp"
+
+using namespace asmith::gl;
+
+enum : size_t {
+	HEADER_BYTES = 16,
+	LIGHT_BYTES = sizeof(light_set::light_data)
+};
+
+static size_t gChecks = 0;
+static size_t gFailures = 0;
+
+static void check(bool aCondition, const char* aName) {
+	++gChecks;
+	if(! aCondition && ++gFailures <= 20) std::printf("FAIL %s\n", aName);
+}
+
+template<class F>
+static void check_throws(F aFunction, const char* aName) {
+	++gChecks;
+	try {
+		aFunction();
+	}catch(std::runtime_error&) {
+		return;
+	}
+	if(++gFailures <= 20) std::printf("FAIL %s : no exception\n", aName);
+}
+
+// Every light is made different so that the buffer shows where each one was written
+static light_set::light_data make_light(GLfloat aId) {
+	light_set::light_data tmp;
+	std::memset(&tmp, 0, sizeof(tmp));
+	tmp.position[0] = aId;
+	tmp.position[3] = 1.f;
+	tmp.spot_cos_cutoff = -1.f;
+	return tmp;
+}
+
+// Uploads and checks the ranges and bytes that the upload sent
+static void check_upload(light_set& aSet, size_t aRanges, size_t aBytes, const char* aName) {
+	aSet.reset_statistics();
+	aSet.upload();
+	const light_set::statistics s = aSet.get_statistics();
+	++gChecks;
+	if((s.ranges_uploaded != aRanges || s.bytes_uploaded != aBytes) && ++gFailures <= 20) {
+		std::printf("FAIL %s : %zu ranges and %zu bytes, expected %zu and %zu\n", aName, s.ranges_uploaded, s.bytes_uploaded, aRanges, aBytes);
+	}
+}
+
+// Reads the bound buffer back and checks that it holds exactly the lights of the set
+static void check_buffer(light_set& aSet, const std::vector<light_set::handle>& aHandles, const char* aName) {
+	aSet.bind();
+	GLint id = 0;
+	glGetIntegeri_v(GL_SHADER_STORAGE_BUFFER_BINDING, aSet.get_binding(), &id);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, static_cast<GLuint>(id));
+	std::vector<uint8_t> data(HEADER_BYTES + aSet.size() * LIGHT_BYTES);
+	glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, static_cast<GLsizeiptr>(data.size()), data.data());
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+	// Handles that were reused are in the list more than once
+	std::vector<light_set::handle> handles = aHandles;
+	std::sort(handles.begin(), handles.end());
+	handles.erase(std::unique(handles.begin(), handles.end()), handles.end());
+
+	GLuint count;
+	std::memcpy(&count, data.data(), sizeof(GLuint));
+	bool ok = count == aSet.size();
+	size_t matched = 0;
+	std::vector<bool> found(aSet.size(), false);
+	for(const light_set::handle h : handles) {
+		if(! aSet.is_valid(h)) continue;
+		bool match = false;
+		for(size_t i = 0; ok && i < aSet.size() && ! match; ++i) {
+			if(found[i] || std::memcmp(&data[HEADER_BYTES + i * LIGHT_BYTES], &aSet.get(h), LIGHT_BYTES) != 0) continue;
+			found[i] = true;
+			match = true;
+			++matched;
+		}
+		ok = ok && match;
+	}
+	check(ok && matched == aSet.size(), aName);
+}
+
+static void check_ranges(context& aContext) {
+	light_set set(aContext, 0);
+	std::vector<light_set::handle> handles;
+	for(size_t i = 0; i < 20; ++i) handles.push_back(set.add(make_light(static_cast<GLfloat>(i))));
+	check_upload(set, 2, HEADER_BYTES + 20 * LIGHT_BYTES, "first upload");
+	check_upload(set, 0, 0, "nothing changed");
+
+	// Lights are not moved by edits until one is removed, so handle i is still at index i
+	set.edit(handles[2]).position[1] = 1.f;
+	set.edit(handles[5]).position[1] = 1.f;
+	set.edit(handles[15]).position[1] = 1.f;
+	check_upload(set, 2, 4 * LIGHT_BYTES + LIGHT_BYTES, "close lights merged");
+
+	// A gap of MERGE_GAP clean lights is sent again, one more starts a new range
+	set.set(handles[3], make_light(100.f));
+	set.set(handles[8], make_light(101.f));
+	check_upload(set, 1, 6 * LIGHT_BYTES, "gap of four merged");
+	set.set(handles[3], make_light(102.f));
+	set.set(handles[9], make_light(103.f));
+	check_upload(set, 2, 2 * LIGHT_BYTES, "gap of five split");
+
+	// Editing in any order gives the same ranges
+	set.edit(handles[19]);
+	set.edit(handles[0]);
+	set.edit(handles[18]);
+	set.edit(handles[1]);
+	check_upload(set, 2, 4 * LIGHT_BYTES, "unsorted edits");
+	check_buffer(set, handles, "buffer after edits");
+
+	// The last light moves into the gap, only it and the count are sent
+	set.remove(handles[4]);
+	check(! set.is_valid(handles[4]) && set.size() == 19, "removed");
+	check_throws([&]() { set.remove(handles[4]); }, "removed twice");
+	check_throws([&]() { set.edit(handles[4]); }, "edit a removed light");
+	check_upload(set, 2, HEADER_BYTES + LIGHT_BYTES, "remove moves the last light");
+	check_buffer(set, handles, "buffer after remove");
+
+	// A changed light that is then removed from the end must not be sent
+	const light_set::handle last = handles[18];
+	set.edit(last);
+	set.remove(last);
+	check_upload(set, 1, HEADER_BYTES, "removed from the end");
+	check_buffer(set, handles, "buffer after removing the last light");
+
+	// Handles are reused, the new light goes at the end
+	const light_set::handle reused = set.add(make_light(200.f));
+	check(reused == handles[4] || reused == last, "handle reused");
+	handles.push_back(reused);
+	check_upload(set, 2, HEADER_BYTES + LIGHT_BYTES, "add one light");
+	check_buffer(set, handles, "buffer after reuse");
+
+	// Growing the buffer sends every light again
+	for(size_t i = 0; i < 100; ++i) handles.push_back(set.add(make_light(300.f + static_cast<GLfloat>(i))));
+	check_upload(set, 2, HEADER_BYTES + set.size() * LIGHT_BYTES, "grown buffer");
+	check_buffer(set, handles, "buffer after growing");
+
+	check_throws([&]() { set.get(light_set::INVALID_HANDLE); }, "invalid handle");
+
+	set.clear();
+	check(set.size() == 0 && ! set.is_valid(handles[0]), "clear");
+	check_upload(set, 1, HEADER_BYTES, "clear sends the count");
+}
+
+int main(int argc, char** argv) {
+	glutInit(&argc, argv);
+	glutInitContextVersion(4, 3);
+	glutInitDisplayMode(GLUT_RGBA | GLUT_DEPTH);
+	glutCreateWindow("light_set");
+	glutHideWindow();
+	if(glewInit() != GLEW_OK) {
+		std::printf("GLEW could not be initialised\n");
+		return 1;
+	}
+	if(! light_set::is_supported()) {
+		std::printf("Shader storage buffers are not supported\n");
+		return 1;
+	}
+
+	{
+		context ctx;
+		check_ranges(ctx);
+	}
+
+	std::printf("%zu checks, %zu failures\n", gChecks, gFailures);
+	return gFailures == 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,248 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+// Checks the routines of maths.hpp against scalar loops, including the aliasing that their comments allow and
+// batches that do not fill the last group. Build it once for each SIMD path. No OpenGL context is needed :
+// g++ -std=c++14 -O2 -Iinclude tests/maths.cpp -o maths
+// g++ -std=c++14 -O2 -mavx2 -mfma -Iinclude tests/maths.cpp -o maths
+// g++ -std=c++14 -O2 -DASMITH_GL_NO_SIMD -Iinclude tests/maths.cpp -o maths
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "asmith/open_gl/maths.hpp"
+
+using namespace asmith::gl;
+
+static size_t gChecks = 0;
+static size_t gFailures = 0;
+static std::mt19937 gRng(1);
+
+static void check(bool aCondition, const char* aName, size_t aIndex = 0) {
+	++gChecks;
+	if(! aCondition && ++gFailures <= 20) std::printf("FAIL %s (at %zu)\n", aName, aIndex);
+}
+
+static bool near(GLfloat a, GLfloat b, GLfloat aTolerance = 1e-5f) {
+	return std::fabs(a - b) <= aTolerance * (1.f + std::fabs(b));
+}
+
+static bool near(const matrix4& a, const matrix4& b, GLfloat aTolerance = 1e-5f) {
+	for(int c = 0; c < 4; ++c) for(int r = 0; r < 4; ++r) if(! near(a.columns[c][r], b.columns[c][r], aTolerance)) return false;
+	return true;
+}
+
+static bool near(const vector3& a, const vector3& b, GLfloat aTolerance = 1e-5f) {
+	return near(a.x, b.x, aTolerance) && near(a.y, b.y, aTolerance) && near(a.z, b.z, aTolerance);
+}
+
+static bool near(const quaternion& a, const quaternion& b, GLfloat aTolerance = 1e-5f) {
+	return near(a.x, b.x, aTolerance) && near(a.y, b.y, aTolerance) && near(a.z, b.z, aTolerance) && near(a.w, b.w, aTolerance);
+}
+
+static GLfloat random_float() {
+	return std::uniform_real_distribution<GLfloat>(-1.f, 1.f)(gRng);
+}
+
+static matrix4 random_matrix() {
+	matrix4 m;
+	for(auto& c : m.columns) for(GLfloat& f : c) f = random_float();
+	return m;
+}
+
+static vector3 random_vector() {
+	return vector3{ random_float(), random_float(), random_float() };
+}
+
+static quaternion random_rotation() {
+	return quaternion::from_axis_angle(random_vector(), 3.f * random_float());
+}
+
+static matrix4 multiply_reference(const matrix4& a, const matrix4& b) {
+	matrix4 out;
+	for(int c = 0; c < 4; ++c) {
+		for(int r = 0; r < 4; ++r) {
+			GLfloat sum = 0.f;
+			for(int k = 0; k < 4; ++k) sum += a.columns[k][r] * b.columns[c][k];
+			out.columns[c][r] = sum;
+		}
+	}
+	return out;
+}
+
+static void check_multiply() {
+	for(size_t i = 0; i < 1000; ++i) {
+		const matrix4 a = random_matrix();
+		const matrix4 b = random_matrix();
+		const matrix4 expected = multiply_reference(a, b);
+		matrix4 out;
+		multiply(a, b, out);
+		check(near(out, expected), "multiply", i);
+		check(near(a * b, expected), "operator*", i);
+
+		// The output may be either input
+		matrix4 left = a;
+		multiply(left, b, left);
+		check(near(left, expected), "multiply into a", i);
+		matrix4 right = b;
+		multiply(a, right, right);
+		check(near(right, expected), "multiply into b", i);
+		matrix4 both = a;
+		multiply(both, both, both);
+		check(near(both, multiply_reference(a, a)), "multiply into a and b", i);
+	}
+
+	for(size_t count = 0; count < 10; ++count) {
+		std::vector<matrix4> a(count), b(count), out(count + 1);
+		for(size_t i = 0; i < count; ++i) {
+			a[i] = random_matrix();
+			b[i] = random_matrix();
+		}
+		const matrix4 guard = random_matrix();
+		out[count] = guard;
+		multiply(a.data(), b.data(), out.data(), count);
+		for(size_t i = 0; i < count; ++i) check(near(out[i], multiply_reference(a[i], b[i])), "batched multiply", count);
+		check(std::memcmp(&out[count], &guard, sizeof(matrix4)) == 0, "batched multiply stops at the count", count);
+		if(count == 0) continue;
+		multiply(a[0], b.data(), out.data(), count);
+		for(size_t i = 0; i < count; ++i) check(near(out[i], multiply_reference(a[0], b[i])), "batched multiply by one matrix", count);
+	}
+}
+
+static void check_transform_points() {
+	const matrix4 m = matrix4::transform(random_vector(), random_rotation(), vector3{ 1.5f, 0.5f, 2.f });
+	// Counts either side of the groups of four, the remainder goes through a different loop
+	for(size_t count = 0; count < 14; ++count) {
+		std::vector<vector3> in(count), out(count + 1);
+		for(vector3& p : in) p = random_vector();
+		const vector3 guard = random_vector();
+		out[count] = guard;
+
+		transform_points(m, in.data(), out.data(), count);
+		for(size_t i = 0; i < count; ++i) check(near(out[i], m.transform_point(in[i])), "transform_points", count);
+		check(std::memcmp(&out[count], &guard, sizeof(vector3)) == 0, "transform_points stops at the count", count);
+
+		std::vector<vector3> inPlace = in;
+		inPlace.push_back(guard);
+		transform_points(m, inPlace.data(), inPlace.data(), count);
+		for(size_t i = 0; i < count; ++i) check(near(inPlace[i], m.transform_point(in[i])), "transform_points in place", count);
+		check(std::memcmp(&inPlace[count], &guard, sizeof(vector3)) == 0, "transform_points in place stops at the count", count);
+	}
+
+	const vector3 p{ 1.f, 2.f, 3.f };
+	check(near(matrix4::translation(vector3{ 4.f, 5.f, 6.f }).transform_point(p), vector3{ 5.f, 7.f, 9.f }), "translation");
+	check(near(matrix4::scale(vector3{ 2.f, 3.f, 4.f }).transform_point(p), vector3{ 2.f, 6.f, 12.f }), "scale");
+	check(near(matrix4::translation(vector3{ 4.f, 5.f, 6.f }).transform_direction(p), p), "directions ignore translation");
+}
+
+static void check_transform_vectors() {
+	const matrix4 m = random_matrix();
+	for(size_t count = 0; count < 6; ++count) {
+		std::vector<vector4> in(count), out(count);
+		for(vector4& v : in) v = vector4{ random_float(), random_float(), random_float(), random_float() };
+		transform_vectors(m, in.data(), out.data(), count);
+		for(size_t i = 0; i < count; ++i) {
+			const vector4& v = in[i];
+			bool ok = true;
+			for(int r = 0; r < 4; ++r) {
+				const GLfloat expected = m.columns[0][r] * v.x + m.columns[1][r] * v.y + m.columns[2][r] * v.z + m.columns[3][r] * v.w;
+				ok = ok && near((&out[i].x)[r], expected);
+			}
+			check(ok, "transform_vectors", count);
+		}
+	}
+}
+
+static void check_invert() {
+	for(size_t i = 0; i < 1000; ++i) {
+		const matrix4 m = matrix4::transform(random_vector() * 10.f, random_rotation(), vector3{ 0.5f + std::fabs(random_float()), 0.5f + std::fabs(random_float()), 0.5f + std::fabs(random_float()) });
+		matrix4 inverse;
+		check(m.invert(inverse), "invert succeeds", i);
+		check(near(m * inverse, matrix4::identity(), 1e-4f) && near(inverse * m, matrix4::identity(), 1e-4f), "invert", i);
+
+		// invert reads the whole matrix before writing, so it may write over itself
+		matrix4 inPlace = m;
+		check(inPlace.invert(inPlace) && near(inPlace, inverse), "invert in place", i);
+	}
+
+	// Only an exact zero determinant is rejected. Every term of it has a factor from each column, so a column of
+	// zeros gives exactly zero whether or not the compiler contracts the products into FMAs
+	matrix4 singular = random_matrix();
+	for(int r = 0; r < 4; ++r) singular.columns[2][r] = 0.f;
+	const matrix4 before = random_matrix();
+	matrix4 out = before;
+	check(! singular.invert(out), "singular matrix");
+	check(std::memcmp(&out, &before, sizeof(matrix4)) == 0, "singular matrix leaves the output unchanged");
+}
+
+static void check_quaternions() {
+	const vector3 axis{ 0.f, 0.f, 1.f };
+	const quaternion a = quaternion::from_axis_angle(axis, 0.2f);
+	const quaternion b = quaternion::from_axis_angle(axis, 1.4f);
+	check(near(quaternion::slerp(a, b, 0.f), a), "slerp start");
+	check(near(quaternion::slerp(a, b, 1.f), b), "slerp end");
+	// Rotations about one axis interpolate the angle linearly
+	check(near(quaternion::slerp(a, b, 0.25f), quaternion::from_axis_angle(axis, 0.5f)), "slerp quarter");
+	check(near(quaternion::slerp(a, b, 0.5f), quaternion::from_axis_angle(axis, 0.8f)), "slerp half");
+	// -b is the same rotation, the path must not go the long way around
+	const quaternion negated{ -b.x, -b.y, -b.z, -b.w };
+	check(near(quaternion::slerp(a, negated, 0.5f), quaternion::from_axis_angle(axis, 0.8f)), "slerp shortest path");
+	// Nearly equal rotations are blended linearly, the result must still be a unit quaternion
+	const quaternion c = quaternion::from_axis_angle(axis, 0.2001f);
+	const quaternion close = quaternion::slerp(a, c, 0.5f);
+	check(near(close.dot(close), 1.f) && near(close, quaternion::from_axis_angle(axis, 0.20005f)), "slerp nearly equal");
+
+	for(size_t i = 0; i < 1000; ++i) {
+		const quaternion q = random_rotation();
+		const quaternion r = random_rotation();
+		const vector3 v = random_vector();
+		const quaternion s = quaternion::slerp(q, r, std::fabs(random_float()));
+		check(near(s.dot(s), 1.f), "slerp is unit length", i);
+		check(near(q.rotate(v), matrix4::rotation(q).transform_point(v)), "rotate matches the rotation matrix", i);
+		check(near((q * r).rotate(v), q.rotate(r.rotate(v))), "product applies the right rotation first", i);
+		check(near(q.conjugate().rotate(q.rotate(v)), v), "conjugate undoes the rotation", i);
+
+		const vector3 t = random_vector();
+		const vector3 scale{ 2.f, 3.f, 0.5f };
+		const matrix4 expected = multiply_reference(multiply_reference(matrix4::translation(t), matrix4::rotation(q)), matrix4::scale(scale));
+		check(near(matrix4::transform(t, q, scale), expected), "transform is translation * rotation * scale", i);
+	}
+}
+
+static void check_views() {
+	const matrix4 view = matrix4::look_at(vector3{ 0.f, 0.f, 5.f }, vector3{ 0.f, 0.f, 0.f }, vector3{ 0.f, 1.f, 0.f });
+	check(near(view, matrix4::translation(vector3{ 0.f, 0.f, -5.f })), "look_at");
+
+	// The near and far planes map to -1 and 1
+	const matrix4 projection = matrix4::perspective(1.f, 1.5f, 0.5f, 100.f);
+	const vector4 n = projection * vector4{ 0.f, 0.f, -0.5f, 1.f };
+	const vector4 f = projection * vector4{ 0.f, 0.f, -100.f, 1.f };
+	check(near(n.z / n.w, -1.f) && near(f.z / f.w, 1.f), "perspective depth");
+	const matrix4 ortho = matrix4::orthographic(-2.f, 6.f, -1.f, 3.f, 1.f, 9.f);
+	check(near(ortho.transform_point(vector3{ -2.f, -1.f, -1.f }), vector3{ -1.f, -1.f, -1.f }) && near(ortho.transform_point(vector3{ 6.f, 3.f, -9.f }), vector3{ 1.f, 1.f, 1.f }), "orthographic");
+}
+
+int main() {
+	check_multiply();
+	check_transform_points();
+	check_transform_vectors();
+	check_invert();
+	check_quaternions();
+	check_views();
+
+	std::printf("%zu checks, %zu failures\n", gChecks, gFailures);
+	return gFailures == 0 ? 0 : 1;
+}
\ No newline at end of file
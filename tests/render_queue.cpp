@@ -0,0 +1,267 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+// Checks the order that render_queue replays packets in. Each packet records its index from set_uniforms, the
+// order is then checked against the keys that submit returned : keys ascending, equal keys in submission order,
+// passes in order, opaque packets front to back and translucent packets back to front.
+// Replaying needs a context, which is created with a hidden GLUT window :
+// g++ -std=c++14 -O2 -Iinclude tests/render_queue.cpp <library sources> -lglut -lGLEW -lGL -o render_queue
+
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include <GL/glew.h>
+#include <GL/freeglut.h>
+#include "asmith/open_gl/render_queue.hpp"
+#include "asmith/open_gl/shader.hpp"
+#include "asmith/open_gl/texture_2d.hpp"
+
+using namespace asmith::gl;
+
+enum : size_t {
+	PACKETS = 10000,
+	PROGRAMS = 4,
+	TEXTURES = 8,
+	VAOS = 4,
+	PASSES = 3
+};
+
+static const char* const VERTEX_SOURCE =
+	"#version 130\n"
+	"void main() { gl_Position = vec4(0.0, 0.0, 0.0, 1.0); }\n";
+
+static const char* const FRAGMENT_SOURCE =
+	"#version 130\n"
+	"uniform sampler2D image;\n"
+	"out vec4 colour;\n"
+	"void main() { colour = texture(image, vec2(0.5)); }\n";
+
+static size_t gChecks = 0;
+static size_t gFailures = 0;
+static std::vector<size_t> gReplayed;
+
+static void check(bool aCondition, const char* aName, size_t aIndex = 0) {
+	++gChecks;
+	if(! aCondition && ++gFailures <= 20) std::printf("FAIL %s (at %zu)\n", aName, aIndex);
+}
+
+template<class F>
+static void check_throws(F aFunction, const char* aName) {
+	++gChecks;
+	try {
+		aFunction();
+	}catch(std::runtime_error&) {
+		return;
+	}
+	if(++gFailures <= 20) std::printf("FAIL %s : no exception\n", aName);
+}
+
+static void record(program&, const void* aData) {
+	gReplayed.push_back(*static_cast<const size_t*>(aData));
+}
+
+struct scene {
+	context ctx;
+	std::vector<std::shared_ptr<program>> programs;
+	std::vector<GLint> samplers;
+	std::vector<std::shared_ptr<texture_2d>> textures;
+	std::vector<std::shared_ptr<vertex_array>> vaos;
+
+	scene() {
+		for(size_t i = 0; i < PROGRAMS; ++i) {
+			programs.push_back(link_program({ compile_vertex_shader(ctx, VERTEX_SOURCE), compile_fragment_shader(ctx, FRAGMENT_SOURCE) }));
+			samplers.push_back(programs.back()->get_uniform_location("image"));
+		}
+		const colour_rgba_8u texel(255, 255, 255, 255);
+		for(size_t i = 0; i < TEXTURES; ++i) {
+			textures.emplace_back(new texture_2d(ctx));
+			textures.back()->bind();
+			textures.back()->load(&texel, 1, 1);
+			textures.back()->unbind();
+		}
+		for(size_t i = 0; i < VAOS; ++i) vaos.emplace_back(new vertex_array(ctx));
+	}
+
+	render_queue::packet make_packet(size_t aProgram, size_t aTexture, size_t aVao, const size_t* aIndex) const {
+		render_queue::packet p = render_queue::packet();
+		p.prog = programs[aProgram].get();
+		p.vao = vaos[aVao].get();
+		p.textures[0] = textures[aTexture].get();
+		p.sampler_locations[0] = samplers[aProgram];
+		p.texture_count = 1;
+		p.set_uniforms = record;
+		p.uniform_data = aIndex;
+		p.mode = GL_POINTS;
+		p.first = 0;
+		p.count = 1;
+		return p;
+	}
+};
+
+static void check_random_order(scene& aScene) {
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<GLfloat> depth(0.f, 1.f);
+	std::vector<size_t> indices(PACKETS);
+	std::vector<render_queue::packet> packets(PACKETS);
+	std::vector<render_queue::sort_key> keys(PACKETS);
+
+	render_queue queue(aScene.ctx);
+	for(size_t i = 0; i < PACKETS; ++i) {
+		indices[i] = i;
+		packets[i] = aScene.make_packet(rng() % PROGRAMS, rng() % TEXTURES, rng() % VAOS, &indices[i]);
+		// Repeated depths give equal keys, which must keep their submission order
+		packets[i].depth = rng() % 4 == 0 ? 0.5f : depth(rng);
+		packets[i].pass = static_cast<uint8_t>(rng() % PASSES);
+		packets[i].translucent = rng() % 4 == 0;
+		keys[i] = queue.submit(packets[i]);
+	}
+
+	const size_t generation = queue.get_generation();
+	gReplayed.clear();
+	queue.execute();
+	check(queue.size() == 0, "queue is empty after execute");
+	check(queue.get_generation() == generation + 1, "execute increases the generation");
+	check(gReplayed.size() == PACKETS, "every packet is drawn");
+	if(gReplayed.size() != PACKETS) return;
+
+	std::vector<bool> seen(PACKETS, false);
+	size_t programChanges = 1;
+	size_t textureChanges = 1;
+	size_t vaoChanges = 1;
+	for(size_t i = 0; i < PACKETS; ++i) {
+		const size_t b = gReplayed[i];
+		check(! seen[b], "each packet is drawn once", i);
+		seen[b] = true;
+		if(i == 0) continue;
+
+		const size_t a = gReplayed[i - 1];
+		const render_queue::packet& pa = packets[a];
+		const render_queue::packet& pb = packets[b];
+		if(pa.prog != pb.prog) ++programChanges;
+		if(pa.textures[0] != pb.textures[0]) ++textureChanges;
+		if(pa.vao != pb.vao) ++vaoChanges;
+
+		check(keys[a] < keys[b] || (keys[a] == keys[b] && a < b), "keys ascending and stable", i);
+		check(pa.pass <= pb.pass, "passes in order", i);
+		if(pa.pass != pb.pass) continue;
+		check(pa.translucent <= pb.translucent, "opaque before translucent", i);
+
+		if(pa.translucent && pb.translucent) {
+			// Quantised depths that are equal are ordered by state instead
+			check(pa.depth + 1.f / 131071.f >= pb.depth, "translucent back to front", i);
+		}else if(! pa.translucent && ! pb.translucent && pa.prog == pb.prog && pa.textures[0] == pb.textures[0] && pa.vao == pb.vao) {
+			check(pa.depth <= pb.depth + 1.f / 131071.f, "opaque front to back within a state group", i);
+		}
+	}
+
+	// Opaque packets of a pass are grouped by program, each program is bound at most once per pass
+	for(size_t i = 1; i < PACKETS; ++i) {
+		const render_queue::packet& pa = packets[gReplayed[i - 1]];
+		const render_queue::packet& pb = packets[gReplayed[i]];
+		if(pa.pass != pb.pass || pa.translucent || pb.translucent || pa.prog == pb.prog) continue;
+		for(size_t j = i + 1; j < PACKETS; ++j) {
+			const render_queue::packet& pc = packets[gReplayed[j]];
+			if(pc.pass != pa.pass || pc.translucent) break;
+			check(pc.prog != pa.prog, "opaque programs grouped", j);
+		}
+	}
+
+	const render_queue::statistics s = queue.get_frame_statistics();
+	check(s.packets == PACKETS, "packets counted");
+	check(s.program_changes == programChanges, "program changes counted");
+	check(s.texture_changes == textureChanges, "texture changes counted");
+	check(s.vao_changes == vaoChanges, "vertex array changes counted");
+	check(s.changes_avoided > 0, "sorting avoids changes");
+}
+
+static void check_small_queues(scene& aScene) {
+	render_queue queue(aScene.ctx);
+	std::vector<size_t> indices(64);
+	for(size_t i = 0; i < indices.size(); ++i) indices[i] = i;
+
+	gReplayed.clear();
+	queue.execute();
+	check(gReplayed.empty(), "empty queue");
+
+	render_queue::packet p = aScene.make_packet(0, 0, 0, &indices[0]);
+	queue.submit(p);
+	queue.execute();
+	check(gReplayed.size() == 1 && gReplayed[0] == 0, "single packet");
+
+	// Every digit of the keys is the same, which skips every pass of the sort
+	gReplayed.clear();
+	for(size_t i = 0; i < indices.size(); ++i) {
+		p.uniform_data = &indices[i];
+		queue.submit(p);
+	}
+	queue.execute();
+	bool inOrder = gReplayed.size() == indices.size();
+	for(size_t i = 0; inOrder && i < gReplayed.size(); ++i) inOrder = gReplayed[i] == i;
+	check(inOrder, "equal keys in submission order");
+
+	// Depth is the lowest field, so only the first pass of the sort has work to do
+	gReplayed.clear();
+	for(size_t i = 0; i < indices.size(); ++i) {
+		p.uniform_data = &indices[i];
+		p.depth = 1.f - static_cast<GLfloat>(i) / static_cast<GLfloat>(indices.size());
+		queue.submit(p);
+	}
+	queue.execute();
+	inOrder = gReplayed.size() == indices.size();
+	for(size_t i = 0; inOrder && i < gReplayed.size(); ++i) inOrder = gReplayed[i] == indices.size() - 1 - i;
+	check(inOrder, "opaque depths reversed");
+
+	queue.submit(p);
+	queue.clear();
+	gReplayed.clear();
+	queue.execute();
+	check(gReplayed.empty(), "clear drops packets");
+
+	p.depth = 0.f;
+	render_queue::packet bad = p;
+	bad.prog = nullptr;
+	check_throws([&]() { queue.submit(bad); }, "null program");
+	bad = p;
+	bad.vao = nullptr;
+	check_throws([&]() { queue.submit(bad); }, "null vertex array");
+	bad = p;
+	bad.pass = render_queue::MAX_PASSES;
+	check_throws([&]() { queue.submit(bad); }, "pass out of range");
+	bad = p;
+	bad.texture_count = render_queue::MAX_TEXTURES + 1;
+	check_throws([&]() { queue.submit(bad); }, "too many textures");
+	check_throws([&]() { queue.set_depth_range(1.f, 1.f); }, "empty depth range");
+	check(queue.size() == 0, "rejected packets are not queued");
+}
+
+int main(int argc, char** argv) {
+	glutInit(&argc, argv);
+	glutInitDisplayMode(GLUT_RGBA | GLUT_DEPTH);
+	glutCreateWindow("render_queue");
+	glutHideWindow();
+	if(glewInit() != GLEW_OK) {
+		std::printf("GLEW could not be initialised\n");
+		return 1;
+	}
+
+	{
+		scene s;
+		check_random_order(s);
+		check_small_queues(s);
+	}
+
+	std::printf("%zu checks, %zu failures\n", gChecks, gFailures);
+	return gFailures == 0 ? 0 : 1;
+}
\ No newline at end of file
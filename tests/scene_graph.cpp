@@ -0,0 +1,223 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+// Checks the world matrices and links of scene_graph after creating, re-parenting and destroying nodes, and that
+// only the changed nodes are updated. A large random forest checks the reorder and the parallel update against
+// a scalar multiply. No OpenGL context is needed :
+// g++ -std=c++14 -O2 -Iinclude tests/scene_graph.cpp src/asmith/open_gl/scene_graph.cpp src/asmith/open_gl/thread_pool.cpp -lpthread -o scene_graph
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "asmith/open_gl/scene_graph.hpp"
+
+using namespace asmith::gl;
+
+typedef scene_graph::node node;
+
+static size_t gChecks = 0;
+static size_t gFailures = 0;
+
+static void check(bool aCondition, const char* aName) {
+	++gChecks;
+	if(! aCondition && ++gFailures <= 20) std::printf("FAIL %s\n", aName);
+}
+
+template<class F>
+static void check_throws(F aFunction, const char* aName) {
+	++gChecks;
+	try {
+		aFunction();
+	}catch(std::runtime_error&) {
+		return;
+	}
+	if(++gFailures <= 20) std::printf("FAIL %s : no exception\n", aName);
+}
+
+static void translation(GLfloat x, GLfloat y, GLfloat z, mat4& aOut) {
+	for(int c = 0; c < 4; ++c) for(int r = 0; r < 4; ++r) aOut[c][r] = c == r ? 1.f : 0.f;
+	aOut[3][0] = x;
+	aOut[3][1] = y;
+	aOut[3][2] = z;
+}
+
+// Translations with small integer offsets multiply exactly, so the world position is compared exactly
+static bool is_at(const scene_graph& aGraph, node aNode, GLfloat x, GLfloat y, GLfloat z) {
+	const mat4& m = aGraph.get_world(aNode);
+	for(int c = 0; c < 3; ++c) for(int r = 0; r < 4; ++r) if(m[c][r] != (c == r ? 1.f : 0.f)) return false;
+	return m[3][0] == x && m[3][1] == y && m[3][2] == z && m[3][3] == 1.f;
+}
+
+static std::vector<node> get_children(const scene_graph& aGraph, node aNode) {
+	std::vector<node> children;
+	for(node c = aGraph.get_first_child(aNode); c != scene_graph::INVALID_NODE; c = aGraph.get_next_sibling(c)) children.push_back(c);
+	std::sort(children.begin(), children.end());
+	return children;
+}
+
+static void multiply_reference(const mat4& a, const mat4& b, mat4& aOut) {
+	for(int c = 0; c < 4; ++c) {
+		for(int r = 0; r < 4; ++r) {
+			GLfloat sum = 0.f;
+			for(int k = 0; k < 4; ++k) sum += a[k][r] * b[c][k];
+			aOut[c][r] = sum;
+		}
+	}
+}
+
+static void check_hierarchy() {
+	scene_graph graph;
+	mat4 m;
+	const node a = graph.create_node();
+	const node b = graph.create_node(a);
+	const node c = graph.create_node(b);
+	const node d = graph.create_node(a);
+	translation(1.f, 0.f, 0.f, m);
+	graph.set_local(a, m);
+	translation(0.f, 2.f, 0.f, m);
+	graph.set_local(b, m);
+	translation(0.f, 0.f, 3.f, m);
+	graph.set_local(c, m);
+	translation(0.f, 0.f, 4.f, m);
+	graph.set_local(d, m);
+
+	graph.update();
+	check(graph.size() == 4, "size");
+	check(is_at(graph, a, 1.f, 0.f, 0.f) && is_at(graph, b, 1.f, 2.f, 0.f) && is_at(graph, c, 1.f, 2.f, 3.f) && is_at(graph, d, 1.f, 0.f, 4.f), "world of a chain");
+	check(graph.get_parent(a) == scene_graph::INVALID_NODE && graph.get_parent(b) == a && graph.get_parent(c) == b, "parents");
+	check(get_children(graph, a) == std::vector<node>({ b, d }), "children");
+
+	// Only the changed node and its descendants are recomputed
+	graph.reset_statistics();
+	translation(5.f, 0.f, 0.f, m);
+	graph.set_local(a, m);
+	graph.update();
+	check(is_at(graph, c, 5.f, 2.f, 3.f) && is_at(graph, d, 5.f, 0.f, 4.f), "change reaches descendants");
+	check(graph.get_statistics().nodes_updated == 4, "whole subtree updated");
+	graph.reset_statistics();
+	translation(0.f, 0.f, 6.f, m);
+	graph.set_local(c, m);
+	graph.update();
+	check(is_at(graph, c, 5.f, 2.f, 6.f) && is_at(graph, b, 5.f, 2.f, 0.f), "leaf change");
+	check(graph.get_statistics().nodes_updated == 1, "only the leaf updated");
+	graph.update();
+	check(graph.get_statistics().nodes_updated == 1 && graph.get_statistics().reorders == 0, "nothing to update");
+
+	// Re-parenting keeps the local matrix, the world matrix follows the new parent
+	graph.set_parent(c, d);
+	graph.update();
+	check(is_at(graph, c, 5.f, 0.f, 10.f), "re-parented world");
+	check(graph.get_parent(c) == d && get_children(graph, d) == std::vector<node>({ c }) && get_children(graph, b).empty(), "re-parented links");
+	check(graph.get_statistics().reorders == 1, "re-parenting reorders");
+	graph.set_parent(c, scene_graph::INVALID_NODE);
+	graph.update();
+	check(is_at(graph, c, 0.f, 0.f, 6.f) && graph.get_parent(c) == scene_graph::INVALID_NODE, "made a root");
+	graph.set_parent(b, c);
+	graph.update();
+	check(is_at(graph, b, 0.f, 2.f, 6.f), "root moved under a later node");
+
+	check_throws([&]() { graph.set_parent(c, b); }, "parent is a descendant");
+	check_throws([&]() { graph.set_parent(c, c); }, "parent is itself");
+	check_throws([&]() { graph.create_node(100); }, "invalid parent");
+	check(graph.get_parent(c) == scene_graph::INVALID_NODE, "failed re-parent changes nothing");
+
+	// Destroying a node destroys its subtree, the handles are reused
+	graph.destroy_node(c);
+	check(! graph.is_valid(c) && ! graph.is_valid(b) && graph.is_valid(a) && graph.is_valid(d), "subtree destroyed");
+	check(graph.size() == 2, "size after destroy");
+	check_throws([&]() { graph.get_world(b); }, "destroyed node");
+	check_throws([&]() { graph.destroy_node(c); }, "destroyed twice");
+	const node e = graph.create_node(d);
+	check(e == b || e == c, "handle reused");
+	translation(0.f, 7.f, 0.f, m);
+	graph.set_local(e, m);
+	graph.update();
+	check(is_at(graph, e, 5.f, 7.f, 4.f) && is_at(graph, d, 5.f, 0.f, 4.f) && is_at(graph, a, 5.f, 0.f, 0.f), "world after destroy");
+	check(get_children(graph, d) == std::vector<node>({ e }), "links after destroy");
+}
+
+static void check_forest(thread_pool& aPool) {
+	// Enough nodes on one depth for the update to be split across the pool
+	const size_t count = 40000;
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<GLfloat> distribution(-1.f, 1.f);
+	scene_graph graph(aPool);
+	std::vector<node> nodes;
+	for(size_t i = 0; i < count; ++i) {
+		const node parent = i < 10000 || rng() % 4 == 0 ? static_cast<node>(scene_graph::INVALID_NODE) : nodes[rng() % nodes.size()];
+		nodes.push_back(graph.create_node(parent));
+		mat4 local;
+		for(int c = 0; c < 4; ++c) for(int r = 0; r < 4; ++r) local[c][r] = (c == r ? 1.f : 0.f) + 0.1f * distribution(rng);
+		graph.set_local(nodes.back(), local);
+	}
+	graph.update();
+
+	for(int round = 0; round < 3; ++round) {
+		for(size_t i = 0; i < count / 100; ++i) {
+			const node n = nodes[rng() % count];
+			const node p = nodes[rng() % count];
+			if(! graph.is_valid(n)) continue;
+			switch(rng() % 4) {
+			case 0:
+				if(graph.is_valid(p)) {
+					try {
+						graph.set_parent(n, p);
+					}catch(std::runtime_error&) {
+						// p is a descendant of n
+					}
+				}
+				break;
+			case 1:
+				graph.set_parent(n, scene_graph::INVALID_NODE);
+				break;
+			case 2:
+				graph.destroy_node(n);
+				break;
+			default:
+				graph.set_local(n, graph.get_local(n));
+				break;
+			}
+		}
+		graph.update();
+
+		double error = 0.0;
+		size_t valid = 0;
+		for(node n : nodes) {
+			if(! graph.is_valid(n)) continue;
+			++valid;
+			const node parent = graph.get_parent(n);
+			mat4 expected;
+			if(parent == scene_graph::INVALID_NODE) std::copy(&graph.get_local(n)[0][0], &graph.get_local(n)[0][0] + 16, &expected[0][0]);
+			else multiply_reference(graph.get_world(parent), graph.get_local(n), expected);
+			const mat4& world = graph.get_world(n);
+			for(int c = 0; c < 4; ++c) {
+				for(int r = 0; r < 4; ++r) error = std::max(error, static_cast<double>(std::fabs(world[c][r] - expected[c][r]) / (1.f + std::fabs(expected[c][r]))));
+			}
+		}
+		check(error < 1e-4, "forest world matrices");
+		check(valid == graph.size(), "forest size");
+	}
+}
+
+int main() {
+	check_hierarchy();
+	thread_pool pool(4);
+	check_forest(pool);
+	check_forest(thread_pool::get_default());
+
+	std::printf("%zu checks, %zu failures\n", gChecks, gFailures);
+	return gFailures == 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,194 @@
+//	Copyright 2017 Adam Smith
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+// 
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+
+// Checks the exact output of shader_preprocessor on virtual files : comment and whitespace removal, include
+// resolution, #pragma once, include cycles, #version hoisting, #line numbering and the stability of the hash.
+// No OpenGL context is needed :
+// g++ -std=c++14 -O2 -Iinclude tests/shader_preprocessor.cpp src/asmith/open_gl/shader_preprocessor.cpp -o shader_preprocessor
+
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include "asmith/open_gl/shader_preprocessor.hpp"
+
+using namespace asmith::gl;
+
+static size_t gChecks = 0;
+static size_t gFailures = 0;
+
+static void check(bool aCondition, const char* aName) {
+	++gChecks;
+	if(! aCondition && ++gFailures <= 20) std::printf("FAIL %s\n", aName);
+}
+
+static void check_text(const std::string& aActual, const std::string& aExpected, const char* aName) {
+	++gChecks;
+	if(aActual != aExpected && ++gFailures <= 20) std::printf("FAIL %s :\n--- expected ---\n%s\n--- actual ---\n%s\n", aName, aExpected.c_str(), aActual.c_str());
+}
+
+template<class F>
+static void check_throws(F aFunction, const char* aName) {
+	++gChecks;
+	try {
+		aFunction();
+	}catch(std::runtime_error&) {
+		return;
+	}
+	if(++gFailures <= 20) std::printf("FAIL %s : no exception\n", aName);
+}
+
+static void check_canonicalise() {
+	check_text(shader_preprocessor::canonicalise("  int   a ;\t// comment\n\tvoid  main() {}  \r\n"), "int a ;\nvoid main() {}\n", "whitespace and line comments");
+	// Line breaks inside a block comment are kept, so b is still on line 3
+	check_text(shader_preprocessor::canonicalise("a /* one\ntwo\nthree */ b\nc"), "a\n\nb\nc", "block comment spanning lines");
+	check_text(shader_preprocessor::canonicalise("x/**/y /* z */ w"), "x y w", "block comments between tokens");
+	check_text(shader_preprocessor::canonicalise("#  include   \"a  // b.glsl\"  // c"), "# include \"a  // b.glsl\"", "quoted text is kept");
+	check_text(shader_preprocessor::canonicalise(""), "", "empty source");
+}
+
+static void check_includes() {
+	shader_preprocessor p;
+	p.add_virtual_file("common.glsl", "#pragma once\n  float   common();  // declared once\n");
+	p.add_virtual_file("lib/quoted.glsl", "#include \"b.glsl\"\n");
+	p.add_virtual_file("lib/angled.glsl", "#include <b.glsl>\n");
+	p.add_virtual_file("lib/b.glsl", "float lib_b;");
+	p.add_virtual_file("b.glsl", "float root_b;");
+	p.add_include_directory("inc");
+	p.add_virtual_file("inc/c.glsl", "float inc_c;");
+
+	const auto once = p.preprocess("#include \"common.glsl\"\n#include <common.glsl>\nvoid main() {}\n", shader_preprocessor::define_set(), "main.glsl");
+	check_text(once->source,
+		"#line 1 0\n"
+		"#line 1 1\n"
+		"\n"
+		"float common();\n"
+		"#line 2 0\n"
+		"\n"
+		"void main() {}\n",
+		"#pragma once");
+	check(once->files.size() == 2 && once->files[0] == "main.glsl" && once->files[1] == "common.glsl", "#pragma once files");
+
+	// Quoted includes look next to the including file first, angled includes only in the include directories
+	const auto resolved = p.preprocess("#include \"lib/quoted.glsl\"\n#include \"lib/angled.glsl\"\n#include <c.glsl>\n");
+	check_text(resolved->source,
+		"#line 1 0\n"
+		"#line 1 1\n"
+		"#line 1 2\n"
+		"float lib_b;\n"
+		"#line 2 1\n"
+		"#line 2 0\n"
+		"#line 1 3\n"
+		"#line 1 4\n"
+		"float root_b;\n"
+		"#line 2 3\n"
+		"#line 3 0\n"
+		"#line 1 5\n"
+		"float inc_c;\n"
+		"#line 4 0\n",
+		"quoted and angled includes");
+	check(resolved->files.size() == 6 && resolved->files[2] == "lib/b.glsl" && resolved->files[4] == "b.glsl" && resolved->files[5] == "inc/c.glsl", "include paths");
+
+	check_throws([&]() { p.preprocess("#include \"missing.glsl\"\n"); }, "missing include");
+	check_throws([&]() { p.preprocess("#include common.glsl\n"); }, "malformed include");
+
+	// A cycle is an error unless #pragma once stops it
+	p.add_virtual_file("x.glsl", "#include \"y.glsl\"\nfloat x;\n");
+	p.add_virtual_file("y.glsl", "#include \"x.glsl\"\nfloat y;\n");
+	check_throws([&]() { p.preprocess("#include \"x.glsl\"\n"); }, "include cycle");
+	check_throws([&]() { p.preprocess_file("x.glsl"); }, "file including itself");
+	p.add_virtual_file("x.glsl", "#pragma once\n#include \"y.glsl\"\nfloat x;\n");
+	p.add_virtual_file("y.glsl", "#pragma once\n#include \"x.glsl\"\nfloat y;\n");
+	check_text(p.preprocess_file("x.glsl")->source,
+		"#line 1 0\n"
+		"\n"
+		"#line 1 1\n"
+		"\n"
+		"\n"
+		"float y;\n"
+		"#line 3 0\n"
+		"float x;\n",
+		"include cycle with #pragma once");
+}
+
+static void check_version_and_defines() {
+	shader_preprocessor p;
+	p.add_virtual_file("lib.glsl", "#version 330\nfloat lib;\n");
+	shader_preprocessor::define_set defines;
+	defines["B"] = "";
+	defines["A"] = "1";
+
+	// #version is moved in front of the defines, the #version of an included file is dropped
+	const auto s = p.preprocess("// header\n#version 450 core\n#include \"lib.glsl\"\nint x;", defines);
+	check_text(s->source,
+		"#version 450 core\n"
+		"#define A 1\n"
+		"#define B\n"
+		"#line 1 0\n"
+		"\n"
+		"\n"
+		"#line 1 1\n"
+		"\n"
+		"float lib;\n"
+		"#line 4 0\n"
+		"int x;\n",
+		"#version hoisting");
+	check_text(s->defines, "#define A 1\n#define B\n", "define string");
+
+	defines.clear();
+	defines["1A"] = "";
+	check_throws([&]() { p.preprocess("int x;", defines); }, "invalid macro name");
+	defines.clear();
+	defines["A"] = "1\n2";
+	check_throws([&]() { p.preprocess("int x;", defines); }, "line break in a define");
+}
+
+static void check_hash() {
+	shader_preprocessor p;
+	p.add_virtual_file("common.glsl", "float common();\n");
+	const char* const source = "#version 330\n#include \"common.glsl\"\nvoid main() {\n\tgl_Position = vec4(0.0);\n}\n";
+	const char* const edited = "#version   330  // edited\n#include \"common.glsl\"   /* a comment */\nvoid main()   {\n    gl_Position  =  vec4(0.0);   // and another\n}\n";
+	const char* const moved = "#version 330\n\n#include \"common.glsl\"\nvoid main() {\n\tgl_Position = vec4(0.0);\n}\n";
+
+	const auto a = p.preprocess(source);
+	const auto b = p.preprocess(edited);
+	const auto c = p.preprocess(moved);
+	check(a->hash == implementation::hash_fnv1a(a->source.c_str(), a->source.size()), "hash of the source");
+	check_text(b->source, a->source, "whitespace and comment edits");
+	check(a->hash == b->hash, "hash unchanged by whitespace and comment edits");
+	// Spaces are collapsed but not removed, and an extra line moves every #line after it
+	check(a->hash != p.preprocess("#version 330\n#include \"common.glsl\"\nvoid main() {\n\tgl_Position = vec4( 0.0);\n}\n")->hash, "hash changed by a new space");
+	check(a->hash != c->hash, "hash changed by a new line");
+
+	shader_preprocessor::define_set defines;
+	defines["A"] = "1";
+	const auto d = p.preprocess(source, defines);
+	check(a->hash != d->hash, "hash changed by a define");
+
+	const shader_preprocessor::statistics before = p.get_statistics();
+	check(p.preprocess(source, defines) == d, "permutation is cached");
+	check(p.get_statistics().cache_hits == before.cache_hits + 1, "cache hit counted");
+
+	// Replacing a file discards the expansions that used it
+	p.add_virtual_file("common.glsl", "float common(float);\n");
+	check(p.preprocess(source)->hash != a->hash, "hash changed by an included file");
+}
+
+int main() {
+	check_canonicalise();
+	check_includes();
+	check_version_and_defines();
+	check_hash();
+
+	std::printf("%zu checks, %zu failures\n", gChecks, gFailures);
+	return gFailures == 0 ? 0 : 1;
+}
\ No newline at end of file